@@ -0,0 +1,36 @@
+#ifndef FAST_GPIO_H
+#define FAST_GPIO_H
+
+#include <Arduino.h>
+#include "soc/gpio_reg.h"
+
+//* ************************************************************************
+//* ***************************** FAST GPIO ********************************
+//* ************************************************************************
+// Direct register access for use inside interrupt handlers.
+// digitalWrite()/digitalRead() are not guaranteed to be in IRAM.
+
+static inline void IRAM_ATTR fastOutputLow(uint8_t pin) {
+    if (pin < 32) {
+        REG_WRITE(GPIO_OUT_W1TC_REG, 1UL << pin);
+    } else {
+        REG_WRITE(GPIO_OUT1_W1TC_REG, 1UL << (pin - 32));
+    }
+}
+
+static inline void IRAM_ATTR fastOutputHigh(uint8_t pin) {
+    if (pin < 32) {
+        REG_WRITE(GPIO_OUT_W1TS_REG, 1UL << pin);
+    } else {
+        REG_WRITE(GPIO_OUT1_W1TS_REG, 1UL << (pin - 32));
+    }
+}
+
+static inline int IRAM_ATTR fastInputRead(uint8_t pin) {
+    if (pin < 32) {
+        return (REG_READ(GPIO_IN_REG) >> pin) & 0x1;
+    }
+    return (REG_READ(GPIO_IN1_REG) >> (pin - 32)) & 0x1;
+}
+
+#endif // FAST_GPIO_H
@@ -0,0 +1,74 @@
+#ifndef GUN_LATENCY_H
+#define GUN_LATENCY_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ PAINT GUN LATENCY *****************************
+//* ************************************************************************
+// The solenoid and the air line take tens of milliseconds between the pin
+// changing and paint actually starting or stopping. At sweep speed that is
+// a fraction of an inch, so runPaintSweep() fires each gun edge early by
+// the distance the axis covers in that time (speed x latency).
+//
+// Calibration paints two stripes at different speeds with compensation off.
+// Each stripe edge lands at (commanded edge + fixed spray offset + speed x
+// latency), so the fixed offset cancels between the two stripes and the
+// latency is the edge shift divided by the speed difference.
+
+struct GunLatency {
+    float openMs;   // Command to paint leaving the nozzle
+    float closeMs;  // Command to paint stopping
+};
+
+/**
+ * @brief Latency of a gun (0..PAINT_GUN_COUNT-1).
+ */
+const GunLatency& getGunLatency(int gun = 0);
+
+/**
+ * @brief Sets and persists a gun's latencies, clamped to 0..GUN_LATENCY_MAX_MS.
+ */
+void setGunLatency(int gun, float openMs, float closeMs);
+void loadGunLatencyFromNVS();
+
+/**
+ * @brief Distance (steps) an axis moving at speedHz covers in latencyMs.
+ * Zero while compensation is disabled.
+ */
+long gunLeadSteps(float latencyMs, long speedHz);
+
+/**
+ * @brief Turns edge compensation on or off (off while painting calibration stripes). Not persisted.
+ */
+void setGunLatencyCompensation(bool enabled);
+bool isGunLatencyCompensationEnabled();
+
+/**
+ * @brief Estimates latencies from two stripes painted at slowSpeedHz and
+ * fastSpeedHz. Edge positions are in inches along +X from any datum
+ * shared by both stripes.
+ * @return false if the result is negative or above GUN_LATENCY_MAX_MS.
+ */
+bool estimateGunLatency(long slowSpeedHz, float slowStartInch, float slowEndInch,
+                        long fastSpeedHz, float fastStartInch, float fastEndInch, GunLatency& result);
+
+/**
+ * @brief estimateGunLatency() using the speeds of the last calibration run
+ * (the configured calibration speeds if none has run since boot).
+ */
+bool estimateGunLatencyFromStripes(float slowStartInch, float slowEndInch,
+                                   float fastStartInch, float fastEndInch, GunLatency& result);
+
+/**
+ * @brief Paints the two calibration stripes along +X from the current
+ * position (slow stripe first, fast stripe GUN_CALIBRATION_STRIPE_SPACING_INCH
+ * further +Y), then returns to the start. Blocks until done. Broadcasts
+ * GUN_CALIBRATION:<slow Hz>,<fast Hz>,<commanded start X>,<commanded end X>
+ * (inches) so the stripes can be measured and sent back with
+ * GUN_LATENCY_FROM_STRIPES.
+ * @return false if the stripes would leave the travel limits.
+ */
+bool paintGunCalibrationStripes();
+
+#endif // GUN_LATENCY_H
@@ -0,0 +1,59 @@
+#ifndef PNEUMATICS_H
+#define PNEUMATICS_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* *************************** PNEUMATICS *********************************
+//* ************************************************************************
+// Timed PnP actuation steps that can be polled instead of delay()ed. The PnP
+// cycle drives them from the same loop that services its moves.
+//
+// Each step drives its output, then finishes on the first of:
+//  - its feedback switch confirming (reed switch / vacuum switch), when fitted
+//  - its configured worst-case delay (the PNP_*_DELAY_* settings)
+// A fitted switch that never confirms fails the step, e.g. no part on the cup.
+// Only switch feedback shortens a step: without a switch nothing tells a
+// shorter delay from one that is too short, so nothing is learned.
+//
+// Retracts are always timed: no switch can tell when the cup is clear of
+// the parts, only when the cylinder is fully up, which is later.
+
+enum PneumaticStep {
+    PNEUMATIC_PICK_EXTEND,    // cylinderDown at the pick location
+    PNEUMATIC_PICK_GRIP,      // vacuumOn until the part is held
+    PNEUMATIC_PICK_RETRACT,   // cylinderUp until clear (PNP_CYLINDER_CLEAR_MS)
+    PNEUMATIC_PLACE_EXTEND,   // cylinderDown at the place location
+    PNEUMATIC_PLACE_RELEASE,  // vacuumOff until the part is let go
+    PNEUMATIC_PLACE_RETRACT,  // cylinderUp until clear
+    PNEUMATIC_STEP_COUNT
+};
+
+enum PneumaticStepStatus {
+    PNEUMATIC_BUSY,
+    PNEUMATIC_DONE,
+    PNEUMATIC_FAILED          // Feedback switch did not confirm in time
+};
+
+/**
+ * @brief Drives the step's output and starts timing it. One step at a time.
+ */
+void startPneumaticStep(PneumaticStep step);
+
+/**
+ * @brief Polls the step started last. Cheap; call from any wait loop.
+ */
+PneumaticStepStatus updatePneumaticStep();
+
+/**
+ * @brief The configured delay the step uses when no switch ends it (ms).
+ */
+unsigned long getPneumaticStepDelayMs(PneumaticStep step);
+
+/**
+ * @brief One entry per step: name, configured delay, source (switch or
+ * configured), last switch confirmation time (ms, 0 = none).
+ */
+String describePneumaticTiming();
+
+#endif // PNEUMATICS_H
@@ -62,5 +62,6 @@ void moveToTipInspectionPosition();
 void returnMachineHome();
 void startCleaningCycle();
 void paintAllSidesTwice();
+void paintAllSidesCoats(int coats);
 
 #endif // CONTROL_PANEL_FUNCTIONS_H 
\ No newline at end of file
@@ -3,13 +3,65 @@
 
 #include <Arduino.h>
 #include <WebSocketsServer.h>
+#include "utils/settings.h"
+#include "hardware/FastGPIO.h"
+
+//* ************************************************************************
+//* **************************** PAINT GUN *********************************
+//* ************************************************************************
+// paintGun_ON()/paintGun_OFF() are on the sweep hot path: a register write
+// and a queued telemetry event, nothing else. Serial logging and the
+// PAINT_GUN_STATUS broadcast happen later in flushPaintGunTelemetry().
+//
+// Closing is never delayed. The only timing rule is the solenoid's minimum
+// closed time: a reopen that arrives sooner is held (not dropped) and fired
+// by servicePaintGun() once the valve has had time to seat.
+
+extern volatile bool isPaintGun_ON;
+extern volatile bool g_paintGunOpenPending;
+extern volatile unsigned long g_lastGunCloseUs;  // Start of the minimum closed time
+extern volatile bool g_gunStatusDirty;           // PAINT_GUN_STATUS due at the next flush
 
 // Function declarations for paint gun control
 void setupPaintGun();
 void paintGun_ON();
 void paintGun_OFF();
 
+/**
+ * @brief Fires a held reopen once the minimum closed time has passed. Cheap;
+ * call from any loop that waits on a sweep.
+ */
+void servicePaintGun();
+
+/**
+ * @brief Logs queued gun events and broadcasts the current PAINT_GUN_STATUS.
+ * Call from the main loop / WebSocket pump, never between gun edges.
+ */
+void flushPaintGunTelemetry();
+
+/**
+ * @brief Minimum closed time before the gun may reopen (microseconds). Persisted.
+ */
+void setPaintGunMinPulseUs(unsigned long pulseUs);
+unsigned long getPaintGunMinPulseUs();
+void loadPaintGunSettingsFromNVS();
+
+/**
+ * @brief Interrupt-safe gun off for the stop and limit ISRs; also cancels a held reopen.
+ * Starts the minimum closed time and flags the status for the next flush, but
+ * queues no telemetry event (the queue is loop-task only).
+ */
+static inline void IRAM_ATTR paintGun_ForceOffFromISR() {
+    fastOutputLow(PAINT_GUN_PIN);
+    if (isPaintGun_ON) {
+        g_lastGunCloseUs = micros();
+        g_gunStatusDirty = true;
+    }
+    isPaintGun_ON = false;
+    g_paintGunOpenPending = false;
+}
+
 // Web status function (moved from web_command_adapter.h)
 void sendWebStatus(WebSocketsServer* webSocket, const char* message);
 
-#endif // PAINTGUN_FUNCTIONS_H 
\ No newline at end of file
+#endif // PAINTGUN_FUNCTIONS_H
@@ -0,0 +1,57 @@
+#ifndef GANTRY_SYNC_H
+#define GANTRY_SYNC_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ***************************** GANTRY SYNC ******************************
+//* ************************************************************************
+// Cross-checks the two Y gantry motors. They are open-loop steppers, so the
+// running check compares the step counts the two drivers have actually been
+// given (catches one side being stopped, zeroed or moved on its own). The
+// physical check happens at homing, where the travel each side needed to
+// reach its switch gives the real skew, and a squaring offset corrects for
+// switches that are not mounted exactly square.
+//
+// The squaring offset is the measured skew of a square gantry, negated. It
+// is only ever set by the operator (CAPTURE_GANTRY_SQUARING after a homing
+// with the gantry known square, or SET_GANTRY_SQUARING); until then the
+// skew is just reported. After that, any other skew means the gantry was
+// racked before homing, and past GANTRY_HOMING_SKEW_FAULT_STEPS that is a
+// LIMIT_FAULT_Y_RACKED fault.
+
+/**
+ * @brief Compares Y_Left and Y_Right positions and latches a
+ * LIMIT_FAULT_Y_RACKED fault past GANTRY_SYNC_FAULT_STEPS. Skipped while
+ * limit monitoring is disarmed (homing moves the sides independently).
+ * @return true if the gantry is out of sync.
+ */
+bool checkGantrySync();
+
+/**
+ * @brief Records the skew measured by homing: the difference in travel
+ * (steps) each Y motor needed to reach its switch. Positive = left side
+ * travelled further. Persisted; only reported while no squaring offset has
+ * been captured.
+ * @return false, with LIMIT_FAULT_Y_RACKED latched, if the gantry was racked
+ * past GANTRY_HOMING_SKEW_FAULT_STEPS.
+ */
+bool recordGantryHomingSkew(long skewSteps);
+long getLastGantryHomingSkew();
+
+/**
+ * @brief Takes the gantry as square at the last homing and sets the
+ * squaring offset from its measured skew.
+ * @return false if that skew is beyond GANTRY_SQUARING_MAX_OFFSET_STEPS.
+ */
+bool captureGantrySquaringFromSkew();
+
+/**
+ * @brief Squaring offset (steps) applied to Y_Right after homing so the
+ * gantry is square rather than just sitting on both switches. Persisted.
+ */
+void setGantrySquaringOffset(long offsetSteps);
+long getGantrySquaringOffset();
+void loadGantrySettingsFromNVS();
+
+#endif // GANTRY_SYNC_H
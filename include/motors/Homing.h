@@ -9,6 +9,66 @@
 #include "motors/Rotation_Motor.h" // Include Rotation_Motor for rotationStepper access
 #include "settings/debounce_settings.h" // Added for centralized debounce intervals
 
+// Per-axis homing stages (two-stage homing)
+enum HomingAxisPhase {
+    AXIS_HOMING_RAPID,      // Known position: travel-speed move to just short of the switch
+    AXIS_HOMING_FAST_SEEK,  // Run toward the switch at HOMING_FAST_SPEED
+    AXIS_HOMING_BACK_OFF,   // Back off HOMING_MOVE_AWAY_INCHES from the fast trigger point
+    AXIS_HOMING_SLOW_SEEK,  // Re-approach at HOMING_SPEED for the precise trigger point
+    AXIS_HOMING_DONE
+};
+
+enum HomingAxisIndex {
+    HOMING_AXIS_X,
+    HOMING_AXIS_Y_LEFT,
+    HOMING_AXIS_Y_RIGHT,
+    HOMING_AXIS_Z,
+    HOMING_AXIS_COUNT
+};
+
+struct HomingAxis {
+    const char* name;
+    FastAccelStepper* stepper;
+    Bounce* homeSwitch;
+    int towardSwitch;       // -1 = switch is in the negative direction, +1 = positive (Z)
+    uint32_t rapidSpeed;
+    uint32_t rapidAccel;
+    uint32_t fastSpeed;
+    uint32_t slowSpeed;
+    uint32_t seekAccel;
+    HomingAxisPhase phase;
+    long startPos;          // Position when homing started (old frame)
+    long fastTripPos;       // Position at the fast-seek trigger (old frame)
+    long slowTripPos;       // Position at the slow-seek trigger (old frame)
+    long expectedSwitchPos; // Where the last homing left the switch (current frame)
+    unsigned long startMs;  // When this axis started homing
+    unsigned long doneMs;   // When the slow-seek trigger was reached
+};
+
+// Turntable progress while it homes alongside the linear axes
+struct RotationHoming {
+    bool started;
+    bool homed;
+    unsigned long startMs;
+    unsigned long doneMs;
+};
+
+/**
+ * @brief True once a homing cycle has completed and nothing since (limit or
+ * gantry fault, failed homing) has made the positions untrustworthy. Lets
+ * homing rapid to just short of each switch instead of seeking the whole way.
+ */
+bool isHomingReferenceValid();
+void invalidateHomingReference();
+
+/**
+ * @brief When enabled, homing requested at the end of a job runs
+ * Homing::verifyHome() instead of a full homing cycle. Persisted.
+ */
+void setVerifyHomeAfterJobs(bool enabled);
+bool isVerifyHomeAfterJobsEnabled();
+void loadHomingSettingsFromNVS();
+
 class Homing {
 public:
     Homing(FastAccelStepperEngine& engine,
@@ -19,6 +79,14 @@ public:
     
     bool homeAllAxes();
 
+    /**
+     * @brief Rapid to just short of each switch, creep onto it and compare the
+     * trigger with the last homing. Re-zeroes if every axis is within
+     * VERIFY_HOME_TOLERANCE_STEPS, otherwise logs the drift and runs homeAllAxes().
+     * Falls back to homeAllAxes() directly if there is no valid reference.
+     */
+    bool verifyHome();
+
 private:
     FastAccelStepperEngine& _engine; // Reference to the engine
     FastAccelStepper* _stepperX;
@@ -33,8 +101,23 @@ private:
     Bounce _zHomeSwitch;
 
     bool _isHoming = false; // Internal homing state flag
+    bool _verifyMode = false; // Stage machine runs verify-home stages (no fast seek / back-off)
+    bool _stopped = false; // The stop input abandoned this homing
+
+    bool stopInputReceived(); // Polls serviceStopAll(); true once homing must be abandoned
 
     long inchesToStepsXYZ(float inches); // Keep utility function private or move elsewhere if shared
+
+    // Two-stage homing helpers
+    void startAllAxesHoming(HomingAxis* axes);
+    bool runAxesToSwitches(HomingAxis* axes, RotationHoming& rotation);
+    void startAxisHoming(HomingAxis& axis, int index);
+    bool updateAxisHoming(HomingAxis& axis); // Returns true once the axis is done
+    void beginFastSeek(HomingAxis& axis);
+    void beginBackOff(HomingAxis& axis);
+    void beginSlowSeek(HomingAxis& axis);
+    void recordTriggerRepeatability(int index, const HomingAxis& axis);
+    void reportHomingDurations(const HomingAxis* axes, unsigned long rotationMs, unsigned long totalMs);
 };
 
 #endif // HOMING_H 
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef LIMIT_LATCH_H
+#define LIMIT_LATCH_H
+
+#include <stdint.h>
+
+//* ************************************************************************
+//* *************************** LIMIT FAULT LATCH **************************
+//* ************************************************************************
+// The part of the limit switch monitor shared by the GPIO interrupts and the
+// task-level service (LimitSwitches.cpp). An edge only sets a bit; the axes
+// are stopped by whoever takes the new bits at task level, because the
+// stepper driver calls are not ISR-safe.
+//
+// No Arduino dependencies: the same code builds into the host latch test
+// (tools/limit_latch_test). Everything is forced inline so the interrupt
+// handlers never call out of IRAM.
+
+#define LIMIT_LATCH_INLINE inline __attribute__((always_inline))
+
+// Bits in the latched fault mask
+#define LIMIT_FAULT_X       0x01
+#define LIMIT_FAULT_Y_LEFT  0x02
+#define LIMIT_FAULT_Y_RIGHT 0x04
+#define LIMIT_FAULT_Z       0x08
+#define LIMIT_FAULT_Y_RACKED 0x10 // Gantry sync fault (see GantrySync.h)
+
+struct LimitLatch {
+    volatile bool armed;          // Disarmed while homing drives onto the switches
+    volatile uint8_t faultMask;   // Set by edges and latchLimitFault(), cleared only by clearLimitFault()
+    uint8_t handledMask;          // Bits the task-level service has already acted on
+};
+
+/**
+ * @brief Interrupt half: latches faultBit if monitoring is armed and the
+ * switch still reads triggered (a release bounce does not).
+ * @return true if the bit was latched.
+ */
+LIMIT_LATCH_INLINE bool limitLatchEdge(LimitLatch& latch, uint8_t faultBit, bool switchTriggered) {
+    if (!latch.armed || !switchTriggered) {
+        return false;
+    }
+    latch.faultMask |= faultBit;
+    return true;
+}
+
+/**
+ * @brief Task-level half: returns the bits latched since the previous call
+ * and marks them handled. Call with interrupts enabled; a bit set between
+ * the read and the store is picked up next call.
+ */
+LIMIT_LATCH_INLINE uint8_t limitLatchTakeNew(LimitLatch& latch) {
+    uint8_t latched = latch.faultMask;
+    uint8_t fresh = latched & (uint8_t)~latch.handledMask;
+    latch.handledMask = latched;
+    return fresh;
+}
+
+LIMIT_LATCH_INLINE void limitLatchClear(LimitLatch& latch) {
+    latch.faultMask = 0;
+    latch.handledMask = 0;
+}
+
+#endif // LIMIT_LATCH_H
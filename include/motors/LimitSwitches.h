@@ -0,0 +1,55 @@
+#ifndef LIMIT_SWITCHES_H
+#define LIMIT_SWITCHES_H
+
+#include <Arduino.h>
+#include "motors/LimitLatch.h" // LIMIT_FAULT_* bits
+
+//* ************************************************************************
+//* ************************* LIMIT SWITCH MONITOR *************************
+//* ************************************************************************
+// The home switches double as travel limits outside of homing. Each switch
+// has a GPIO interrupt that closes the gun and latches a fault (LimitLatch.h).
+// The fault is handled at task level: all axes are stopped and the machine
+// moves to ErrorState until the fault is cleared. Monitoring is disarmed
+// while homing drives onto the switches on purpose.
+
+/**
+ * @brief Attaches the limit switch interrupts and arms monitoring. Call after
+ * the switch pins have been configured.
+ */
+void initializeLimitSwitchMonitor();
+
+/**
+ * @brief Arms or disarms limit monitoring (disarmed during homing).
+ */
+void setLimitMonitoringEnabled(bool enabled);
+bool isLimitMonitoringEnabled();
+
+/**
+ * @brief Latches a fault from task level (polling fallback for a missed edge).
+ */
+void latchLimitFault(uint8_t faultMask);
+
+bool isLimitFaultLatched();
+uint8_t getLimitFaultMask();
+
+/**
+ * @brief Handles newly latched faults: stops every axis, closes the gun,
+ * broadcasts LIMIT_FAULT:<axes> and changes to ErrorState. Called from loop()
+ * and from the home/pause checks inside motion loops.
+ * @return true while a fault is latched (callers abort what they are doing).
+ */
+bool serviceLimitSwitches();
+
+/**
+ * @brief Clears the latched fault. Positions are not trusted afterwards;
+ * ErrorState follows this with a homing cycle.
+ */
+void clearLimitFault();
+
+/**
+ * @brief Formats a fault mask as e.g. "X,Y_LEFT" for logs and broadcasts.
+ */
+String limitFaultMaskToString(uint8_t faultMask);
+
+#endif // LIMIT_SWITCHES_H
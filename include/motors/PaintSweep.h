@@ -0,0 +1,122 @@
+#ifndef PAINT_SWEEP_H
+#define PAINT_SWEEP_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* **************************** PAINT SWEEP *******************************
+//* ************************************************************************
+// Shared executor for a single painted sweep along X (Side 1/3, final X
+// sweeps of Side 2/4) or Y (Side 2/4 sweeps, both Y motors in lockstep).
+// The gun window is tracked by axis position, not elapsed time, so it stays
+// correct through pauses and acceleration ramps. Each edge is fired early by
+// the gun's latency at the current axis speed (hardware/GunLatency.h).
+//
+// A sweep may open the gun several times: over a tray of parts the windows
+// cover the parts and skip the gaps (motors/TrayLayout.h). The axis itself
+// moves exactly as for a single window.
+
+#define PAINT_SWEEP_MAX_WINDOWS 10          // One per PnP grid position
+
+enum PaintSweepAxis {
+    SWEEP_AXIS_X,
+    SWEEP_AXIS_Y
+};
+
+// Gun-on interval, as distance travelled from the sweep's startPos (steps)
+struct PaintGunWindow {
+    long onOffset;
+    long offOffset;
+};
+
+struct PaintSweep {
+    PaintSweepAxis axis;
+    long startPos;      // Absolute start position (steps)
+    long targetPos;     // Absolute end position (steps)
+    long speedHz;       // Painting speed (steps/sec)
+    long gunOnOffset;   // Distance travelled from startPos when the gun opens (steps)
+    long gunOffOffset;  // Distance travelled from startPos when the gun closes (steps)
+    int windowCount;    // Gun-on intervals inside gunOnOffset..gunOffOffset, ascending; may be 0
+    PaintGunWindow windows[PAINT_SWEEP_MAX_WINDOWS];
+    const char* tag;    // Log prefix, e.g. "Side2State"
+};
+
+// Snapshot taken when a sweep is paused
+struct PaintSweepPauseRecord {
+    long pausePos;      // Position at which the pause was requested and the gun closed (steps)
+    long stopPos;       // Position at which the axis came to rest after decelerating (steps)
+    bool gunWasOn;      // Gun state when the pause was requested
+    bool inGunWindow;   // True if pausePos lies inside one of the sweep's gun windows
+};
+
+/**
+ * @brief Builds a single-window sweep from its start/end and the gun margins in inches.
+ * @param gunStartMarginInches Distance after startPos before the gun opens.
+ * @param gunStopMarginInches Distance before targetPos at which the gun closes.
+ */
+PaintSweep makePaintSweep(PaintSweepAxis axis, long startPos, long targetPos, long speedHz,
+                          float gunStartMarginInches, float gunStopMarginInches, const char* tag);
+
+/**
+ * @brief Shortens a sweep to its gun windows: starts late enough and ends
+ * early enough that the axis is still at full speed (at the maximum feed
+ * override) across every window. Never lengthens the sweep.
+ */
+PaintSweep trimPaintSweepToWindows(const PaintSweep& sweep);
+
+/**
+ * @brief Runs a painted sweep and blocks until the axis reaches targetPos.
+ * If the axis is not at startPos (a trimmed sweep) it first travels there
+ * with the gun closed. A sweep with no gun windows is skipped without moving.
+ *
+ * A pause (MODIFIER_BUTTON_RIGHT held, or the dashboard PAUSE command) closes
+ * the gun and decelerates along the path instead of force-stopping. On resume
+ * the axis backs up far enough to be at speed again, and the gun reopens at
+ * exactly the position where it closed.
+ *
+ * The stop input, a HOME request or a limit fault - including while paused -
+ * stops the axes, leaves the gun closed and returns false without resuming.
+ * Refused (false) while a limit fault is latched or the axes are not homed.
+ * @return true if the sweep ran to the end (or had nothing to paint).
+ */
+bool runPaintSweep(const PaintSweep& sweep);
+
+/**
+ * @brief Abandons the side after runPaintSweep() returned false: gun off,
+ * axes stopped, and HomingState unless a limit fault already sent the
+ * machine to ErrorState or it is already homing.
+ */
+void abortPaintSide(const char* tag);
+
+/**
+ * @brief Returns the record of the most recent sweep pause.
+ */
+const PaintSweepPauseRecord& getLastPaintSweepPause();
+
+//* ************************************************************************
+//* ************************** FEED OVERRIDE *******************************
+//* ************************************************************************
+// Live scaling of painting sweep speed, FEED_OVERRIDE_MIN..MAX_PERCENT.
+// Applied to the sweep in progress and every sweep that follows; gun edges
+// are position-based so they stay put when the speed changes. Not persisted.
+
+/**
+ * @brief Sets the feed override, clamped to the allowed range.
+ * @return The value actually applied.
+ */
+int setFeedOverridePercent(int percent);
+int getFeedOverridePercent();
+
+/**
+ * @brief Scales a recipe painting speed by the current feed override.
+ */
+long applyFeedOverride(long speedHz);
+
+/**
+ * @brief Control panel feed override while a sweep is running:
+ * Modifier Center + Action Left/Right = -/+ FEED_OVERRIDE_STEP_PERCENT,
+ * Modifier Center + Action Center = reset to 100%.
+ */
+void handleFeedOverrideButtons();
+
+#endif // PAINT_SWEEP_H
@@ -7,10 +7,7 @@ void paintSide2Pattern();
 void paintSide3Pattern();
 void paintSide4Pattern();
 
-// Declaration for the combined painting sequence
-void paintAllSides();
-
-// Global variable to control the number of coats for paintAllSides
+// Coats and flash-off for the paint-all sequence run by PaintingState
 extern int g_requestedCoats;
 extern int g_interCoatDelaySeconds;
 
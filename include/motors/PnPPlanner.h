@@ -0,0 +1,57 @@
+#ifndef PNP_PLANNER_H
+#define PNP_PLANNER_H
+
+#include <Arduino.h>
+#include "settings/pnp.h"
+
+//* ************************************************************************
+//* ************************ PNP PLACEMENT ORDER ***************************
+//* ************************************************************************
+// Every part is picked at the same spot, so each placement is a round trip
+// pick -> place -> pick and the sum of those trips does not depend on the
+// order. What does depend on it is the end of the cycle: painting starts at
+// the Side 4 start position, so the last part placed decides how far the
+// gantry travels before the first sweep. The planner picks the last
+// position that makes (place -> painting start) cheapest compared with
+// (place -> pick), and the full cycle goes straight to painting from there
+// instead of returning to pick first.
+//
+// Move times use the same trapezoidal model as the toolpath dry run
+// (estimateAxisMoveSeconds); X and Y run together, so the slower axis sets
+// the time. Outbound moves use the default axis speeds, returns to pick the
+// PnP speeds, both at the default accelerations (moveToXYZ does not change
+// them).
+//
+// Ordering constraints: with far-rows-first on, rows are filled in order of
+// their distance from the pick location, farthest first, and the last part
+// is chosen from the nearest row only.
+
+struct PnPPlacementPlan {
+    int count;
+    int order[TRAY_MAX_POSITIONS];  // Positions (1-based) in placement order
+    float plannedSeconds;           // Travel for this order, ending at the painting start
+    float rowMajorSeconds;          // Row-major order with a return to pick after the last part
+    float finishSeconds;            // Part of plannedSeconds after the last place (runs in the painting state)
+};
+
+/**
+ * @brief Fill far rows first. Persisted; off by default.
+ */
+void setPnPFarRowsFirst(bool enabled);
+bool isPnPFarRowsFirst();
+void loadPnPPlannerFromNVS();
+
+/**
+ * @brief Orders the fillable positions of the active tray. Positions are in
+ * steps; finish is where painting starts after the last part.
+ */
+void planPnPPlacementOrder(PnPPlacementPlan& plan, long pickX, long pickY, long finishX, long finishY);
+
+/**
+ * @brief Prints the plan's predicted saving against the measured PnP travel
+ * (to-place plus return phases) of a completed cycle. The measured/predicted
+ * ratio is applied to the saving, since the row-major order was not run.
+ */
+void reportPnPPlanOutcome(const PnPPlacementPlan& plan, unsigned long measuredTravelMs);
+
+#endif // PNP_PLANNER_H
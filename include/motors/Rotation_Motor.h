@@ -26,6 +26,13 @@ extern AccelStepper *rotationStepper;
  */
 void setupRotationMotor();
 
+/**
+ * @brief Starts a shortest-path rotation to a specific angle without waiting.
+ * The caller must keep calling rotationStepper->run() until distanceToGo() == 0.
+ * @return false if the rotation stepper is not initialized.
+ */
+bool startRotationToAngle(float angle);
+
 /**
  * @brief Rotates to a specific angle.
  * @param angle The target angle in degrees.
@@ -0,0 +1,43 @@
+#ifndef STOP_ALL_H
+#define STOP_ALL_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* **************************** STOP ALL **********************************
+//* ************************************************************************
+// Single stop service for the X / Y_Left / Y_Right / Z axis group.
+// Software paths (HOME commands, home-button checks in motion loops) call
+// stopAllAxes(); the physical stop input (STOP_ALL_INPUT_PIN while
+// STOP_ALL_QUALIFIER_PIN is held) kills the paint gun and vacuum directly
+// from its GPIO interrupt and latches the stop, and serviceStopAll() stops
+// the axes at task level.
+
+/**
+ * @brief Hard-stops every running linear axis at its current position.
+ */
+void stopAllAxes();
+
+/**
+ * @brief Attaches the stop-input interrupt. Call after the control panel
+ * pins have been configured (initializeGlobalDebouncers()).
+ */
+void initializeStopAllInterrupt();
+
+/**
+ * @brief Task-level half of an interrupt stop: stops the axes and, in
+ * latency measurement mode, reports edge-to-last-step time.
+ * Must be polled by every blocking motion loop (moves, sweeps, homing,
+ * rotation) as well as loop().
+ * @return true if a latched stop was handled by this call.
+ */
+bool serviceStopAll();
+
+/**
+ * @brief Enables/disables reporting of stop latency (input edge to last
+ * step pulse) after each interrupt stop.
+ */
+void setStopLatencyMeasurement(bool enabled);
+bool isStopLatencyMeasurementEnabled();
+
+#endif // STOP_ALL_H
@@ -0,0 +1,141 @@
+#ifndef TOOLPATH_H
+#define TOOLPATH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//* ************************************************************************
+//* ************************** TOOLPATH DRY RUN ****************************
+//* ************************************************************************
+// Compiles the side patterns into a list of moves without touching the
+// motors, so a recipe can be checked before painting a part. Each segment
+// mirrors one blocking move made by the Side states (safe Z, rotation, start
+// position, sweeps, shifts, final X sweep, move to (1,1,0)) and carries the
+// gun window and an estimated duration.
+//
+// No Arduino dependencies: the same code builds into the host dry-run CLI
+// (tools/toolpath_dryrun). Keep it in step with the Side*_Pattern.cpp files.
+
+#define TOOLPATH_SIDE_COUNT 4
+#define TOOLPATH_MAX_SEGMENTS 96
+#define TOOLPATH_ALL_SIDES 0                // compileToolpath() side: paint-all order 4, 3, 2, 1
+#define TOOLPATH_POLYLINE_BUFFER_SIZE 6144  // Enough for TOOLPATH_MAX_SEGMENTS painted sweeps
+
+// Pattern shape the Side states hardcode (not PaintingSettings fields)
+#define TOOLPATH_SIDE_SWEEP_COUNT 5         // Side 2-4 main-face sweeps
+#define TOOLPATH_MAX_SWEEP_COUNT 12         // Upper bound for host-side pattern exploration
+#define TOOLPATH_GUN_START_MARGIN 0.25f     // inches of travel before the gun opens
+#define TOOLPATH_GUN_STOP_MARGIN 0.5f       // inches before the end of a Side 2-4 sweep the gun closes
+#define TOOLPATH_EDGE_GUN_STOP_MARGIN 0.75f // Side 1 sweep and the Side 2/4 final X sweep
+
+enum ToolpathSegmentType : uint8_t {
+    TOOLPATH_TRAVEL,  // moveToXYZ at default speeds, gun closed
+    TOOLPATH_PAINT,   // runPaintSweep at the recipe speed
+    TOOLPATH_ROTATE   // rotateToAngle
+};
+
+// Recipe values for one side, in the units PaintingSettings uses
+struct ToolpathSideRecipe {
+    float startX;           // inches
+    float startY;           // inches
+    float zHeight;          // Painting Z (inches)
+    float sideZHeight;      // Safe Z for travel and rotation (inches)
+    float sweepY;           // inches
+    float shiftX;           // inches
+    long paintingXSpeed;    // steps/sec
+    long paintingYSpeed;    // steps/sec
+    float rotationAngle;    // degrees
+    // Pattern shape, fixed in firmware; the host optimizer may vary them
+    int sweepCount;         // Main-face sweeps (Side 1 always paints one)
+    float gunStartMargin;   // inches
+    float gunStopMargin;    // inches
+};
+
+struct ToolpathRecipe {
+    ToolpathSideRecipe sides[TOOLPATH_SIDE_COUNT]; // sides[0] = Side 1
+};
+
+struct ToolpathSegment {
+    uint8_t type;           // ToolpathSegmentType
+    uint8_t side;           // 1..4
+    long x0, y0, z0;        // Start position (steps)
+    long x1, y1, z1;        // End position (steps)
+    float angle0, angle1;   // Turntable angle before/after (degrees)
+    long gunOnOffset;       // PAINT only: travel from start when the gun opens (steps)
+    long gunOffOffset;      // PAINT only: travel from start when the gun closes (steps)
+    long speedHz;           // Commanded speed of the limiting axis (steps/sec)
+    float seconds;          // Estimated duration
+};
+
+struct ToolpathSummary {
+    int segmentCount;
+    bool truncated;         // Ran out of segment slots - times are incomplete
+    float totalSeconds;
+    float travelSeconds;
+    float paintSeconds;     // Whole painted sweeps, including ramps and margins
+    float rotateSeconds;
+    float gunOnSeconds;     // Time the gun is actually open
+    float gunOnInches;      // Painted length
+    float sideSeconds[TOOLPATH_SIDE_COUNT];
+};
+
+/**
+ * @brief Fills a recipe from the compiled-in painting.h defaults.
+ */
+void getDefaultToolpathRecipe(ToolpathRecipe& recipe);
+
+/**
+ * @brief Sets sweepCount and the gun margins to the shape the Side states paint.
+ */
+void applyFirmwarePatternShape(ToolpathSideRecipe& side, int sideNumber);
+
+/**
+ * @brief True when the recipe's pattern shape is the one the firmware paints,
+ * so loading it onto the machine reproduces what was compiled.
+ */
+bool isFirmwarePatternShape(const ToolpathSideRecipe& side, int sideNumber);
+
+/**
+ * @brief Estimated time (seconds) for a single-axis trapezoidal move from rest to rest.
+ */
+float estimateAxisMoveSeconds(long distanceSteps, float speedHz, float accel);
+
+/**
+ * @brief Compiles one side (1..4) or TOOLPATH_ALL_SIDES, starting from the
+ * homed position (0,0,0) and turntable angle 0.
+ * @return Number of segments written to segments.
+ */
+int compileToolpath(const ToolpathRecipe& recipe, int side,
+                    ToolpathSegment* segments, int maxSegments, ToolpathSummary& summary);
+
+/**
+ * @brief Formats compiled segments as a compact polyline for the dashboard.
+ * Points are "x,y,z,g" in hundredths of an inch, separated by ';', where g=1
+ * means the gun is open on the leg ending at that point. A rotation is
+ * written as "R,<degrees>".
+ * @return Characters written (excluding the terminator), or -1 if out did not fit.
+ */
+int formatToolpathPolyline(const ToolpathSegment* segments, int count, char* out, size_t outSize);
+
+/**
+ * @brief Formats the summary as "total=..,travel=..,paint=..,rotate=..,gun=..,
+ * gunIn=..,S1=..,S2=..,S3=..,S4=..,segments=.." (seconds, one decimal).
+ */
+int formatToolpathSummary(const ToolpathSummary& summary, char* out, size_t outSize);
+
+#ifdef ARDUINO
+/**
+ * @brief Compiles the current PaintingSettings recipe for side (0 = all).
+ * @return A shared buffer of count segments, valid until the next call.
+ */
+const ToolpathSegment* compileSettingsToolpath(int side, int& count, ToolpathSummary& summary);
+
+/**
+ * @brief Compiles the current PaintingSettings recipe for side (0 = all),
+ * logs the segment table and broadcasts TOOLPATH_SUMMARY: and TOOLPATH:.
+ * Never moves the motors.
+ */
+void broadcastToolpathDryRun(int side);
+#endif
+
+#endif // TOOLPATH_H
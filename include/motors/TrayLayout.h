@@ -0,0 +1,72 @@
+#ifndef TRAY_LAYOUT_H
+#define TRAY_LAYOUT_H
+
+#include <Arduino.h>
+#include "motors/PaintSweep.h"
+#include "settings/pnp.h"
+#include "storage/TrayDefinitions.h"
+
+//* ************************************************************************
+//* *************************** TRAY LAYOUT ********************************
+//* ************************************************************************
+// Splits a sweep's gun window into one window per part on the tray, so the
+// gun closes over the gaps between parts instead of painting the tray.
+//
+// Parts sit on the active tray (storage/TrayDefinitions.h), placed with the turntable at
+// 0 degrees. For a side painted at another angle each part is rotated about
+// the turntable centre, shifted by the gun's aim offset, and projected onto
+// the sweep axis; positive angles turn the tray from +X towards +Y. Parts
+// are not filtered by their distance across the sweep: side faces are
+// painted from beside the part, not over it.
+//
+// Off by default until TRAY_GUN_OFFSET_X/Y have been measured on the machine.
+//
+// Only occupied positions get windows. PnP records each part it places,
+// and the map can also be set from the dashboard. Sweeps are then trimmed
+// to the occupied extent, and a sweep that crosses no parts is skipped.
+
+/**
+ * @brief Enables or disables tray gun windows. Persisted.
+ */
+void setTrayGunWindowsEnabled(bool enabled);
+bool areTrayGunWindowsEnabled();
+void loadTrayLayoutFromNVS();
+
+/**
+ * @brief Tray occupancy, bit (position - 1) set for each occupied position
+ * of the active tray. Skipped cells are never occupied. Persisted; defaults
+ * to a full tray. Pass save = false to change it in RAM only.
+ */
+void setTrayOccupancy(uint32_t mask, bool save = true);
+uint32_t getTrayOccupancy();
+
+/**
+ * @brief Marks one position in RAM only, so a PnP cycle does not write NVS
+ * per part; the cycle calls saveTrayOccupancy() once when it ends or aborts.
+ */
+void setTrayPositionOccupied(int position, bool occupied);
+void saveTrayOccupancy();
+bool isTrayPositionOccupied(int position);
+
+/**
+ * @brief Occupancy as one '1'/'0' per position in PnP order, e.g. "1111100000".
+ */
+String trayOccupancyString();
+
+/**
+ * @brief Parses trayOccupancyString() format.
+ * @return false if the string is not one '1'/'0' per position of the active tray.
+ */
+bool parseTrayOccupancy(const String& text, uint32_t& mask);
+
+/**
+ * @brief Replaces the sweep's windows with the occupied parts it crosses,
+ * each widened by TRAY_GUN_WINDOW_MARGIN and clipped to the sweep's own gun
+ * margins, then trims the sweep to them (trimPaintSweepToWindows). Gaps
+ * shorter than TRAY_GUN_WINDOW_MIN_GAP are painted through.
+ * Returns the sweep unchanged while tray windows are disabled.
+ * @param rotationAngle Turntable angle the side is painted at (degrees).
+ */
+PaintSweep withTrayGunWindows(PaintSweep sweep, float rotationAngle);
+
+#endif // TRAY_LAYOUT_H
@@ -7,7 +7,14 @@
 
 // Declare functions defined in XYZ_Movements.cpp
 void moveToXYZ(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z, unsigned int zSpeed);
-void checkMotors(); // Function to update debouncers and check limit switches
+bool checkMotors(); // Updates debouncers and checks limit switches; true if a limit fault is latched
+
+// Non-blocking form of moveToXYZ: start the move, then call serviceMoveToXYZ()
+// while isMoveToXYZRunning(). startMoveToXYZ returns false if a limit fault is latched or the axes are not homed;
+// serviceMoveToXYZ returns false once the move has been aborted (limit or home button)
+bool startMoveToXYZ(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z, unsigned int zSpeed);
+bool isMoveToXYZRunning();
+bool serviceMoveToXYZ();
 
 // New function that checks for home command - returns true if completed, false if aborted
 bool moveToXYZ_HomeCheck(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z, unsigned int zSpeed);
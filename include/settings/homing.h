@@ -10,6 +10,20 @@
 #define HOMING_SPEED_Y 1500            // Y Homing speed
 #define HOMING_SPEED_Z 1000            // Z Homing speed
 
+// --- Two-Stage Homing (fast seek, back off, slow re-approach at HOMING_SPEED) ---
+#define HOMING_FAST_SPEED_X 6000       // X fast seek speed
+#define HOMING_FAST_SPEED_Y 6000       // Y fast seek speed
+#define HOMING_FAST_SPEED_Z 3000       // Z fast seek speed
+#define HOMING_RAPID_CLEARANCE_INCHES 0.5f   // With a valid reference, rapid to this far short of the switch before seeking
+#define HOMING_REPEATABILITY_HISTORY 8       // Homing cycles kept for the trigger repeatability log
+
+// --- Verify Home (after jobs) ---
+#define DEFAULT_VERIFY_HOME_AFTER_JOBS true  // Jobs end with a verify-home instead of a full homing cycle
+#define VERIFY_HOME_TOLERANCE_STEPS 6        // Max trigger drift (~0.024") accepted without a full homing
+
+// --- Rotation Homing ---
+#define HOMING_ROTATION_Z_CLEARANCE_INCHES 0.5f // Turntable homes alongside XYZ only once Z is within this of its home switch
+
 // --- Homing Accelerations ---
 #define HOMING_ACCEL_X 5000          // X Homing acceleration
 #define HOMING_ACCEL_Y 5000           // Y Homing acceleration
@@ -22,4 +36,10 @@
 #define HOMING_MOVE_AWAY_INCHES 0.2f             // Distance to move away from home switch (inches)
 #define HOMING_TIMEOUT_MS 15000                  // Homing timeout (ms)
 
+// --- Gantry Squaring ---
+#define DEFAULT_GANTRY_SQUARING_OFFSET_STEPS 0    // Y_Right correction after homing (steps, + = away from switch)
+#define GANTRY_SQUARING_MAX_OFFSET_STEPS 254      // Largest accepted squaring offset (1 inch)
+#define GANTRY_HOMING_SKEW_WARN_STEPS 50          // Warn when homing finds the gantry this far out of square
+#define GANTRY_HOMING_SKEW_FAULT_STEPS 127        // Racking fault when homing finds the gantry this far out of square (0.5")
+
 #endif // SETTINGS_HOMING_H 
\ No newline at end of file
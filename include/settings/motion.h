@@ -44,4 +44,7 @@
 #define DEFAULT_PNP_X_ACCEL 20000      // Default PNP X axis acceleration
 #define DEFAULT_PNP_Y_ACCEL 30000      // Default PNP Y axis acceleration
 
+// --- Gantry Sync (dual Y motors) ---
+#define GANTRY_SYNC_FAULT_STEPS 25         // Max Y_Left/Y_Right position difference before a racking fault (~0.1")
+
 #endif // SETTINGS_MOTION_H 
\ No newline at end of file
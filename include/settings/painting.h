@@ -62,6 +62,31 @@
 #define SIDE4_SWEEP_Y 20.00f                   // Side 4 pattern Y sweep distance
 #define SIDE4_SHIFT_X 5.00f                    // Side 4 pattern X shift distance
 
+// --- Pause / Resume During Sweeps ---
+#define PAUSE_RESUME_LEAD_IN_MARGIN_INCH 0.10f // Extra run-up added to the re-acceleration distance when resuming a paused sweep
+#define PAUSE_POLL_INTERVAL_MS 10              // Poll interval while a sweep is held paused (ms)
+
+// --- Paint Gun Driver ---
+#define DEFAULT_PAINT_GUN_MIN_PULSE_US 4000UL  // Shortest closed time before the solenoid may reopen (us)
+#define PAINT_GUN_MIN_PULSE_MAX_US 100000UL    // Upper bound accepted from the dashboard (us)
+#define PAINT_GUN_TELEMETRY_QUEUE_SIZE 32      // Gun events held until the next telemetry flush
+
+// --- Paint Gun Latency Compensation ---
+#define PAINT_GUN_COUNT 1                      // Guns with their own latency calibration
+#define DEFAULT_GUN_OPEN_LATENCY_MS 30.0f      // Command to paint leaving the nozzle (solenoid + air)
+#define DEFAULT_GUN_CLOSE_LATENCY_MS 20.0f     // Command to paint stopping
+#define GUN_LATENCY_MAX_MS 250.0f              // Larger values are rejected as a bad calibration
+#define GUN_CALIBRATION_SLOW_SPEED 2500        // X speed of the slow test stripe (steps/sec)
+#define GUN_CALIBRATION_FAST_SPEED 8000        // X speed of the fast test stripe (steps/sec)
+#define GUN_CALIBRATION_STRIPE_INCH 4.0f       // Commanded gun-on length of each stripe
+#define GUN_CALIBRATION_STRIPE_SPACING_INCH 1.5f // +Y offset between the two stripes
+
+// --- Live Feed Override (percent of the recipe's painting speed) ---
+#define FEED_OVERRIDE_DEFAULT_PERCENT 100
+#define FEED_OVERRIDE_MIN_PERCENT 50
+#define FEED_OVERRIDE_MAX_PERCENT 150
+#define FEED_OVERRIDE_STEP_PERCENT 10          // Change per control panel press
+
 // Post-Print Pause
 #define DEFAULT_POST_PRINT_PAUSE 0 // milliseconds
 
@@ -71,4 +96,33 @@
 // Delay Between Coats
 #define DEFAULT_COAT_DELAY_MS 10000 // Milliseconds (e.g., 30 seconds)
 
+// Drying Window Jobs (system/DryingScheduler.h)
+#define DEFAULT_DRYING_JOBS 0                  // Bit per DryingJob; all off until enabled from the dashboard
+#define DRYING_JOB_MARGIN_MS 1000              // Slack kept after a job for the move back to the loading bar
+#define DRYING_CLEAN_ESTIMATE_MS 6000          // First-run estimates, replaced by measured times
+#define DRYING_TIP_INSPECT_ESTIMATE_MS 6000
+#define DRYING_PRE_HOME_ESTIMATE_MS 15000
+#define DRYING_CLEAN_GUN_ON_MS 75              // Purge at the cleaning station (short clean)
+#define DRYING_TIP_INSPECT_DWELL_MS 3000       // Time parked at the inspect position
+
+// Job Queue (system/JobQueue.h)
+#define JOB_QUEUE_CAPACITY 16                  // Queued jobs kept in NVS
+#define JOB_PRIORITY_MAX 9                     // 0 = lowest; higher runs first
+#define DEFAULT_CLEAN_EVERY_JOBS 0             // Clean after this many paint jobs; 0 = never
+
+// Progress / ETA (system/CycleEstimator.h)
+#define CYCLE_ESTIMATE_LEARN_RATE 0.3f         // Weight of the latest measured side time in its learned scale
+#define CYCLE_SCALE_MIN 0.5f                   // Measured/toolpath time limits, so a long pause cannot wreck the ETA
+#define CYCLE_SCALE_MAX 3.0f
+#define PROGRESS_BROADCAST_INTERVAL_MS 1000    // PROGRESS: broadcast period between sweeps and while drying
+
+// Phase Time Breakdown (system/PhaseStats.h)
+#define PHASE_STACK_DEPTH 8                    // Nested phase hooks tracked at once
+#define PHASE_HISTOGRAM_BUCKETS 16             // Power-of-two ms buckets; the last holds 16 s and longer
+#define PHASE_HISTOGRAM_WINDOW 256             // Samples per phase before the counts are halved
+
+// Tip Inspection Position (inches)
+#define TIP_INSPECT_X_INCH 10.0f
+#define TIP_INSPECT_Y_INCH 0.5f
+
 #endif // SETTINGS_PAINTING_H 
\ No newline at end of file
@@ -15,10 +15,27 @@
 #define TRAY_HEIGHT 24.0f                      // Tray height
 
 // --- Grid Layout ---
+// Defaults for tray slot 0; trays are runtime data (storage/TrayDefinitions.h)
 #define GRID_COLS 2                            // Grid columns (was 4, now 2 columns processed at a time)
 #define GRID_ROWS 5                            // Grid rows
 #define GRID_ORIGIN_X 18.2 + 3.55f - SIDE3_SHIFT_X         // Grid origin X position (shifted by Side 3 shift value)
 #define GRID_ORIGIN_Y 32.4f                    // Grid origin Y position (top-right corner)
+#define GRID_PITCH_X 9.4f                      // Inches between columns
+#define GRID_PITCH_Y 5.0f                      // Inches between rows
+
+// --- Runtime Tray Definitions ---
+#define TRAY_DEFINITION_SLOTS 4                // Tray types stored in NVS
+#define TRAY_MAX_POSITIONS 32                  // rows x cols limit (one bit each in the occupancy mask)
+
+// --- Tray Gun Windows (inches) ---
+// Parts are placed with the turntable at 0 degrees. The default tray is
+// centred on the turntable, so the rotation centre is the middle of its grid.
+#define TURNTABLE_CENTER_X ((GRID_ORIGIN_X) - (GRID_COLS - 1) * GRID_PITCH_X / 2.0f)
+#define TURNTABLE_CENTER_Y (GRID_ORIGIN_Y - (GRID_ROWS - 1) * GRID_PITCH_Y / 2.0f)
+#define TRAY_GUN_OFFSET_X 0.0f                 // Spray aim point relative to the PnP cup at painting Z
+#define TRAY_GUN_OFFSET_Y 0.0f
+#define TRAY_GUN_WINDOW_MARGIN 0.25f           // Gun opens this far before a part and closes this far after it
+#define TRAY_GUN_WINDOW_MIN_GAP 0.5f           // Shorter gaps between parts are painted through
 
 // --- PnP Position Targeting ---
 enum PnPColumn {
@@ -52,12 +69,20 @@ inline int getGridPosition(PnPRow row, PnPColumn column) {
 // Delays for operations at the PICK location
 #define PNP_PICK_DELAY_AFTER_CYLINDER_EXTEND 150  // Delay after extending cylinder at pick loc
 #define PNP_PICK_DELAY_AFTER_VACUUM_ON 100        // Delay after engaging vacuum at pick loc
-#define PNP_PICK_DELAY_AFTER_CYLINDER_RETRACT 150 // Delay after retracting cylinder at pick loc (before moving to place)
 
 // Delays for operations at the PLACE location
 #define PNP_PLACE_DELAY_AFTER_CYLINDER_EXTEND 150 // Delay after extending cylinder at place loc
 #define PNP_PLACE_DELAY_AFTER_VACUUM_OFF 100      // Delay after disengaging vacuum at place loc
-#define PNP_PLACE_DELAY_AFTER_CYLINDER_RETRACT 150// Delay after retracting cylinder at place loc (before next move)
+
+// After cylinderUp, time until the cup clears the parts and XY may start
+// moving (pick and place). The rest of the retract overlaps the travel.
+#define PNP_CYLINDER_CLEAR_MS 100
+
+// --- Pneumatic Step Feedback (hardware/Pneumatics.h) ---
+// The fixed delays above are the ceilings. A step with a feedback switch
+// ends when the switch confirms; a step without one runs its full delay.
+#define PNEUMATIC_FEEDBACK_SETTLE_MS 10       // Extra wait after a switch confirms
+#define PNEUMATIC_FEEDBACK_TIMEOUT_FACTOR 3   // Switch must confirm within ceiling x this, or the step fails
 
 // Timeout between allowed cycle switch presses
 #define CYCLE_TIMEOUT 5 // milliseconds
@@ -5,5 +5,7 @@
 //                        TIMING & INTERVALS (ms)
 // ==========================================================================
 #define DEBOUNCE_INTERVAL 5                    // Debounce interval for inputs (ms)
+#define STOP_LATENCY_MAX_WAIT_US 200000UL      // Max wait for axes to drain when measuring stop latency (us)
+#define LOOP_PROFILE_BUCKETS 24                // Power-of-two us buckets; the last holds ~4.2 s and longer
 
 #endif // SETTINGS_TIMING_H 
\ No newline at end of file
@@ -19,4 +19,10 @@ private:
     bool shortMode; // Added for short cleaning cycle
 };
 
+/**
+ * @brief Moves to the clean station, fires the gun for gunOnMs and lifts Z
+ * back to 0 there. The pressure pot must already be on. Blocking.
+ */
+void purgeGunAtCleaningStation(unsigned long gunOnMs);
+
 #endif // CLEANING_STATE_H 
\ No newline at end of file
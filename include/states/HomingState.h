@@ -10,6 +10,21 @@
 // Function declarations
 // bool homeAllAxes();
 
+/**
+ * @brief Asks the next entry into HomingState to run Homing::verifyHome()
+ * instead of a full homing cycle. Ignored unless verify-home after jobs is
+ * enabled. Call just before changing to the homing state at the end of a job.
+ */
+void requestVerifyHome();
+
+/**
+ * @brief Outcome of the most recent homing cycle, and how many have finished
+ * since boot, so a caller can tell whether one ran (and succeeded) after a
+ * point it recorded.
+ */
+bool didLastHomingSucceed();
+uint32_t getHomingCycleCount();
+
 class HomingState : public State {
 public:
     HomingState();
@@ -24,6 +39,7 @@ private:
     bool _isHoming;
     bool _homingComplete;
     bool _homingSuccess;
+    bool _verifyHome; // This entry runs verifyHome() rather than homeAllAxes()
 };
 
 #endif // HOMING_STATE_H 
\ No newline at end of file
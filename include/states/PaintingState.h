@@ -17,19 +17,25 @@ public:
 private:
     enum PaintingSubStep {
         PS_IDLE,
-        PS_START_SIDE4_PAINTING,
-        PS_WAIT_FOR_SIDE4_COMPLETION,
-        PS_START_SIDE3_PAINTING,
-        PS_WAIT_FOR_SIDE3_COMPLETION,
-        PS_START_SIDE2_PAINTING,
-        PS_WAIT_FOR_SIDE2_COMPLETION,
-        PS_START_SIDE1_PAINTING,
-        PS_WAIT_FOR_SIDE1_COMPLETION,
-        PS_PERFORM_ALL_SIDES_PAINTING,
+        PS_START_NEXT_SIDE,               // Next side of sideOrder, once it has dried
+        PS_WAIT_FOR_SIDE_DRYING,
+        PS_WAIT_FOR_SIDE_COMPLETION,
         PS_MOVE_TO_POSITION_BEFORE_HOMING,
         PS_REQUEST_HOMING
     };
     PaintingSubStep currentStep;
+
+    // Coats run side by side; each side waits for its own flash-off (system/DryingScheduler.h)
+    int totalCoats;
+    int coat;
+    int sideIndex;
+    int sideOrder[4];
+    unsigned long sideStartMs;
+    unsigned long dryingStartMs;
+    bool dryingJobsRun;
+
+    void startJob(int coats);
+    void startSide(int side);
 };
 
 #endif // PAINTING_STATE_H 
\ No newline at end of file
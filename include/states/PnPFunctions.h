@@ -6,8 +6,8 @@
 // ===========================================================================
 // Clean, easy-to-use PnP functions that replace the complex state machine
 
-// Full cycle function - processes all positions 1-10
-void startPnPFullCycle();
+// Full cycle function - fills the active tray, then paints all sides (coats)
+void startPnPFullCycle(int coats = 2);
 
 // Individual position functions (much easier than classes!)
 void pnpRow1Left();   // Position 1
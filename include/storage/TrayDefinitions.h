@@ -0,0 +1,76 @@
+#ifndef TRAY_DEFINITIONS_H
+#define TRAY_DEFINITIONS_H
+
+#include <Arduino.h>
+#include "settings/pnp.h"
+
+//* ************************************************************************
+//* ************************* TRAY DEFINITIONS *****************************
+//* ************************************************************************
+// Tray layouts are runtime data kept in NVS next to the painting recipe,
+// TRAY_DEFINITION_SLOTS of them. One slot is active. Slots that were never
+// saved hold the compile-time GRID_* layout.
+//
+// Positions are numbered 1..rows x cols, row by row from the origin
+// (position 1, top-right corner). Columns step towards -X and rows towards
+// -Y, as on the original tray. Placement targets for the active tray are
+// precomputed in steps whenever it changes.
+
+struct TrayDefinition {
+    int rows;
+    int cols;
+    float originX;      // Position 1 (inches)
+    float originY;
+    float pitchX;       // Between columns (inches)
+    float pitchY;       // Between rows (inches)
+    float partWidth;    // Part footprint along X at 0 degrees (inches)
+    float partLength;   // Part footprint along Y at 0 degrees (inches)
+    uint32_t skipMask;  // Cells never filled, bit (position - 1)
+};
+
+/**
+ * @brief Validates and saves a tray definition to a slot. If the slot is
+ * active its placement table is rebuilt.
+ * @return false (and logs why) if the definition is rejected.
+ */
+bool setTrayDefinition(int slot, const TrayDefinition& tray);
+const TrayDefinition& getTrayDefinition(int slot);
+
+/**
+ * @brief Makes a slot the active tray and persists the choice.
+ * Resets tray occupancy to every non-skipped position.
+ */
+bool selectTraySlot(int slot);
+int getActiveTraySlot();
+const TrayDefinition& getActiveTray();
+
+/**
+ * @brief rows x cols of the active tray, including skipped cells.
+ */
+int getTrayPositionCount();
+bool isTrayPositionSkipped(int position);
+
+/**
+ * @brief Bit (position - 1) set for every non-skipped position of the active tray.
+ */
+uint32_t getTrayFillableMask();
+
+/**
+ * @brief Precomputed placement target of a position on the active tray.
+ * @return false if the position is out of range.
+ */
+bool getTrayPlacementSteps(int position, long& xSteps, long& ySteps);
+
+/**
+ * @brief Centre of a position on the active tray in inches.
+ */
+bool getTrayPositionInches(int position, float& x, float& y);
+
+/**
+ * @brief slot,rows,cols,originX,originY,pitchX,pitchY,partWidth,partLength,skipMask
+ */
+String describeTrayDefinition(int slot);
+
+void loadTrayDefinitionsFromNVS();
+
+#endif // TRAY_DEFINITIONS_H
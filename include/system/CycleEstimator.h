@@ -0,0 +1,56 @@
+#ifndef CYCLE_ESTIMATOR_H
+#define CYCLE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "system/DryingScheduler.h" // PAINT_SIDE_COUNT
+
+//* ************************************************************************
+//* ************************** PROGRESS AND ETA ****************************
+//* ************************************************************************
+// Predicts when the current side, coat and job will finish. Each side
+// starts from the compiled toolpath time (motors/Toolpath.h, axis speeds
+// and acceleration limits, sweeps trimmed to the occupied tray positions
+// when tray gun windows are on), scaled by how long that side has actually
+// taken. Inside a side, each finished sweep re-scales the rest of the side
+// from the time measured so far. Flash-off waits are simulated per side as
+// PaintingState runs them.
+//
+// Broadcast as
+//   PROGRESS:side=<n>,coat=<c>/<coats>,phase=<painting|drying>,sidePct=..,sideEta=..,
+//            coatPct=..,coatEta=..,jobPct=..,jobEta=..
+// with ETAs in seconds from now, then PROGRESS:done or PROGRESS:stopped.
+// The learned per-side scales are saved after each completed job; a side
+// painted after the tray windows or occupancy changed is not learned from.
+
+/**
+ * @brief Compiles the current recipe and starts tracking a painting job.
+ */
+void beginCycleEstimate(int coats, unsigned long flashOffMs);
+
+/**
+ * @brief Sets the coat (1-based) and the order its sides will be painted in.
+ */
+void setCycleCoat(int coat, const int order[PAINT_SIDE_COUNT]);
+
+void noteCycleSideStarted(int side);
+void noteCycleSideDone(int side);
+
+/**
+ * @brief Called after every painted sweep; ignored outside a painting job.
+ */
+void noteCycleSweepDone();
+
+/**
+ * @brief Ends tracking. A completed job updates and saves the learned scales.
+ */
+void endCycleEstimate(bool completed);
+
+/**
+ * @brief Broadcasts PROGRESS: every PROGRESS_BROADCAST_INTERVAL_MS and
+ * notices a job that was stopped. Call from the main loop.
+ */
+void serviceCycleEstimate();
+
+void loadCycleEstimatorFromNVS();
+
+#endif // CYCLE_ESTIMATOR_H
@@ -0,0 +1,88 @@
+#ifndef DRYING_SCHEDULER_H
+#define DRYING_SCHEDULER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ DRYING WINDOW JOBS ****************************
+//* ************************************************************************
+// Multi-coat jobs wait for paint to flash off between coats. The gantry is
+// free for that time, so maintenance jobs run inside the wait instead of as
+// separate operations later.
+//
+// A job runs only if its estimate plus DRYING_JOB_MARGIN_MS fits in the
+// time left, so the coat still starts on time unless a job overruns its
+// estimate. Each job's estimate is replaced by its last measured time.
+//
+// Loading the next tray is not a drying job: the tray being painted is on
+// the turntable, so the next one can only be placed once it is removed.
+
+enum DryingJob {
+    DRYING_JOB_CLEAN,        // Purge the gun at the cleaning station (every window)
+    DRYING_JOB_TIP_INSPECT,  // Park at the tip inspection position (once per job)
+    DRYING_JOB_PRE_HOME,     // Verify home so drift is caught before the next coat (once per job)
+    DRYING_JOB_COUNT
+};
+
+/**
+ * @brief Enabled jobs, bit (1 << DryingJob) each. Persisted.
+ */
+void setDryingJobMask(int mask);
+int getDryingJobMask();
+void loadDryingJobsFromNVS();
+
+/**
+ * @brief Resets the once-per-job flags and utilization totals. Call when a
+ * multi-coat job starts.
+ */
+void beginDryingJobs();
+
+/**
+ * @brief Runs the enabled jobs that fit before dryingStartMs + dryingMs.
+ * @return false if an operation was aborted (home or limit fault).
+ */
+bool runDryingJobs(unsigned long dryingStartMs, unsigned long dryingMs);
+
+/**
+ * @brief Logs the window's length and the share used by jobs. Call when the
+ * drying wait ends.
+ */
+void endDryingWindow(unsigned long dryingStartMs);
+
+/**
+ * @brief Logs utilization over all windows since beginDryingJobs().
+ */
+void reportDryingUtilization();
+
+//* ************************************************************************
+//* **************************** SIDE DRYING *******************************
+//* ************************************************************************
+// Each side dries on its own clock: its next coat may start flashOffMs
+// after that side finished, not after the whole coat finished. Side 4 has
+// already dried while Sides 3, 2 and 1 were painted.
+
+#define PAINT_SIDE_COUNT 4
+
+/**
+ * @brief Forgets all side times. Call when a multi-coat job starts.
+ */
+void resetSideDrying();
+
+/**
+ * @brief Records a painted side (1-4); its duration feeds the order planner.
+ */
+void recordSidePainted(int side, unsigned long startMs, unsigned long doneMs);
+
+/**
+ * @brief Milliseconds until the side may be painted again (0 if dry or never painted).
+ */
+unsigned long sideDryingLeftMs(int side, unsigned long flashOffMs);
+
+/**
+ * @brief Picks the side order for the next coat that minimizes waiting,
+ * using each side's ready time and last measured duration. Ties keep the
+ * 4, 3, 2, 1 order.
+ */
+void planCoatSideOrder(int order[PAINT_SIDE_COUNT], unsigned long flashOffMs);
+
+#endif // DRYING_SCHEDULER_H
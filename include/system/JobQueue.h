@@ -0,0 +1,86 @@
+#ifndef JOB_QUEUE_H
+#define JOB_QUEUE_H
+
+#include <Arduino.h>
+#include "settings/painting.h"
+
+//* ************************************************************************
+//* ****************************** JOB QUEUE *******************************
+//* ************************************************************************
+// Jobs wait here until the machine is idle, then start back to back
+// without an operator. The highest priority runs first; equal priorities
+// run in queue order. The queue is kept in NVS, but after a reboot it is
+// held until resumed, so the machine never starts moving on power-up.
+//
+// A job that ends in ErrorState or with a failed homing, is stopped by a
+// home or stop request, or fails to start holds the queue. Completed paint jobs count towards the
+// clean-every-K setting, which runs a cleaning cycle before the next job.
+//
+// Recipes are not stored on the device, so a job paints with the current
+// painting settings; it can select a tray slot (storage/TrayDefinitions.h).
+
+enum QueuedJobType {
+    QUEUED_JOB_PAINT,      // Paint all sides, N coats
+    QUEUED_JOB_PNP_PAINT,  // PnP full cycle, then paint N coats
+    QUEUED_JOB_CLEAN,      // Cleaning cycle
+    QUEUED_JOB_TYPE_COUNT
+};
+
+struct QueuedJob {
+    int id;                // Assigned by enqueueJob()
+    QueuedJobType type;
+    int priority;          // 0..JOB_PRIORITY_MAX
+    int coats;
+    int flashOffSeconds;   // Per-side flash-off between coats
+    int traySlot;          // -1 keeps the active tray
+};
+
+/**
+ * @brief Adds a job; coats, flash-off, priority and tray slot are clamped.
+ * @return The job id, or -1 if the queue is full.
+ */
+int enqueueJob(QueuedJob job);
+
+/**
+ * @brief Removes a waiting job. The running job is stopped with HOME instead.
+ */
+bool cancelJob(int id);
+
+/**
+ * @brief Moves a waiting job to index (0 = front) among the waiting jobs.
+ */
+bool moveJob(int id, int index);
+bool setJobPriority(int id, int priority);
+
+/**
+ * @brief Running starts jobs whenever the machine is idle. Not persisted.
+ */
+void setJobQueueRunning(bool running);
+bool isJobQueueRunning();
+
+/**
+ * @brief Holds the queue and marks the running job as stopped.
+ */
+void holdJobQueue(const char* reason);
+
+/**
+ * @brief Cleaning cycle after every K completed paint jobs (0 = never). Persisted.
+ */
+void setCleanEveryJobs(int jobs);
+int getCleanEveryJobs();
+
+/**
+ * @brief <running>,<clean every>,<active id or 0>;<id>:<type>:<priority>:<coats>:<flash-off>:<tray>;...
+ */
+String describeJobQueue();
+
+const char* queuedJobTypeName(QueuedJobType type);
+bool parseQueuedJobType(const String& text, QueuedJobType& type);
+
+/**
+ * @brief Starts the next job when idle and tracks the running one. Call from the main loop.
+ */
+void serviceJobQueue();
+void loadJobQueueFromNVS();
+
+#endif // JOB_QUEUE_H
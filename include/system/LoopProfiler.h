@@ -0,0 +1,68 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* *************************** LOOP PROFILER ******************************
+//* ************************************************************************
+// Records the main loop period and the time of each subsystem into
+// fixed power-of-two microsecond histograms (bucket b holds
+// [2^(b-1), 2^b) us, bucket 0 is 0 us). A sample is one micros() read, a
+// count-leading-zeros and a few adds, so the loop can stay instrumented.
+//
+// The state update section includes every blocking step (moves, sweeps,
+// drying waits), so its tail shows how long the loop is held off. The
+// WebSocket pump section covers processWebSocketEventsFrequently() calls
+// made from inside those motion loops.
+//
+// Read with the dashboard GET_LOOP_PROFILE command (LOOP_PROFILE: lines,
+// also logged to Serial); clear with RESET_LOOP_PROFILE. The report is
+// deferred to the end of loop() so it never lands inside a timed section.
+
+enum LoopProfileSection {
+    LOOP_PROFILE_PERIOD,         // loop() start to the next loop() start
+    LOOP_PROFILE_WORK,           // loop() body without the trailing delay(1)
+    LOOP_PROFILE_OTA,
+    LOOP_PROFILE_SAFETY,         // Stop-all, gantry sync, limit switches, gun service
+    LOOP_PROFILE_STATE_UPDATE,   // stateMachine->update()
+    LOOP_PROFILE_SERVICES,       // Job queue, ETA and phase stats
+    LOOP_PROFILE_CONTROL_PANEL,
+    LOOP_PROFILE_DASHBOARD,      // runDashboardServer() and the gun telemetry flush
+    LOOP_PROFILE_ROTATION,       // rotationStepper->run()
+    LOOP_PROFILE_WS_PUMP,        // processWebSocketEventsFrequently()
+    LOOP_PROFILE_SECTION_COUNT
+};
+
+void recordLoopProfileSample(LoopProfileSection section, uint32_t durationUs);
+
+/**
+ * @brief Call first in loop(); records the period since the previous call.
+ * @return The current micros(), to pass to loopProfileMark().
+ */
+uint32_t loopProfileBegin();
+
+/**
+ * @brief Records micros() - sinceUs for section.
+ * @return The current micros(), the start of the next section.
+ */
+inline uint32_t loopProfileMark(LoopProfileSection section, uint32_t sinceUs) {
+    uint32_t nowUs = micros();
+    recordLoopProfileSample(section, nowUs - sinceUs);
+    return nowUs;
+}
+
+/**
+ * @brief Asks for a report at the next serviceLoopProfileReport() call.
+ */
+void requestLoopProfileReport();
+
+/**
+ * @brief Call from loop() after the last section mark. If a report was
+ * requested, logs every section (count, mean, p50, p99, max in us, buckets)
+ * and broadcasts one LOOP_PROFILE: line per section.
+ */
+void serviceLoopProfileReport();
+void resetLoopProfile();
+
+#endif // LOOP_PROFILER_H
@@ -0,0 +1,72 @@
+#ifndef PHASE_STATS_H
+#define PHASE_STATS_H
+
+#include <Arduino.h>
+
+//* ************************************************************************
+//* ************************ PHASE TIME BREAKDOWN **************************
+//* ************************************************************************
+// Splits a job's time into phases so it shows where optimization would pay
+// off. Hooks in moveToXYZ, rotateToAngle, runPaintSweep, the homing
+// routines and the cleaning purge open a phase for their duration; the
+// Side states and PaintingState set the background phase (button wait,
+// flash-off) for the time spent between steps. Time is charged to the
+// innermost phase only, except that homing and cleaning keep their own
+// moves. Job time outside any hook is "other".
+//
+// Each job's breakdown is broadcast as PHASE_BREAKDOWN: when the machine is
+// back in Idle (or Error). Every phase span also goes into a rolling
+// histogram in RAM, and NVS keeps the job count and per-phase means.
+
+enum CyclePhase {
+    PHASE_OTHER,        // Step logic, servo, pneumatics, dashboard
+    PHASE_TRAVEL,       // moveToXYZ
+    PHASE_PAINT,        // runPaintSweep
+    PHASE_ROTATE,       // rotateToAngle
+    PHASE_BUTTON_WAIT,  // Modifier button waits in the Side states
+    PHASE_HOMING,       // Homing::homeAllAxes / verifyHome, including their moves
+    PHASE_CLEANING,     // Gun purge at the cleaning station, including its moves
+    PHASE_FLASH_OFF,    // Inter-coat drying wait (drying jobs are charged to their own phases)
+    PHASE_COUNT
+};
+
+/**
+ * @brief Starts a job breakdown; ignored while one is running, so a PnP
+ * cycle and the painting it hands over to are one job.
+ */
+void beginPhaseJob();
+
+void beginPhase(CyclePhase phase);
+void endPhase();
+
+/**
+ * @brief Phase charged while no hook is open (PHASE_OTHER by default).
+ */
+void setPhaseBackground(CyclePhase phase);
+
+// Opens a phase for the enclosing scope
+class PhaseScope {
+public:
+    explicit PhaseScope(CyclePhase phase) { beginPhase(phase); }
+    ~PhaseScope() { endPhase(); }
+};
+
+/**
+ * @brief Ends the job breakdown once the machine is Idle or in Error. Call from the main loop.
+ */
+void servicePhaseStats();
+
+/**
+ * @brief Broadcasts PHASE_SUMMARY: (NVS means) and one PHASE_HISTOGRAM: per phase.
+ */
+void broadcastPhaseStats();
+
+/**
+ * @brief Clears the histograms and the NVS summary.
+ */
+void resetPhaseStats();
+
+const char* cyclePhaseName(CyclePhase phase);
+void loadPhaseStatsFromNVS();
+
+#endif // PHASE_STATS_H
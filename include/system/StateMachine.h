@@ -8,6 +8,7 @@
 #include "states/PausedState.h"
 #include "states/IdleState.h"
 #include "states/InspectTipState.h"
+#include "states/ErrorState.h"
 
 // PnPState removed - now using standalone functions
 
@@ -28,6 +29,7 @@ public:
     State* getPausedState() { return pausedState; }
     // getPnpState() removed - now using standalone functions
     State* getInspectTipState() { return inspectTipState; }
+    State* getErrorState() { return errorState; }
     
     // Mechanism to allow a state to define the next state after a sub-routine
     void setNextStateOverride(State* state);
@@ -54,6 +56,7 @@ private:
     State* pausedState;
     // pnpState removed - now using standalone functions
     State* inspectTipState;
+    State* errorState;
     State* nextStateOverride; // Added for sub-routine returns
     bool _isTransitioningToPaintAllSides; // Flag for paint all sides transition
     bool _inPaintAllSidesMode; // Persistent flag to track if we're in Paint All Sides mode
@@ -606,6 +606,19 @@ const char HTML_PROGMEM[] PROGMEM = R"rawliteral(
             padding: 12px 24px;
             font-size: 1rem;
         }
+
+        .toolpath-preview {
+            display: none;
+            margin-top: 16px;
+            text-align: center;
+        }
+
+        .toolpath-preview canvas {
+            width: 100%;
+            max-width: 640px;
+            background: #1e1e1e;
+            border-radius: 8px;
+        }
         
         /* Responsive Design */
         @media (max-width: 768px) {
@@ -1016,6 +1029,31 @@ const char HTML_PROGMEM[] PROGMEM = R"rawliteral(
                     }
                 }
                 
+                // Handle feed override updates (web or control panel)
+                else if (messageText.startsWith('FEED_OVERRIDE:')) {
+                    const percent = messageText.substring(14);
+                    const slider = document.getElementById('feedOverrideSlider');
+                    const label = document.getElementById('feedOverrideValue');
+                    if (slider) slider.value = percent;
+                    if (label) label.textContent = percent;
+                }
+
+                // Handle pattern dry run results (motors do not move)
+                else if (messageText.startsWith('TOOLPATH_SUMMARY:')) {
+                    showToolpathSummary(messageText.substring(17));
+                }
+                else if (messageText.startsWith('TOOLPATH:')) {
+                    drawToolpath(messageText.substring(9));
+                }
+
+                // Handle limit switch faults (machine goes to ERROR until homed)
+                else if (messageText.startsWith('LIMIT_FAULT:')) {
+                    const axes = messageText.substring(12);
+                    if (axes !== 'CLEARED') {
+                        alert("Limit switch fault on " + axes + ". All motion stopped - clear the obstruction and HOME to recover.");
+                    }
+                }
+
                 // Handle status messages
                 else if (messageText.startsWith('STATUS:')) {
                     const status = messageText.substring(7);
@@ -1069,6 +1107,12 @@ const char HTML_PROGMEM[] PROGMEM = R"rawliteral(
                             </span>
                             <span id="pauseBtnLabel" class="btn-label">PAUSE</span>
                         </button>
+                        <div style="margin-top: 20px;">
+                            <label for="feedOverrideSlider">Feed Override: <span id="feedOverrideValue">100</span>%</label>
+                            <input type="range" id="feedOverrideSlider" min="50" max="150" step="5" value="100" style="width: 100%;"
+                                   oninput="document.getElementById('feedOverrideValue').textContent = this.value"
+                                   onchange="sendCommand('SET_FEED_OVERRIDE:' + this.value)">
+                        </div>
                     </div>
                 `;
                 // Insert pause container before the main controls container
@@ -1325,6 +1369,76 @@ const char HTML_PROGMEM[] PROGMEM = R"rawliteral(
             }
         }
         
+        // Dry run summary: "total=..,travel=..,paint=..,rotate=..,gun=..,gunIn=..,S1=..,...,segments=.."
+        function showToolpathSummary(summary) {
+            const values = {};
+            summary.split(',').forEach(function(pair) {
+                const parts = pair.split('=');
+                values[parts[0]] = parts[1];
+            });
+            const label = document.getElementById('toolpathSummary');
+            if (label) {
+                label.textContent = 'Cycle ' + values.total + ' s (travel ' + values.travel + ', paint ' + values.paint +
+                    ', rotate ' + values.rotate + ') - gun on ' + values.gun + ' s / ' + values.gunIn + ' in' +
+                    ' - S1 ' + values.S1 + ' S2 ' + values.S2 + ' S3 ' + values.S3 + ' S4 ' + values.S4 +
+                    (summary.indexOf('TRUNCATED') >= 0 ? ' (TRUNCATED)' : '');
+            }
+        }
+
+        // Dry run polyline, top-down XY: "x,y,z,g;..." in 1/100 inch, "R,<deg>" marks a rotation
+        function drawToolpath(polyline) {
+            const container = document.getElementById('toolpathPreview');
+            const canvas = document.getElementById('toolpathCanvas');
+            if (!container || !canvas || polyline.length === 0) return;
+            container.style.display = 'block';
+
+            const points = [];
+            polyline.split(';').forEach(function(token) {
+                const f = token.split(',');
+                if (f[0] === 'R') {
+                    points.push({ rotate: parseInt(f[1]) });
+                } else {
+                    points.push({ x: f[0] / 100, y: f[1] / 100, gun: f[3] === '1' });
+                }
+            });
+
+            let minX = Infinity, maxX = -Infinity, minY = Infinity, maxY = -Infinity;
+            points.forEach(function(p) {
+                if (p.rotate !== undefined) return;
+                minX = Math.min(minX, p.x); maxX = Math.max(maxX, p.x);
+                minY = Math.min(minY, p.y); maxY = Math.max(maxY, p.y);
+            });
+            const ctx = canvas.getContext('2d');
+            const margin = 20;
+            const scale = Math.min((canvas.width - 2 * margin) / Math.max(maxX - minX, 1),
+                                   (canvas.height - 2 * margin) / Math.max(maxY - minY, 1));
+            const toX = function(x) { return margin + (x - minX) * scale; };
+            const toY = function(y) { return canvas.height - margin - (y - minY) * scale; };
+
+            ctx.clearRect(0, 0, canvas.width, canvas.height);
+            let last = null;
+            points.forEach(function(p) {
+                if (p.rotate !== undefined) {
+                    if (last) {
+                        ctx.fillStyle = '#90caf9';
+                        ctx.fillText(p.rotate + '\u00b0', toX(last.x) + 4, toY(last.y) - 4);
+                    }
+                    return;
+                }
+                if (last) {
+                    ctx.beginPath();
+                    ctx.strokeStyle = p.gun ? '#ef5350' : '#757575';
+                    ctx.lineWidth = p.gun ? 3 : 1;
+                    ctx.setLineDash(p.gun ? [] : [4, 4]);
+                    ctx.moveTo(toX(last.x), toY(last.y));
+                    ctx.lineTo(toX(p.x), toY(p.y));
+                    ctx.stroke();
+                }
+                last = p;
+            });
+            ctx.setLineDash([]);
+        }
+
         // Update pause button state based on machine state
         function updatePauseButtonState(isPaused) {
             const pauseBtn = document.getElementById('pauseBtn');
@@ -1950,6 +2064,13 @@ const char HTML_PROGMEM[] PROGMEM = R"rawliteral(
                 <!-- Remove Load and Save buttons -->
                 <!-- <button class="main-btn blue" onclick="loadPatternSettings()">Load Settings</button> -->
                 <!-- <button class="main-btn highlight" onclick="savePatternSettings()">Save Settings</button> -->
+                <button class="main-btn blue" title="Compile the pattern without moving" onclick="sendCommand('DRY_RUN:0')">Dry Run Preview</button>
+            </div>
+
+            <!-- Dry run toolpath preview (red = gun on, dashed = travel) -->
+            <div class="toolpath-preview" id="toolpathPreview">
+                <canvas id="toolpathCanvas" width="640" height="480"></canvas>
+                <div id="toolpathSummary"></div>
             </div>
         </div> <!-- End of pattern-settings-content-wrapper -->
     </div>
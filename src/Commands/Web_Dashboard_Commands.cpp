@@ -30,6 +30,21 @@
 #include <limits.h> // ADDED For LONG_MIN, INT_MIN
 #include "system/GlobalState.h" // ADDED for isPaused and isActivePainting
 #include "states/PnPFunctions.h" // Clean PnP functions - replaces state machine approach
+#include "motors/PaintSweep.h" // Live feed override for painting sweeps
+#include "motors/TrayLayout.h" // Per-part gun windows and tray occupancy
+#include "storage/TrayDefinitions.h" // Runtime tray layouts
+#include "motors/PnPPlanner.h" // PnP placement order constraints
+#include "system/DryingScheduler.h" // Jobs during the inter-coat delay
+#include "system/JobQueue.h" // Queued paint, PnP and clean jobs
+#include "system/PhaseStats.h" // Phase time breakdown
+#include "system/LoopProfiler.h" // Loop latency histograms
+#include "hardware/Pneumatics.h" // PnP actuation step timing
+#include "motors/StopAll.h" // Centralised axis-group stop
+#include "motors/LimitSwitches.h" // Latched limit faults abort operations
+#include "motors/GantrySync.h" // Gantry squaring offset
+#include "motors/Homing.h" // Verify home after jobs
+#include "motors/Toolpath.h" // Pattern dry run
+#include "hardware/GunLatency.h" // Paint gun latency compensation
 
 // --- PNP Settings Keys for NVS ---
 #define PNP_X_SPEED_KEY "pnpXSpd"
@@ -73,6 +88,111 @@ void loadPnpSettingsFromNVS() {
                   g_pnp_x_speed, g_pnp_x_accel, g_pnp_y_speed, g_pnp_y_accel);
 }
 
+// GUN_LATENCY:<open ms>,<close ms>,<compensation 1/0>
+static void broadcastGunLatency(WebSocketsServer* webSocket) {
+    const GunLatency& latency = getGunLatency(0);
+    String latencyMsg = "GUN_LATENCY:" + String(latency.openMs, 1) + "," + String(latency.closeMs, 1) + ",";
+    latencyMsg += isGunLatencyCompensationEnabled() ? "1" : "0";
+    webSocket->broadcastTXT(latencyMsg);
+}
+
+static void broadcastTrayOccupancy(WebSocketsServer* webSocket) {
+    String occupancyMsg = "TRAY_OCCUPANCY:" + trayOccupancyString();
+    webSocket->broadcastTXT(occupancyMsg);
+}
+
+// TRAY:<slot>,<rows>,<cols>,<originX>,<originY>,<pitchX>,<pitchY>,<partWidth>,<partLength>,<skipMask>
+static void broadcastTrayDefinition(WebSocketsServer* webSocket, int slot) {
+    String trayMsg = "TRAY:" + describeTrayDefinition(slot);
+    webSocket->broadcastTXT(trayMsg);
+}
+
+// SET_TRAY fields missing from the JSON keep the slot's current values
+static TrayDefinition trayDefinitionFromJson(JsonDocument& doc, int slot) {
+    TrayDefinition tray = getTrayDefinition(slot);
+    if (doc["rows"].is<int>()) tray.rows = doc["rows"].as<int>();
+    if (doc["cols"].is<int>()) tray.cols = doc["cols"].as<int>();
+    if (doc["originX"].is<float>()) tray.originX = doc["originX"].as<float>();
+    if (doc["originY"].is<float>()) tray.originY = doc["originY"].as<float>();
+    if (doc["pitchX"].is<float>()) tray.pitchX = doc["pitchX"].as<float>();
+    if (doc["pitchY"].is<float>()) tray.pitchY = doc["pitchY"].as<float>();
+    if (doc["partWidth"].is<float>()) tray.partWidth = doc["partWidth"].as<float>();
+    if (doc["partLength"].is<float>()) tray.partLength = doc["partLength"].as<float>();
+    if (doc["skipMask"].is<uint32_t>()) tray.skipMask = doc["skipMask"].as<uint32_t>();
+    return tray;
+}
+
+//* ************************************************************************
+//* *************************** RECIPE LOADING *****************************
+//* ************************************************************************
+// LOAD_RECIPE takes the flat keys written by tools/recipe_optimizer (the
+// dashboard SETTING: names), plus an optional traySlot. Keys that are
+// missing are left unchanged.
+
+struct RecipeFloatField {
+    const char* key;
+    void (PaintingSettings::*setter)(float);
+};
+
+struct RecipeSpeedField {
+    const char* key;
+    void (PaintingSettings::*setter)(int);
+};
+
+static const RecipeFloatField kRecipeFloatFields[] = {
+    { "side1StartX", &PaintingSettings::setSide1StartX }, { "side1StartY", &PaintingSettings::setSide1StartY },
+    { "side2StartX", &PaintingSettings::setSide2StartX }, { "side2StartY", &PaintingSettings::setSide2StartY },
+    { "side3StartX", &PaintingSettings::setSide3StartX }, { "side3StartY", &PaintingSettings::setSide3StartY },
+    { "side4StartX", &PaintingSettings::setSide4StartX }, { "side4StartY", &PaintingSettings::setSide4StartY },
+    { "side1ZHeight", &PaintingSettings::setSide1ZHeight }, { "side2ZHeight", &PaintingSettings::setSide2ZHeight },
+    { "side3ZHeight", &PaintingSettings::setSide3ZHeight }, { "side4ZHeight", &PaintingSettings::setSide4ZHeight },
+    { "side1SideZHeight", &PaintingSettings::setSide1SideZHeight }, { "side2SideZHeight", &PaintingSettings::setSide2SideZHeight },
+    { "side3SideZHeight", &PaintingSettings::setSide3SideZHeight }, { "side4SideZHeight", &PaintingSettings::setSide4SideZHeight },
+    { "side1SweepY", &PaintingSettings::setSide1SweepY }, { "side2SweepY", &PaintingSettings::setSide2SweepY },
+    { "side3SweepY", &PaintingSettings::setSide3SweepY }, { "side4SweepY", &PaintingSettings::setSide4SweepY },
+    { "side1ShiftX", &PaintingSettings::setSide1ShiftX }, { "side2ShiftX", &PaintingSettings::setSide2ShiftX },
+    { "side3ShiftX", &PaintingSettings::setSide3ShiftX }, { "side4ShiftX", &PaintingSettings::setSide4ShiftX },
+};
+
+static const RecipeSpeedField kRecipeSpeedFields[] = {
+    { "side1PaintingXSpeed", &PaintingSettings::setSide1PaintingXSpeed }, { "side1PaintingYSpeed", &PaintingSettings::setSide1PaintingYSpeed },
+    { "side2PaintingXSpeed", &PaintingSettings::setSide2PaintingXSpeed }, { "side2PaintingYSpeed", &PaintingSettings::setSide2PaintingYSpeed },
+    { "side3PaintingXSpeed", &PaintingSettings::setSide3PaintingXSpeed }, { "side3PaintingYSpeed", &PaintingSettings::setSide3PaintingYSpeed },
+    { "side4PaintingXSpeed", &PaintingSettings::setSide4PaintingXSpeed }, { "side4PaintingYSpeed", &PaintingSettings::setSide4PaintingYSpeed },
+};
+
+// Returns the number of settings applied (in memory only)
+static int applyRecipeFromJson(JsonDocument& doc) {
+    int applied = 0;
+    for (const RecipeFloatField& field : kRecipeFloatFields) {
+        if (doc[field.key].is<float>()) {
+            (paintingSettings.*field.setter)(doc[field.key].as<float>());
+            applied++;
+        }
+    }
+    for (const RecipeSpeedField& field : kRecipeSpeedFields) {
+        if (doc[field.key].is<float>()) {
+            long speed = lroundf(doc[field.key].as<float>());
+            if (speed <= 0) {
+                Serial.printf("LOAD_RECIPE: ignoring %s=%ld (must be positive)\n", field.key, speed);
+                continue;
+            }
+            (paintingSettings.*field.setter)((int)speed);
+            applied++;
+        }
+    }
+    // A recipe may name the tray type it was written for
+    if (doc["traySlot"].is<int>()) {
+        int slot = doc["traySlot"].as<int>();
+        if (slot != getActiveTraySlot() && !selectTraySlot(slot)) {
+            Serial.printf("LOAD_RECIPE: ignoring traySlot=%d (must be 0-%d)\n", slot, TRAY_DEFINITION_SLOTS - 1);
+        } else {
+            applied++;
+        }
+    }
+    return applied;
+}
+
 //* ************************************************************************
 //* ************************* WEB DASHBOARD ***************************
 //* ************************************************************************
@@ -293,6 +413,58 @@ void processWebCommand(WebSocketsServer* webSocket, uint8_t num, String commandP
                 webSocket->sendTXT(num, output);
                 Serial.println("Sent current PNP settings to client after update.");
                 return; // Command processed
+            } else if (json_command_field.equalsIgnoreCase("LOAD_RECIPE")) {
+                //! Never change a pattern underneath a running job
+                if (isActivePainting) {
+                    webSocket->sendTXT(num, "CMD_ERROR: Cannot load a recipe while painting");
+                    return;
+                }
+                int applied = applyRecipeFromJson(doc);
+                if (applied == 0) {
+                    webSocket->sendTXT(num, "CMD_ERROR: LOAD_RECIPE contained no recipe settings");
+                    return;
+                }
+                paintingSettings.saveSettings();
+                Serial.printf("LOAD_RECIPE: applied and saved %d painting settings\n", applied);
+                webSocket->sendTXT(num, "CMD_ACK: Recipe loaded (" + String(applied) + " settings)");
+                // Fall through so every client sees the new values
+                commandToProcess = "GET_PAINT_SETTINGS";
+            } else if (json_command_field.equalsIgnoreCase("SET_TRAY")) {
+                // {"command":"SET_TRAY","slot":1,"rows":4,"cols":3,"originX":..,"pitchX":..,"skipMask":0,...}
+                int slot = doc["slot"].is<int>() ? doc["slot"].as<int>() : getActiveTraySlot();
+                if (slot < 0 || slot >= TRAY_DEFINITION_SLOTS) {
+                    webSocket->sendTXT(num, "CMD_ERROR: Tray slot must be 0-" + String(TRAY_DEFINITION_SLOTS - 1));
+                    return;
+                }
+                if (isActivePainting && slot == getActiveTraySlot()) {
+                    webSocket->sendTXT(num, "CMD_ERROR: Cannot change the active tray while painting");
+                    return;
+                }
+                if (!setTrayDefinition(slot, trayDefinitionFromJson(doc, slot))) {
+                    webSocket->sendTXT(num, "CMD_ERROR: Tray definition rejected (see serial log)");
+                    return;
+                }
+                webSocket->sendTXT(num, "CMD_ACK: Tray " + String(slot) + " saved");
+                broadcastTrayDefinition(webSocket, slot);
+                return; // Command processed
+            } else if (json_command_field.equalsIgnoreCase("JOB_ADD")) {
+                // {"command":"JOB_ADD","type":"paint|pnp|clean","coats":3,"delay":30,"traySlot":-1,"priority":0}
+                QueuedJob job = { 0, QUEUED_JOB_PAINT, 0, 1, g_interCoatDelaySeconds, -1 };
+                if (doc["type"].is<const char*>() && !parseQueuedJobType(doc["type"].as<String>(), job.type)) {
+                    webSocket->sendTXT(num, "CMD_ERROR: Job type must be paint, pnp or clean");
+                    return;
+                }
+                if (doc["coats"].is<int>()) job.coats = doc["coats"].as<int>();
+                if (doc["delay"].is<int>()) job.flashOffSeconds = doc["delay"].as<int>();
+                if (doc["traySlot"].is<int>()) job.traySlot = doc["traySlot"].as<int>();
+                if (doc["priority"].is<int>()) job.priority = doc["priority"].as<int>();
+                int id = enqueueJob(job);
+                if (id < 0) {
+                    webSocket->sendTXT(num, "CMD_ERROR: Job queue full (" + String(JOB_QUEUE_CAPACITY) + " jobs)");
+                } else {
+                    webSocket->sendTXT(num, "CMD_ACK: Job " + String(id) + " queued");
+                }
+                return; // Command processed
             } else if (json_command_field.equalsIgnoreCase("GET_PNP_SETTINGS")) {
                 JsonDocument settings_doc;
                 settings_doc["event"] = "pnp_settings";
@@ -386,10 +558,7 @@ void processWebCommand(WebSocketsServer* webSocket, uint8_t num, String commandP
         // Trigger homing state
         if (stateMachine) {
             // Force stop any running motors first
-            if (stepperX->isRunning()) stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-            if (stepperY_Left->isRunning()) stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-            if (stepperY_Right->isRunning()) stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-            if (stepperZ->isRunning()) stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
+            stopAllAxes();
             
             // Set the home command received flag to interrupt any ongoing painting operations
             homeCommandReceived = true;
@@ -666,6 +835,236 @@ void processWebCommand(WebSocketsServer* webSocket, uint8_t num, String commandP
         Serial.println(millis());
         return;
     }
+    else if (baseCommandAction == "SET_FEED_OVERRIDE") {
+        // Allowed in any state - takes effect on the running sweep and all following ones
+        if (valueStr.length() == 0) {
+            webSocket->sendTXT(num, "CMD_ERROR: SET_FEED_OVERRIDE requires a percent value");
+            return;
+        }
+        int applied = setFeedOverridePercent(valueStr.toInt());
+        String overrideMsg = "FEED_OVERRIDE:";
+        overrideMsg += applied;
+        webSocket->sendTXT(num, "CMD_ACK: Feed override set");
+        webSocket->broadcastTXT(overrideMsg);
+    }
+    else if (baseCommandAction == "GET_FEED_OVERRIDE") {
+        String overrideMsg = "FEED_OVERRIDE:";
+        overrideMsg += getFeedOverridePercent();
+        webSocket->sendTXT(num, overrideMsg);
+    }
+    else if (baseCommandAction == "STOP_LATENCY_MODE") {
+        // STOP_LATENCY_MODE:1 enables, STOP_LATENCY_MODE:0 disables
+        bool enable = valueStr.toInt() != 0;
+        setStopLatencyMeasurement(enable);
+        webSocket->sendTXT(num, enable ? "CMD_ACK: Stop latency measurement enabled" : "CMD_ACK: Stop latency measurement disabled");
+    }
+    else if (baseCommandAction == "SET_GANTRY_SQUARING") {
+        // SET_GANTRY_SQUARING:<steps> - Y_Right correction applied after homing
+        setGantrySquaringOffset(valueStr.toInt());
+        String ackMsg = "CMD_ACK: Gantry squaring offset set to ";
+        ackMsg += getGantrySquaringOffset();
+        ackMsg += " steps (applied at next homing)";
+        webSocket->sendTXT(num, ackMsg);
+    }
+    else if (baseCommandAction == "CAPTURE_GANTRY_SQUARING") {
+        // CAPTURE_GANTRY_SQUARING - the gantry was square at the last homing; cancel its skew from now on
+        if (captureGantrySquaringFromSkew()) {
+            String ackMsg = "CMD_ACK: Gantry squaring offset captured: ";
+            ackMsg += getGantrySquaringOffset();
+            ackMsg += " steps";
+            webSocket->sendTXT(num, ackMsg);
+        } else {
+            webSocket->sendTXT(num, "CMD_ERROR: Last homing skew is beyond the squaring bound");
+        }
+    }
+    else if (baseCommandAction == "GET_GANTRY_STATUS") {
+        // GANTRY_STATUS:<last homing skew>,<squaring offset>,<current Y_Left - Y_Right>
+        String statusMsg = "GANTRY_STATUS:";
+        statusMsg += getLastGantryHomingSkew();
+        statusMsg += ",";
+        statusMsg += getGantrySquaringOffset();
+        statusMsg += ",";
+        statusMsg += stepperY_Left->getCurrentPosition() - stepperY_Right->getCurrentPosition();
+        webSocket->sendTXT(num, statusMsg);
+    }
+    else if (baseCommandAction == "SET_VERIFY_HOME") {
+        // SET_VERIFY_HOME:1/0 - end jobs with a verify-home instead of a full homing cycle
+        setVerifyHomeAfterJobs(valueStr.toInt() != 0);
+        webSocket->sendTXT(num, isVerifyHomeAfterJobsEnabled() ? "CMD_ACK: Verify home after jobs enabled"
+                                                               : "CMD_ACK: Verify home after jobs disabled");
+    }
+    else if (baseCommandAction == "DRY_RUN") {
+        // DRY_RUN:<side 1-4, 0 or empty = all sides> - compile only, motors never move
+        int side = valueStr.toInt();
+        if (side < TOOLPATH_ALL_SIDES || side > TOOLPATH_SIDE_COUNT) {
+            webSocket->sendTXT(num, "CMD_ERROR: DRY_RUN side must be 0-4");
+        } else {
+            broadcastToolpathDryRun(side);
+            webSocket->sendTXT(num, "CMD_ACK: Toolpath dry run sent");
+        }
+    }
+    else if (baseCommandAction == "SET_GUN_LATENCY") {
+        // SET_GUN_LATENCY:<open ms>,<close ms>
+        float openMs, closeMs;
+        if (sscanf(valueStr.c_str(), "%f,%f", &openMs, &closeMs) != 2) {
+            webSocket->sendTXT(num, "CMD_ERROR: SET_GUN_LATENCY needs <open ms>,<close ms>");
+        } else {
+            setGunLatency(0, openMs, closeMs);
+            webSocket->sendTXT(num, "CMD_ACK: Gun latency updated");
+            broadcastGunLatency(webSocket);
+        }
+    }
+    else if (baseCommandAction == "GET_GUN_LATENCY") {
+        broadcastGunLatency(webSocket);
+    }
+    else if (baseCommandAction == "SET_GUN_MIN_PULSE") {
+        // SET_GUN_MIN_PULSE:<ms> - shortest closed time before the gun may reopen
+        setPaintGunMinPulseUs((unsigned long)(max(value1, 0.0f) * 1000.0f));
+        String ackMsg = "CMD_ACK: Gun minimum pulse set to ";
+        ackMsg += String(getPaintGunMinPulseUs() / 1000.0f, 1);
+        ackMsg += " ms";
+        webSocket->sendTXT(num, ackMsg);
+    }
+    else if (baseCommandAction == "SET_TRAY_GUN_WINDOWS") {
+        // SET_TRAY_GUN_WINDOWS:1/0 - close the gun over the gaps between tray parts
+        setTrayGunWindowsEnabled(valueStr.toInt() != 0);
+        webSocket->sendTXT(num, areTrayGunWindowsEnabled() ? "CMD_ACK: Tray gun windows enabled"
+                                                           : "CMD_ACK: Tray gun windows disabled");
+    }
+    else if (baseCommandAction == "JOB_CANCEL") {
+        // JOB_CANCEL:<id> - removes a waiting job
+        if (cancelJob(valueStr.toInt())) {
+            webSocket->sendTXT(num, "CMD_ACK: Job " + valueStr + " cancelled");
+        } else {
+            webSocket->sendTXT(num, "CMD_ERROR: No waiting job " + valueStr);
+        }
+    }
+    else if (baseCommandAction == "JOB_MOVE" || baseCommandAction == "JOB_PRIORITY") {
+        // JOB_MOVE:<id>,<index> (0 = front) / JOB_PRIORITY:<id>,<0-9>
+        int id, value;
+        if (sscanf(valueStr.c_str(), "%d,%d", &id, &value) != 2) {
+            webSocket->sendTXT(num, "CMD_ERROR: " + baseCommandAction + " needs <id>,<value>");
+        } else if (baseCommandAction == "JOB_MOVE" ? moveJob(id, value) : setJobPriority(id, value)) {
+            webSocket->sendTXT(num, "CMD_ACK: Job " + String(id) + " updated");
+        } else {
+            webSocket->sendTXT(num, "CMD_ERROR: No waiting job " + String(id));
+        }
+    }
+    else if (baseCommandAction == "JOB_QUEUE_RUN") {
+        // JOB_QUEUE_RUN:1/0 - start queued jobs whenever the machine is idle, or hold them
+        setJobQueueRunning(valueStr.toInt() != 0);
+        webSocket->sendTXT(num, isJobQueueRunning() ? "CMD_ACK: Job queue running" : "CMD_ACK: Job queue held");
+    }
+    else if (baseCommandAction == "SET_CLEAN_EVERY_JOBS") {
+        // SET_CLEAN_EVERY_JOBS:<k> - cleaning cycle after every k paint jobs, 0 = never
+        setCleanEveryJobs(valueStr.toInt());
+        webSocket->sendTXT(num, "CMD_ACK: Clean every " + String(getCleanEveryJobs()) + " job(s)");
+    }
+    else if (baseCommandAction == "GET_JOB_QUEUE") {
+        String queueMsg = "JOB_QUEUE:" + describeJobQueue();
+        webSocket->broadcastTXT(queueMsg);
+    }
+    else if (baseCommandAction == "GET_PHASE_STATS") {
+        // GET_PHASE_STATS - per-phase means over past jobs and the rolling span histograms
+        broadcastPhaseStats();
+    }
+    else if (baseCommandAction == "RESET_PHASE_STATS") {
+        resetPhaseStats();
+        webSocket->sendTXT(num, "CMD_ACK: Phase stats reset");
+    }
+    else if (baseCommandAction == "GET_LOOP_PROFILE") {
+        // GET_LOOP_PROFILE - loop period and per-subsystem time histograms, sent from the end of loop()
+        requestLoopProfileReport();
+    }
+    else if (baseCommandAction == "RESET_LOOP_PROFILE") {
+        resetLoopProfile();
+        webSocket->sendTXT(num, "CMD_ACK: Loop profile reset");
+    }
+    else if (baseCommandAction == "SET_DRYING_JOBS") {
+        // SET_DRYING_JOBS:<mask> - 1 = clean, 2 = tip inspect, 4 = pre-home during inter-coat drying
+        setDryingJobMask(valueStr.toInt());
+        String ackMsg = "CMD_ACK: Drying jobs mask ";
+        ackMsg += getDryingJobMask();
+        webSocket->sendTXT(num, ackMsg);
+    }
+    else if (baseCommandAction == "SET_PNP_FAR_ROWS_FIRST") {
+        // SET_PNP_FAR_ROWS_FIRST:1/0 - fill the rows farthest from the pick location first
+        setPnPFarRowsFirst(valueStr.toInt() != 0);
+        webSocket->sendTXT(num, isPnPFarRowsFirst() ? "CMD_ACK: PnP far rows first enabled"
+                                                    : "CMD_ACK: PnP far rows first disabled");
+    }
+    else if (baseCommandAction == "SET_TRAY_OCCUPANCY") {
+        // SET_TRAY_OCCUPANCY:1111100000 - one digit per PnP position, 1 = part present
+        uint32_t mask;
+        if (!parseTrayOccupancy(valueStr, mask)) {
+            String errorMsg = "CMD_ERROR: Tray occupancy needs ";
+            errorMsg += getTrayPositionCount();
+            errorMsg += " digits of 1/0";
+            webSocket->sendTXT(num, errorMsg);
+        } else if (isActivePainting) {
+            webSocket->sendTXT(num, "CMD_ERROR: Cannot change tray occupancy while painting");
+        } else {
+            setTrayOccupancy(mask);
+            webSocket->sendTXT(num, "CMD_ACK: Tray occupancy set");
+            broadcastTrayOccupancy(webSocket);
+        }
+    }
+    else if (baseCommandAction == "GET_TRAY_OCCUPANCY") {
+        broadcastTrayOccupancy(webSocket);
+    }
+    else if (baseCommandAction == "SELECT_TRAY") {
+        // SELECT_TRAY:<slot> - switch tray type; occupancy resets to a full tray
+        int slot = valueStr.toInt();
+        if (stateMachine && stateMachine->getCurrentState() != stateMachine->getIdleState()) {
+            webSocket->sendTXT(num, "CMD_ERROR: Machine not in IDLE state.");
+        } else if (!selectTraySlot(slot)) {
+            webSocket->sendTXT(num, "CMD_ERROR: Tray slot must be 0-" + String(TRAY_DEFINITION_SLOTS - 1));
+        } else {
+            webSocket->sendTXT(num, "CMD_ACK: Tray " + String(slot) + " selected");
+            broadcastTrayDefinition(webSocket, slot);
+            broadcastTrayOccupancy(webSocket);
+        }
+    }
+    else if (baseCommandAction == "GET_TRAY") {
+        // GET_TRAY or GET_TRAY:<slot>
+        int slot = (valueStr.length() > 0) ? valueStr.toInt() : getActiveTraySlot();
+        broadcastTrayDefinition(webSocket, constrain(slot, 0, TRAY_DEFINITION_SLOTS - 1));
+    }
+    else if (baseCommandAction == "GET_PNEUMATIC_TIMING") {
+        // PNEUMATIC_TIMING:<step>=<ms>,<switch|configured>,<last confirm ms>;...
+        String timingMsg = "PNEUMATIC_TIMING:" + describePneumaticTiming();
+        webSocket->broadcastTXT(timingMsg);
+    }
+    else if (baseCommandAction == "GUN_LATENCY_COMPENSATION") {
+        // GUN_LATENCY_COMPENSATION:1/0 - not persisted
+        setGunLatencyCompensation(valueStr.toInt() != 0);
+        webSocket->sendTXT(num, isGunLatencyCompensationEnabled() ? "CMD_ACK: Gun latency compensation enabled"
+                                                                  : "CMD_ACK: Gun latency compensation disabled");
+    }
+    else if (baseCommandAction == "CALIBRATE_GUN_LATENCY") {
+        // Paints two test stripes from the current position; measure them and send GUN_LATENCY_FROM_STRIPES
+        if (stateMachine && stateMachine->getCurrentState() != stateMachine->getIdleState()) {
+            webSocket->sendTXT(num, "CMD_ERROR: Machine not in IDLE state.");
+        } else if (paintGunCalibrationStripes()) {
+            webSocket->sendTXT(num, "CMD_ACK: Calibration stripes painted");
+        } else {
+            webSocket->sendTXT(num, "CMD_ERROR: Calibration stripes not painted");
+        }
+    }
+    else if (baseCommandAction == "GUN_LATENCY_FROM_STRIPES") {
+        // GUN_LATENCY_FROM_STRIPES:<slow start>,<slow end>,<fast start>,<fast end> (inches, shared datum)
+        float slowStart, slowEnd, fastStart, fastEnd;
+        GunLatency estimate;
+        if (sscanf(valueStr.c_str(), "%f,%f,%f,%f", &slowStart, &slowEnd, &fastStart, &fastEnd) != 4) {
+            webSocket->sendTXT(num, "CMD_ERROR: GUN_LATENCY_FROM_STRIPES needs 4 edge positions");
+        } else if (!estimateGunLatencyFromStripes(slowStart, slowEnd, fastStart, fastEnd, estimate)) {
+            webSocket->sendTXT(num, "CMD_ERROR: Stripe measurements give an implausible latency");
+        } else {
+            setGunLatency(0, estimate.openMs, estimate.closeMs);
+            webSocket->sendTXT(num, "CMD_ACK: Gun latency calibrated");
+            broadcastGunLatency(webSocket);
+        }
+    }
     else if (baseCommandAction == "MOVE_Z_PREVIEW") {
         float z_pos_inch = value1;
         long z_pos_steps = (long)(z_pos_inch * STEPS_PER_INCH_XYZ);
@@ -1347,6 +1746,8 @@ void processWebSocketEvents() {
 // This function processes WebSocket events more aggressively and should be called
 // frequently during long-running operations to ensure immediate command processing
 void processWebSocketEventsFrequently() {
+  uint32_t pumpStartUs = micros();
+  flushPaintGunTelemetry(); // Deferred gun logging/broadcasts from the sweep in progress
   // Process WebSocket events more aggressively
   for (int i = 0; i < 50; i++) {
     webSocket.loop();
@@ -1354,6 +1755,7 @@ void processWebSocketEventsFrequently() {
       delay(1); // Small delay every 10 iterations
     }
   }
+  loopProfileMark(LOOP_PROFILE_WS_PUMP, pumpStartUs);
 }
 
 // Function to check for HOME command during painting operations
@@ -1365,6 +1767,14 @@ extern FastAccelStepper *stepperY_Right;
 extern FastAccelStepper *stepperZ;
 
 bool checkForHomeCommand() {
+  // Finish any stop raised by the stop-input interrupt
+  serviceStopAll();
+
+  // A latched limit fault aborts the operation (the service moves to ErrorState)
+  if (serviceLimitSwitches()) {
+    return true;
+  }
+
   // Process any pending WebSocket events using enhanced processing
   processWebSocketEventsFrequently();
   
@@ -1373,10 +1783,7 @@ bool checkForHomeCommand() {
     Serial.println("WEBSOCKET HOME command received - immediately aborting all operations");
     
     // IMMEDIATELY stop all motors
-    if (stepperX->isRunning()) stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-    if (stepperY_Left->isRunning()) stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-    if (stepperY_Right->isRunning()) stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-    if (stepperZ->isRunning()) stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
+    stopAllAxes();
     
     // If we have a state machine, immediately change to homing state
     if (stateMachine) {
@@ -1393,10 +1800,7 @@ bool checkForHomeCommand() {
     Serial.println("PHYSICAL HOME button pressed - immediately aborting all operations");
     
     // IMMEDIATELY stop all motors
-    if (stepperX->isRunning()) stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-    if (stepperY_Left->isRunning()) stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-    if (stepperY_Right->isRunning()) stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-    if (stepperZ->isRunning()) stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
+    stopAllAxes();
     
     // If we have a state machine, immediately change to homing state
     if (stateMachine) {
@@ -1423,6 +1827,14 @@ bool checkForPauseCommand() {
     lastCheckTime = currentTime;
   }
 
+  // Finish any stop raised by the stop-input interrupt
+  serviceStopAll();
+
+  // A latched limit fault aborts the operation (the service moves to ErrorState)
+  if (serviceLimitSwitches()) {
+    return true;
+  }
+
   // Process any pending WebSocket events first using the enhanced function
   processWebSocketEventsFrequently();
   
@@ -1454,10 +1866,7 @@ bool checkForPauseCommand() {
     Serial.println("PHYSICAL HOME button pressed during painting - immediately stopping all motors");
     
     // IMMEDIATELY stop all motors
-    if (stepperX->isRunning()) stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-    if (stepperY_Left->isRunning()) stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-    if (stepperY_Right->isRunning()) stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-    if (stepperZ->isRunning()) stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
+    stopAllAxes();
     
     return true;
   }
@@ -0,0 +1,178 @@
+#include "hardware/GunLatency.h"
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+#include <WebSocketsServer.h>
+#include "utils/settings.h"
+#include "motors/PaintSweep.h"
+#include "motors/XYZ_Movements.h"
+#include "motors/LimitSwitches.h"
+#include "storage/Persistence.h"
+
+extern FastAccelStepper *stepperX;
+extern FastAccelStepper *stepperY_Left;
+extern FastAccelStepper *stepperZ;
+extern WebSocketsServer webSocket;
+
+// NVS keys get the gun index appended ("gunOnLat0")
+#define GUN_OPEN_LATENCY_KEY "gunOnLat"
+#define GUN_CLOSE_LATENCY_KEY "gunOffLat"
+
+static GunLatency g_gunLatency[PAINT_GUN_COUNT];
+static bool g_gunLatencyCompensation = true;
+static long g_lastCalibrationSlowHz = GUN_CALIBRATION_SLOW_SPEED;
+static long g_lastCalibrationFastHz = GUN_CALIBRATION_FAST_SPEED;
+
+static int clampGunIndex(int gun) {
+    return constrain(gun, 0, PAINT_GUN_COUNT - 1);
+}
+
+//* ************************************************************************
+//* ***************************** SETTINGS *********************************
+//* ************************************************************************
+
+const GunLatency& getGunLatency(int gun) {
+    return g_gunLatency[clampGunIndex(gun)];
+}
+
+void setGunLatency(int gun, float openMs, float closeMs) {
+    gun = clampGunIndex(gun);
+    g_gunLatency[gun].openMs = constrain(openMs, 0.0f, GUN_LATENCY_MAX_MS);
+    g_gunLatency[gun].closeMs = constrain(closeMs, 0.0f, GUN_LATENCY_MAX_MS);
+
+    String openKey = String(GUN_OPEN_LATENCY_KEY) + gun;
+    String closeKey = String(GUN_CLOSE_LATENCY_KEY) + gun;
+    persistence.beginTransaction(false);
+    persistence.saveFloat(openKey.c_str(), g_gunLatency[gun].openMs);
+    persistence.saveFloat(closeKey.c_str(), g_gunLatency[gun].closeMs);
+    persistence.endTransaction();
+    Serial.printf("Gun %d latency set: open %.1f ms, close %.1f ms\n",
+                  gun, g_gunLatency[gun].openMs, g_gunLatency[gun].closeMs);
+}
+
+void loadGunLatencyFromNVS() {
+    persistence.beginTransaction(true);
+    for (int gun = 0; gun < PAINT_GUN_COUNT; gun++) {
+        String openKey = String(GUN_OPEN_LATENCY_KEY) + gun;
+        String closeKey = String(GUN_CLOSE_LATENCY_KEY) + gun;
+        g_gunLatency[gun].openMs = persistence.loadFloat(openKey.c_str(), DEFAULT_GUN_OPEN_LATENCY_MS);
+        g_gunLatency[gun].closeMs = persistence.loadFloat(closeKey.c_str(), DEFAULT_GUN_CLOSE_LATENCY_MS);
+        Serial.printf("Gun %d latency loaded: open %.1f ms, close %.1f ms\n",
+                      gun, g_gunLatency[gun].openMs, g_gunLatency[gun].closeMs);
+    }
+    persistence.endTransaction();
+}
+
+long gunLeadSteps(float latencyMs, long speedHz) {
+    if (!g_gunLatencyCompensation || latencyMs <= 0.0f || speedHz <= 0) {
+        return 0;
+    }
+    return (long)((float)speedHz * latencyMs / 1000.0f);
+}
+
+void setGunLatencyCompensation(bool enabled) {
+    g_gunLatencyCompensation = enabled;
+    Serial.printf("Gun latency compensation %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool isGunLatencyCompensationEnabled() {
+    return g_gunLatencyCompensation;
+}
+
+//* ************************************************************************
+//* **************************** CALIBRATION *******************************
+//* ************************************************************************
+
+bool estimateGunLatency(long slowSpeedHz, float slowStartInch, float slowEndInch,
+                        long fastSpeedHz, float fastStartInch, float fastEndInch, GunLatency& result) {
+    float speedDifference = (float)(fastSpeedHz - slowSpeedHz) / STEPS_PER_INCH_XYZ; // inches/sec
+    if (speedDifference <= 0.0f) {
+        Serial.println("Gun latency estimate: fast stripe must be faster than the slow stripe");
+        return false;
+    }
+    result.openMs = (fastStartInch - slowStartInch) / speedDifference * 1000.0f;
+    result.closeMs = (fastEndInch - slowEndInch) / speedDifference * 1000.0f;
+    Serial.printf("Gun latency estimate: open %.1f ms, close %.1f ms (speed difference %.2f in/s)\n",
+                  result.openMs, result.closeMs, speedDifference);
+
+    //? A faster stripe that starts or ends earlier means the measurements were swapped or misread
+    if (result.openMs < 0.0f || result.closeMs < 0.0f ||
+        result.openMs > GUN_LATENCY_MAX_MS || result.closeMs > GUN_LATENCY_MAX_MS) {
+        Serial.printf("Gun latency estimate rejected: outside 0-%.0f ms\n", GUN_LATENCY_MAX_MS);
+        return false;
+    }
+    return true;
+}
+
+bool estimateGunLatencyFromStripes(float slowStartInch, float slowEndInch,
+                                   float fastStartInch, float fastEndInch, GunLatency& result) {
+    return estimateGunLatency(g_lastCalibrationSlowHz, slowStartInch, slowEndInch,
+                              g_lastCalibrationFastHz, fastStartInch, fastEndInch, result);
+}
+
+bool paintGunCalibrationStripes() {
+    if (isLimitFaultLatched()) {
+        Serial.println("Gun calibration skipped - limit fault latched");
+        return false;
+    }
+
+    //! Both stripes share the commanded gun edges; the run-up lets the fast stripe reach speed first.
+    //! runPaintSweep applies the feed override itself, so the sweeps get the raw speeds and
+    //! slowHz/fastHz are what the axis actually runs at
+    int overridePercent = getFeedOverridePercent();
+    long slowHz = applyFeedOverride(GUN_CALIBRATION_SLOW_SPEED);
+    long fastHz = applyFeedOverride(GUN_CALIBRATION_FAST_SPEED);
+    float runUpInch = ((float)fastHz * (float)fastHz) / (2.0f * DEFAULT_X_ACCEL) / STEPS_PER_INCH_XYZ
+                      + PAUSE_RESUME_LEAD_IN_MARGIN_INCH;
+    long startX = stepperX->getCurrentPosition();
+    long startY = stepperY_Left->getCurrentPosition();
+    long startZ = stepperZ->getCurrentPosition();
+    long endX = startX + (long)((2.0f * runUpInch + GUN_CALIBRATION_STRIPE_INCH) * STEPS_PER_INCH_XYZ);
+    long fastY = startY + (long)(GUN_CALIBRATION_STRIPE_SPACING_INCH * STEPS_PER_INCH_XYZ);
+
+    if (endX > (long)(X_MAX_TRAVEL_POS_INCH * STEPS_PER_INCH_XYZ) ||
+        fastY > (long)(Y_MAX_TRAVEL_POS_INCH * STEPS_PER_INCH_XYZ)) {
+        Serial.printf("Gun calibration needs %.1f in of +X and %.1f in of +Y travel from the current position\n",
+                      (endX - startX) / STEPS_PER_INCH_XYZ, GUN_CALIBRATION_STRIPE_SPACING_INCH);
+        return false;
+    }
+
+    bool wasCompensating = g_gunLatencyCompensation;
+    g_gunLatencyCompensation = false;
+    g_lastCalibrationSlowHz = slowHz;
+    g_lastCalibrationFastHz = fastHz;
+    Serial.printf("Gun calibration: stripes at %ld and %ld Hz, gun %.2f-%.2f in\n", slowHz, fastHz,
+                  startX / STEPS_PER_INCH_XYZ + runUpInch, endX / STEPS_PER_INCH_XYZ - runUpInch);
+
+    bool completed = runPaintSweep(makePaintSweep(SWEEP_AXIS_X, startX, endX, GUN_CALIBRATION_SLOW_SPEED,
+                                                  runUpInch, runUpInch, "GunCalibration"));
+    if (completed) {
+        moveToXYZ(startX, DEFAULT_X_SPEED, fastY, DEFAULT_Y_SPEED, startZ, DEFAULT_Z_SPEED);
+        completed = runPaintSweep(makePaintSweep(SWEEP_AXIS_X, startX, endX, GUN_CALIBRATION_FAST_SPEED,
+                                                 runUpInch, runUpInch, "GunCalibration"));
+    }
+    if (completed) {
+        moveToXYZ(startX, DEFAULT_X_SPEED, startY, DEFAULT_Y_SPEED, startZ, DEFAULT_Z_SPEED);
+    }
+    g_gunLatencyCompensation = wasCompensating;
+    if (!completed) {
+        Serial.println("Gun calibration aborted");
+        return false;
+    }
+    //? The stripe speeds would no longer match slowHz/fastHz
+    if (getFeedOverridePercent() != overridePercent) {
+        Serial.println("Gun calibration invalid: feed override changed during the stripes - run it again");
+        webSocket.broadcastTXT("GUN_CALIBRATION:INVALID");
+        return false;
+    }
+
+    String message = "GUN_CALIBRATION:";
+    message += slowHz;
+    message += ",";
+    message += fastHz;
+    message += ",";
+    message += String(startX / STEPS_PER_INCH_XYZ + runUpInch, 2);
+    message += ",";
+    message += String(endX / STEPS_PER_INCH_XYZ - runUpInch, 2);
+    webSocket.broadcastTXT(message);
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "hardware/Pneumatics.h"
+#include <Arduino.h>
+#include "utils/settings.h"
+#include "hardware/cylinder_Functions.h"
+#include "hardware/vacuum_Functions.h"
+
+struct PneumaticStepConfig {
+    const char* name;
+    unsigned long ceilingMs;  // Configured worst case
+    int feedbackPin;          // -1 if this step has no switch
+    int confirmedLevel;       // Switch reading that ends the step
+};
+
+static const PneumaticStepConfig kPneumaticSteps[PNEUMATIC_STEP_COUNT] = {
+    { "pick extend",   PNP_PICK_DELAY_AFTER_CYLINDER_EXTEND,  PICK_CYLINDER_DOWN_SENSOR_PIN, LOW  },
+    { "pick grip",     PNP_PICK_DELAY_AFTER_VACUUM_ON + 50,   VACUUM_SWITCH_PIN,             LOW  },
+    { "pick retract",  PNP_CYLINDER_CLEAR_MS,                 -1,                            LOW  },
+    { "place extend",  PNP_PLACE_DELAY_AFTER_CYLINDER_EXTEND, PICK_CYLINDER_DOWN_SENSOR_PIN, LOW  },
+    { "place release", PNP_PLACE_DELAY_AFTER_VACUUM_OFF,      VACUUM_SWITCH_PIN,             HIGH },
+    { "place retract", PNP_CYLINDER_CLEAR_MS,                 -1,                            LOW  },
+};
+
+// Step in progress
+static PneumaticStep g_activeStep = PNEUMATIC_PICK_EXTEND;
+static unsigned long g_stepStartMs = 0;
+static unsigned long g_confirmedAtMs = 0;     // 0 = switch not confirmed yet
+static unsigned long g_lastConfirmMs[PNEUMATIC_STEP_COUNT]; // Most recent switch confirmation (ms), 0 = none
+static PneumaticStepStatus g_stepStatus = PNEUMATIC_DONE;
+
+static bool hasFeedback(PneumaticStep step) {
+    return kPneumaticSteps[step].feedbackPin >= 0;
+}
+
+//* ************************************************************************
+//* ****************************** TIMING **********************************
+//* ************************************************************************
+
+unsigned long getPneumaticStepDelayMs(PneumaticStep step) {
+    return kPneumaticSteps[step].ceilingMs;
+}
+
+String describePneumaticTiming() {
+    String text;
+    for (int i = 0; i < PNEUMATIC_STEP_COUNT; i++) {
+        PneumaticStep step = (PneumaticStep)i;
+        if (i > 0) {
+            text += ";";
+        }
+        text += kPneumaticSteps[i].name;
+        text += "=";
+        text += getPneumaticStepDelayMs(step);
+        text += ",";
+        text += hasFeedback(step) ? "switch" : "configured";
+        text += ",";
+        text += g_lastConfirmMs[i];
+    }
+    return text;
+}
+
+//* ************************************************************************
+//* ****************************** STEPS ***********************************
+//* ************************************************************************
+
+void startPneumaticStep(PneumaticStep step) {
+    switch (step) {
+        case PNEUMATIC_PICK_EXTEND:
+        case PNEUMATIC_PLACE_EXTEND:  cylinderDown(); break;
+        case PNEUMATIC_PICK_GRIP:     vacuumOn();     break;
+        case PNEUMATIC_PLACE_RELEASE: vacuumOff();    break;
+        case PNEUMATIC_PICK_RETRACT:
+        case PNEUMATIC_PLACE_RETRACT: cylinderUp();   break;
+        default: break;
+    }
+    g_activeStep = step;
+    g_stepStartMs = millis();
+    g_confirmedAtMs = 0;
+    g_stepStatus = PNEUMATIC_BUSY;
+}
+
+PneumaticStepStatus updatePneumaticStep() {
+    if (g_stepStatus != PNEUMATIC_BUSY) {
+        return g_stepStatus;
+    }
+    const PneumaticStepConfig& config = kPneumaticSteps[g_activeStep];
+    unsigned long elapsed = millis() - g_stepStartMs;
+
+    //! No switch: nothing observable to shorten the configured delay with
+    if (!hasFeedback(g_activeStep)) {
+        if (elapsed >= getPneumaticStepDelayMs(g_activeStep)) {
+            g_stepStatus = PNEUMATIC_DONE;
+        }
+        return g_stepStatus;
+    }
+
+    if (g_confirmedAtMs == 0 && digitalRead(config.feedbackPin) == config.confirmedLevel) {
+        g_confirmedAtMs = max(1UL, elapsed);
+        g_lastConfirmMs[g_activeStep] = g_confirmedAtMs;
+    }
+    if (g_confirmedAtMs > 0) {
+        if (elapsed >= g_confirmedAtMs + PNEUMATIC_FEEDBACK_SETTLE_MS) {
+            g_stepStatus = PNEUMATIC_DONE;
+        }
+    } else if (elapsed >= config.ceilingMs * PNEUMATIC_FEEDBACK_TIMEOUT_FACTOR) {
+        Serial.printf("Pneumatics: %s not confirmed by its switch after %lu ms\n", config.name, elapsed);
+        g_stepStatus = PNEUMATIC_FAILED;
+    }
+    return g_stepStatus;
+}
+
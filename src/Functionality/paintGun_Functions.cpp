@@ -1,16 +1,67 @@
 #include <Arduino.h>
 #include "utils/settings.h" // Include settings for pin definitions
 #include "hardware/paintGun_Functions.h" // Corrected path
+#include "storage/Persistence.h"
 // #include "web_command_adapter.h" // Removing this include
 #include <WebSocketsServer.h>
 
 // External reference to the WebSocket instance in webserver.cpp
 extern WebSocketsServer webSocket;
 
-// Track the paint gun state
-bool isPaintGun_ON = false;
-unsigned long lastPaintGunToggleTime = 0;
-const unsigned long PAINT_GUN_DEBOUNCE_MS = 50; // Minimum 50ms between toggles
+#define PAINT_GUN_MIN_PULSE_KEY "gunMinPls"
+
+// Track the paint gun state (also written by the stop and limit ISRs)
+volatile bool isPaintGun_ON = false;
+volatile bool g_paintGunOpenPending = false;
+volatile unsigned long g_lastGunCloseUs = 0;
+static unsigned long g_paintGunMinPulseUs = DEFAULT_PAINT_GUN_MIN_PULSE_US;
+
+//* ************************************************************************
+//* ************************** TELEMETRY QUEUE *****************************
+//* ************************************************************************
+// Single producer and consumer, both on the loop task, so no locking.
+
+struct PaintGunEvent {
+    bool on;
+    bool held;              // Reopen was held for the minimum closed time
+    unsigned long atUs;
+};
+
+static PaintGunEvent g_gunEvents[PAINT_GUN_TELEMETRY_QUEUE_SIZE];
+static uint8_t g_gunEventHead = 0;
+static uint8_t g_gunEventCount = 0;
+static unsigned long g_gunEventsDropped = 0;
+volatile bool g_gunStatusDirty = false; // Also set by paintGun_ForceOffFromISR()
+
+static inline void queueGunEvent(bool on, bool held, unsigned long atUs) {
+    g_gunStatusDirty = true;
+    if (g_gunEventCount == PAINT_GUN_TELEMETRY_QUEUE_SIZE) {
+        g_gunEventsDropped++;
+        return;
+    }
+    uint8_t slot = (g_gunEventHead + g_gunEventCount) % PAINT_GUN_TELEMETRY_QUEUE_SIZE;
+    g_gunEvents[slot] = { on, held, atUs };
+    g_gunEventCount++;
+}
+
+void flushPaintGunTelemetry() {
+    while (g_gunEventCount > 0) {
+        const PaintGunEvent& event = g_gunEvents[g_gunEventHead];
+        Serial.printf("Paint gun %s at %lu us%s\n", event.on ? "ON" : "OFF", event.atUs,
+                      event.held ? " (reopen held for minimum pulse)" : "");
+        g_gunEventHead = (g_gunEventHead + 1) % PAINT_GUN_TELEMETRY_QUEUE_SIZE;
+        g_gunEventCount--;
+    }
+    if (g_gunEventsDropped > 0) {
+        Serial.printf("Paint gun telemetry: %lu events dropped (queue full)\n", g_gunEventsDropped);
+        g_gunEventsDropped = 0;
+    }
+    //? One status per flush - the dashboard only needs the latest state
+    if (g_gunStatusDirty) {
+        g_gunStatusDirty = false;
+        sendWebStatus(&webSocket, isPaintGun_ON ? "PAINT_GUN_STATUS:ON" : "PAINT_GUN_STATUS:OFF");
+    }
+}
 
 // Function Implementations
 /* REMOVED - Logic moved to Setup.cpp
@@ -31,58 +82,65 @@ void sendWebStatus(WebSocketsServer* webSocket, const char* message) {
     }
 }
 
+//* ************************************************************************
+//* ***************************** HOT PATH *********************************
+//* ************************************************************************
+// Pin mode is set once in Setup.cpp; these only touch the output register.
+
+static inline void openPaintGun(bool held) {
+    fastOutputHigh(PAINT_GUN_PIN);
+    isPaintGun_ON = true;
+    g_paintGunOpenPending = false;
+    queueGunEvent(true, held, micros());
+}
+
 void paintGun_OFF() {
-    // Debounce: Check if enough time has passed since last toggle
-    unsigned long currentTime = millis();
-    if (currentTime - lastPaintGunToggleTime < PAINT_GUN_DEBOUNCE_MS) {
-        // Too soon since last toggle, skip this command
-        Serial.println("Paint gun OFF command debounced (too soon)");
-        return;
-    }
-    
-    // Only proceed if paint gun is currently ON
+    g_paintGunOpenPending = false; // A held reopen is cancelled, not delayed further
     if (!isPaintGun_ON) {
-        // Already OFF, no need to send command again
         return;
     }
-    
-    pinMode(PAINT_GUN_PIN, OUTPUT);
-    digitalWrite(PAINT_GUN_PIN, LOW);
-    Serial.println("Paint gun OFF");
-    Serial.printf("Paint gun pin %d set to LOW\n", PAINT_GUN_PIN);
-    
-    // Update the state and timing
+    fastOutputLow(PAINT_GUN_PIN);
     isPaintGun_ON = false;
-    lastPaintGunToggleTime = currentTime;
-    
-    // Send status update to web clients to sync UI toggle
-    sendWebStatus(&webSocket, "PAINT_GUN_STATUS:OFF");
+    g_lastGunCloseUs = micros();
+    queueGunEvent(false, false, g_lastGunCloseUs);
 }
 
 void paintGun_ON() {
-    // Debounce: Check if enough time has passed since last toggle
-    unsigned long currentTime = millis();
-    if (currentTime - lastPaintGunToggleTime < PAINT_GUN_DEBOUNCE_MS) {
-        // Too soon since last toggle, skip this command
-        Serial.println("Paint gun ON command debounced (too soon)");
+    if (isPaintGun_ON) {
         return;
     }
-    
-    // Only proceed if paint gun is currently OFF
-    if (isPaintGun_ON) {
-        // Already ON, no need to send command again
+    if (micros() - g_lastGunCloseUs < g_paintGunMinPulseUs) {
+        g_paintGunOpenPending = true; // servicePaintGun() opens it once the valve has seated
         return;
     }
-    
-    pinMode(PAINT_GUN_PIN, OUTPUT);
-    digitalWrite(PAINT_GUN_PIN, HIGH);
-    Serial.println("Paint gun ON");
-    Serial.printf("Paint gun pin %d set to HIGH\n", PAINT_GUN_PIN);
-    
-    // Update the state and timing
-    isPaintGun_ON = true;
-    lastPaintGunToggleTime = currentTime;
-    
-    // Send status update to web clients to sync UI toggle
-    sendWebStatus(&webSocket, "PAINT_GUN_STATUS:ON");
-}
\ No newline at end of file
+    openPaintGun(false);
+}
+
+void servicePaintGun() {
+    if (g_paintGunOpenPending && micros() - g_lastGunCloseUs >= g_paintGunMinPulseUs) {
+        openPaintGun(true);
+    }
+}
+
+//* ************************************************************************
+//* ***************************** SETTINGS *********************************
+//* ************************************************************************
+
+void setPaintGunMinPulseUs(unsigned long pulseUs) {
+    g_paintGunMinPulseUs = min(pulseUs, PAINT_GUN_MIN_PULSE_MAX_US);
+    persistence.beginTransaction(false);
+    persistence.saveInt(PAINT_GUN_MIN_PULSE_KEY, (int)g_paintGunMinPulseUs);
+    persistence.endTransaction();
+    Serial.printf("Paint gun minimum pulse set to %lu us\n", g_paintGunMinPulseUs);
+}
+
+unsigned long getPaintGunMinPulseUs() {
+    return g_paintGunMinPulseUs;
+}
+
+void loadPaintGunSettingsFromNVS() {
+    persistence.beginTransaction(true);
+    g_paintGunMinPulseUs = (unsigned long)persistence.loadInt(PAINT_GUN_MIN_PULSE_KEY, (int)DEFAULT_PAINT_GUN_MIN_PULSE_US);
+    persistence.endTransaction();
+    Serial.printf("Paint gun minimum pulse loaded: %lu us\n", g_paintGunMinPulseUs);
+}
@@ -14,6 +14,14 @@
 
 // Include headers for functions called in loop
 #include "web/Web_Dashboard_Commands.h" // For runDashboardServer()
+#include "motors/StopAll.h" // For serviceStopAll()
+#include "motors/LimitSwitches.h" // For serviceLimitSwitches()
+#include "motors/GantrySync.h" // For checkGantrySync()
+#include "hardware/paintGun_Functions.h" // For servicePaintGun()
+#include "system/JobQueue.h" // For serviceJobQueue()
+#include "system/CycleEstimator.h" // For serviceCycleEstimate()
+#include "system/PhaseStats.h" // For servicePhaseStats()
+#include "system/LoopProfiler.h" // Loop period and per-subsystem timing
 // Add other headers as needed
 
 extern WebSocketsServer webSocket;
@@ -54,28 +62,50 @@ void setup() {
 }
 
 void loop() {
+  uint32_t loopStartUs = loopProfileBegin();
+  uint32_t sectionUs = loopStartUs;
+
   // Handle OTA updates
   ArduinoOTA.handle();
+  sectionUs = loopProfileMark(LOOP_PROFILE_OTA, sectionUs);
   
   // Update machine state
   // updateMachineState();
   
+  //! Finish any stop latched by the stop-all interrupt before anything else moves
+  serviceStopAll();
+  checkGantrySync();
+  serviceLimitSwitches();
+  servicePaintGun();
+  sectionUs = loopProfileMark(LOOP_PROFILE_SAFETY, sectionUs);
+
   // Update state machine
   if (stateMachine) {
     stateMachine->update();
   }
+  sectionUs = loopProfileMark(LOOP_PROFILE_STATE_UPDATE, sectionUs);
+  serviceJobQueue(); // Starts the next queued job once the machine is idle
+  serviceCycleEstimate(); // PROGRESS: broadcasts while painting
+  servicePhaseStats(); // PHASE_BREAKDOWN: once a job is back in Idle
+  sectionUs = loopProfileMark(LOOP_PROFILE_SERVICES, sectionUs);
   
   // Update control panel buttons and handle combinations
   updateControlPanelButtons();
   handleButtonCombinations();
+  sectionUs = loopProfileMark(LOOP_PROFILE_CONTROL_PANEL, sectionUs);
   
   //! Handle web server and WebSocket communication
   runDashboardServer(); // Handles incoming client connections and WebSocket messages
+  flushPaintGunTelemetry(); // Gun events are logged and broadcast here, off the hot path
+  sectionUs = loopProfileMark(LOOP_PROFILE_DASHBOARD, sectionUs);
   
   // Update rotation stepper for AccelStepper (non-blocking moves)
   if (rotationStepper) {
     rotationStepper->run();
   }
+  loopProfileMark(LOOP_PROFILE_ROTATION, sectionUs);
+  loopProfileMark(LOOP_PROFILE_WORK, loopStartUs);
+  serviceLoopProfileReport(); // Outside the timed sections
   
   // Add calls to other main loop functions here
   // For example, state machine updates, periodic checks, etc.
@@ -22,6 +22,18 @@
 #include <Preferences.h>
 #include "web/Web_Dashboard_Commands.h" // For loadPnpSettingsFromNVS
 #include "hardware/GlobalDebouncers.h" // For initializeGlobalDebouncers
+#include "motors/StopAll.h" // For initializeStopAllInterrupt
+#include "motors/LimitSwitches.h" // For initializeLimitSwitchMonitor
+#include "motors/GantrySync.h" // For loadGantrySettingsFromNVS
+#include "hardware/GunLatency.h" // For loadGunLatencyFromNVS
+#include "hardware/paintGun_Functions.h" // For loadPaintGunSettingsFromNVS
+#include "storage/TrayDefinitions.h" // For loadTrayDefinitionsFromNVS
+#include "motors/TrayLayout.h" // For loadTrayLayoutFromNVS
+#include "motors/PnPPlanner.h" // For loadPnPPlannerFromNVS
+#include "system/DryingScheduler.h" // For loadDryingJobsFromNVS
+#include "system/JobQueue.h" // For loadJobQueueFromNVS
+#include "system/CycleEstimator.h" // For loadCycleEstimatorFromNVS
+#include "system/PhaseStats.h" // For loadPhaseStatsFromNVS
 
 //* ************************************************************************
 //* ************************* SYSTEM SETUP ***************************
@@ -173,8 +185,12 @@ void initializeMotorsAndSwitches() {
     debounceZ.attach(Z_HOME_SWITCH);
     debounceZ.interval(GENERAL_DEBOUNCE_MS);
 
+    // Hard-stop axes on a limit switch during normal motion
+    initializeLimitSwitchMonitor();
+
     // Initialize global debouncers (includes PNP Cycle Sensor)
     initializeGlobalDebouncers(); 
+    initializeStopAllInterrupt(); // Needs the control panel pins configured above
 
     // Serial.println("Motors and Switches Initialized.");
 }
@@ -200,6 +216,9 @@ void initializeVacuumSystem() {
     // Serial.println("Initializing Vacuum System...");
     pinMode(SUCTION_PIN, OUTPUT);
     digitalWrite(SUCTION_PIN, LOW); // Start with vacuum off
+    if (VACUUM_SWITCH_PIN >= 0) {
+        pinMode(VACUUM_SWITCH_PIN, INPUT_PULLUP);
+    }
     // Serial.println("Vacuum System Initialized.");
 }
 
@@ -208,6 +227,9 @@ void initializeCylinderSystem() {
     // Serial.println("Initializing Cylinder System...");
     pinMode(PICK_CYLINDER_PIN, OUTPUT);
     digitalWrite(PICK_CYLINDER_PIN, LOW); // Start with cylinder retracted (UP)
+    if (PICK_CYLINDER_DOWN_SENSOR_PIN >= 0) {
+        pinMode(PICK_CYLINDER_DOWN_SENSOR_PIN, INPUT_PULLUP);
+    }
     // Serial.println("Cylinder System Initialized.");
 }
 
@@ -221,6 +243,23 @@ void initializeSettings() {
 
     // Load PNP motion settings from NVS
     loadPnpSettingsFromNVS();
+
+    // Load gantry squaring offset from NVS
+    loadGantrySettingsFromNVS();
+
+    // Load verify-home setting from NVS
+    loadHomingSettingsFromNVS();
+
+    // Load paint gun latency calibration and minimum pulse from NVS
+    loadGunLatencyFromNVS();
+    loadPaintGunSettingsFromNVS();
+    loadTrayDefinitionsFromNVS(); // Before the tray layout: occupancy is masked to the active tray
+    loadTrayLayoutFromNVS();
+    loadPnPPlannerFromNVS();
+    loadDryingJobsFromNVS();
+    loadJobQueueFromNVS();
+    loadCycleEstimatorFromNVS();
+    loadPhaseStatsFromNVS();
     
     // No need to explicitly close persistence here, 
     // paintingSettings.begin() handles its own NVS operations if needed.
@@ -0,0 +1,126 @@
+#include "motors/GantrySync.h"
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+#include <WebSocketsServer.h>
+#include "utils/settings.h"
+#include "motors/LimitSwitches.h"
+#include "storage/Persistence.h"
+
+extern FastAccelStepper *stepperY_Left;
+extern FastAccelStepper *stepperY_Right;
+extern WebSocketsServer webSocket;
+
+#define GANTRY_SQUARING_OFFSET_KEY "ySqOff"
+#define GANTRY_HOMING_SKEW_KEY "ySkew"
+
+static long g_gantrySquaringOffsetSteps = DEFAULT_GANTRY_SQUARING_OFFSET_STEPS;
+static bool g_gantrySquaringStored = false;
+static long g_lastGantryHomingSkew = 0;
+
+//* ************************************************************************
+//* *************************** RUNNING CHECK ******************************
+//* ************************************************************************
+
+bool checkGantrySync() {
+    if (!stepperY_Left || !stepperY_Right || !isLimitMonitoringEnabled()) {
+        return false;
+    }
+
+    long difference = stepperY_Left->getCurrentPosition() - stepperY_Right->getCurrentPosition();
+    if (labs(difference) <= GANTRY_SYNC_FAULT_STEPS) {
+        return false;
+    }
+
+    if (!(getLimitFaultMask() & LIMIT_FAULT_Y_RACKED)) {
+        Serial.printf("GANTRY RACKED: Y_Left:%ld Y_Right:%ld (difference %ld steps, limit %d)\n",
+                      stepperY_Left->getCurrentPosition(), stepperY_Right->getCurrentPosition(),
+                      difference, GANTRY_SYNC_FAULT_STEPS);
+        //! Stop the gantry first; serviceLimitSwitches() handles the rest
+        stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
+        stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
+        latchLimitFault(LIMIT_FAULT_Y_RACKED);
+    }
+    return true;
+}
+
+//* ************************************************************************
+//* *************************** HOMING SQUARING ****************************
+//* ************************************************************************
+
+static void latchGantryRackedFault(const char* reason) {
+    Serial.printf("GANTRY RACKED at homing: %s\n", reason);
+    latchLimitFault(LIMIT_FAULT_Y_RACKED);
+}
+
+bool recordGantryHomingSkew(long skewSteps) {
+    g_lastGantryHomingSkew = skewSteps;
+    persistence.beginTransaction(false);
+    persistence.saveInt(GANTRY_HOMING_SKEW_KEY, (int)skewSteps);
+    persistence.endTransaction();
+
+    //! Never taken as square on its own - a gantry racked at this homing would
+    //! become the reference. The operator captures it once it is known square.
+    if (!g_gantrySquaringStored) {
+        Serial.printf("Gantry skew at homing: %ld steps (%.3f in) - no squaring offset captured, "
+                      "send CAPTURE_GANTRY_SQUARING once the gantry is known square\n",
+                      skewSteps, (float)skewSteps / STEPS_PER_INCH_XYZ);
+        String message = "GANTRY_SKEW:";
+        message += skewSteps;
+        webSocket.broadcastTXT(message);
+        return true;
+    }
+
+    //? A square gantry measures -offset; the rest is how far it was racked before homing
+    long rackSteps = -g_gantrySquaringOffsetSteps - skewSteps;
+    Serial.printf("Gantry skew at homing: %ld steps (%.3f in), racked %ld steps%s\n", skewSteps,
+                  (float)skewSteps / STEPS_PER_INCH_XYZ, rackSteps,
+                  labs(rackSteps) > GANTRY_HOMING_SKEW_WARN_STEPS ? " - WARNING: gantry was out of square" : "");
+    String message = "GANTRY_SKEW:";
+    message += skewSteps;
+    message += ",";
+    message += rackSteps;
+    webSocket.broadcastTXT(message);
+
+    if (labs(rackSteps) > GANTRY_HOMING_SKEW_FAULT_STEPS) {
+        latchGantryRackedFault("racked past the fault bound");
+        return false;
+    }
+    return true;
+}
+
+long getLastGantryHomingSkew() {
+    return g_lastGantryHomingSkew;
+}
+
+bool captureGantrySquaringFromSkew() {
+    if (labs(g_lastGantryHomingSkew) > GANTRY_SQUARING_MAX_OFFSET_STEPS) {
+        Serial.printf("Gantry squaring: skew %ld steps is beyond the %d step bound - not captured\n",
+                      g_lastGantryHomingSkew, GANTRY_SQUARING_MAX_OFFSET_STEPS);
+        return false;
+    }
+    setGantrySquaringOffset(-g_lastGantryHomingSkew);
+    return true;
+}
+
+void setGantrySquaringOffset(long offsetSteps) {
+    g_gantrySquaringOffsetSteps = constrain(offsetSteps, -GANTRY_SQUARING_MAX_OFFSET_STEPS, GANTRY_SQUARING_MAX_OFFSET_STEPS);
+    g_gantrySquaringStored = true;
+    persistence.beginTransaction(false);
+    persistence.saveInt(GANTRY_SQUARING_OFFSET_KEY, (int)g_gantrySquaringOffsetSteps);
+    persistence.endTransaction();
+    Serial.printf("Gantry squaring offset set to %ld steps\n", g_gantrySquaringOffsetSteps);
+}
+
+long getGantrySquaringOffset() {
+    return g_gantrySquaringOffsetSteps;
+}
+
+void loadGantrySettingsFromNVS() {
+    persistence.beginTransaction(true);
+    g_gantrySquaringStored = persistence.isKey(GANTRY_SQUARING_OFFSET_KEY);
+    g_gantrySquaringOffsetSteps = persistence.loadInt(GANTRY_SQUARING_OFFSET_KEY, DEFAULT_GANTRY_SQUARING_OFFSET_STEPS);
+    g_lastGantryHomingSkew = persistence.loadInt(GANTRY_HOMING_SKEW_KEY, 0);
+    persistence.endTransaction();
+    Serial.printf("Gantry squaring offset loaded: %ld steps%s, last homing skew %ld steps\n", g_gantrySquaringOffsetSteps,
+                  g_gantrySquaringStored ? "" : " (not captured yet)", g_lastGantryHomingSkew);
+}
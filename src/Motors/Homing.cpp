@@ -6,6 +6,15 @@
 #include "utils/settings.h"
 #include "system/machine_state.h" // Include the updated header
 #include "settings/debounce_settings.h" // Added for centralized debounce intervals
+#include "motors/GantrySync.h" // Gantry skew recording and squaring
+#include "motors/StopAll.h" // Stop input polled in every homing loop
+#include "storage/Persistence.h"
+#include "system/PhaseStats.h" // Homing phase timing
+#include <WebSocketsServer.h>
+
+extern WebSocketsServer webSocket;
+
+#define VERIFY_HOME_KEY "vfyHome"
 
 // Need access to the global rotation stepper pointer if used
 // This is already included via Rotation_Motor.h in Homing.h
@@ -41,8 +50,337 @@ long Homing::inchesToStepsXYZ(float inches) {
     return (long)(inches * STEPS_PER_INCH_XYZ);
 }
 
+//* ************************************************************************
+//* ************************* HOMING REFERENCE *****************************
+//* ************************************************************************
+// Where each switch sits in the coordinate frame set by the last homing, used
+// to rapid to just short of it next time.
+
+static bool g_homingReferenceValid = false;
+static long g_expectedSwitchPos[HOMING_AXIS_COUNT] = {0, 0, 0, 0};
+
+static const char* const kHomingAxisKeys[HOMING_AXIS_COUNT] = { "X", "Y_LEFT", "Y_RIGHT", "Z" };
+
+static bool g_verifyHomeAfterJobs = DEFAULT_VERIFY_HOME_AFTER_JOBS;
+
+// Fast-to-slow trigger deltas from recent homing cycles, per axis
+static long g_triggerDeltaHistory[HOMING_AXIS_COUNT][HOMING_REPEATABILITY_HISTORY];
+static int g_triggerDeltaCount[HOMING_AXIS_COUNT] = {0, 0, 0, 0};
+
+bool isHomingReferenceValid() {
+    return g_homingReferenceValid;
+}
+
+void invalidateHomingReference() {
+    if (g_homingReferenceValid) {
+        Serial.println("Homing reference invalidated - next homing seeks from unknown position");
+    }
+    g_homingReferenceValid = false;
+}
+
+// The stop input (latched by its interrupt) during homing: serviceStopAll()
+// has stopped the linear axes; halt the turntable too and abandon homing
+bool Homing::stopInputReceived() {
+    if (!serviceStopAll()) {
+        return false;
+    }
+    if (rotationStepper) {
+        rotationStepper->setCurrentPosition(rotationStepper->currentPosition());
+    }
+    Serial.println("ERROR: Stop input during homing - homing abandoned");
+    invalidateHomingReference();
+    _stopped = true;
+    return true;
+}
+
+//* ************************************************************************
+//* ************************* TWO-STAGE HOMING *****************************
+//* ************************************************************************
+
+void Homing::startAxisHoming(HomingAxis& axis, int index) {
+    long position = axis.stepper->getCurrentPosition();
+    axis.startPos = position;
+    axis.fastTripPos = position;
+    axis.slowTripPos = position;
+    axis.startMs = millis();
+    axis.doneMs = axis.startMs;
+    axis.expectedSwitchPos = g_expectedSwitchPos[index];
+
+    axis.homeSwitch->update();
+    if (axis.homeSwitch->read() == HIGH && _verifyMode) {
+        Serial.printf("  %s already at switch.\n", axis.name);
+        if (axis.stepper->isRunning()) axis.stepper->forceStopAndNewPosition(position);
+        axis.phase = AXIS_HOMING_DONE;
+        return;
+    }
+    if (axis.homeSwitch->read() == HIGH) {
+        Serial.printf("  %s already at switch, backing off for slow re-approach.\n", axis.name);
+        if (axis.stepper->isRunning()) axis.stepper->forceStopAndNewPosition(position);
+        beginBackOff(axis);
+        return;
+    }
+
+    if (g_homingReferenceValid) {
+        long clearance = inchesToStepsXYZ(HOMING_RAPID_CLEARANCE_INCHES);
+        long rapidTarget = axis.expectedSwitchPos - axis.towardSwitch * clearance;
+        //? Only worth it if the target is still between us and the switch
+        if ((rapidTarget - position) * axis.towardSwitch > 0) {
+            Serial.printf("  %s rapid to %ld (switch expected at %ld).\n", axis.name, rapidTarget, axis.expectedSwitchPos);
+            axis.stepper->setAcceleration(axis.rapidAccel);
+            axis.stepper->setSpeedInHz(axis.rapidSpeed);
+            axis.stepper->moveTo(rapidTarget);
+            axis.phase = AXIS_HOMING_RAPID;
+            return;
+        }
+    }
+    if (_verifyMode) {
+        beginSlowSeek(axis); // Already close - just creep
+    } else {
+        beginFastSeek(axis);
+    }
+}
+
+void Homing::beginFastSeek(HomingAxis& axis) {
+    Serial.printf("  %s fast seek at %lu Hz.\n", axis.name, (unsigned long)axis.fastSpeed);
+    axis.stepper->setAcceleration(axis.seekAccel);
+    axis.stepper->setSpeedInHz(axis.fastSpeed);
+    if (axis.towardSwitch < 0) {
+        axis.stepper->runBackward();
+    } else {
+        axis.stepper->runForward();
+    }
+    axis.phase = AXIS_HOMING_FAST_SEEK;
+}
+
+void Homing::beginBackOff(HomingAxis& axis) {
+    //? Measured from the trigger point, so any stopping overshoot is covered
+    long backOffTarget = axis.fastTripPos - axis.towardSwitch * inchesToStepsXYZ(HOMING_MOVE_AWAY_INCHES);
+    axis.stepper->setAcceleration(axis.seekAccel);
+    axis.stepper->setSpeedInHz(axis.fastSpeed);
+    axis.stepper->moveTo(backOffTarget);
+    axis.phase = AXIS_HOMING_BACK_OFF;
+}
+
+void Homing::beginSlowSeek(HomingAxis& axis) {
+    axis.stepper->setAcceleration(axis.seekAccel);
+    axis.stepper->setSpeedInHz(axis.slowSpeed);
+    if (axis.towardSwitch < 0) {
+        axis.stepper->runBackward();
+    } else {
+        axis.stepper->runForward();
+    }
+    axis.phase = AXIS_HOMING_SLOW_SEEK;
+}
+
+bool Homing::updateAxisHoming(HomingAxis& axis) {
+    if (axis.phase == AXIS_HOMING_DONE) {
+        return true;
+    }
+
+    axis.homeSwitch->update();
+    bool triggered = axis.homeSwitch->read() == HIGH;
+    long position = axis.stepper->getCurrentPosition();
+
+    switch (axis.phase) {
+        case AXIS_HOMING_RAPID:
+            if (triggered) {
+                //! Reference was wrong - switch reached during the rapid move
+                axis.stepper->forceStopAndNewPosition(position);
+                axis.fastTripPos = position;
+                Serial.printf("  WARNING: %s switch triggered during rapid approach at %ld.\n", axis.name, position);
+                if (_verifyMode) {
+                    axis.slowTripPos = position; // Far outside tolerance - verification fails
+                    axis.phase = AXIS_HOMING_DONE;
+                    axis.doneMs = millis();
+                    return true;
+                }
+                beginBackOff(axis);
+            } else if (!axis.stepper->isRunning()) {
+                if (_verifyMode) {
+                    beginSlowSeek(axis);
+                } else {
+                    beginFastSeek(axis);
+                }
+            }
+            break;
+
+        case AXIS_HOMING_FAST_SEEK:
+            if (triggered) {
+                axis.stepper->forceStopAndNewPosition(position);
+                axis.fastTripPos = position;
+                Serial.printf("  %s fast trigger at %ld - backing off.\n", axis.name, position);
+                beginBackOff(axis);
+            }
+            break;
+
+        case AXIS_HOMING_BACK_OFF:
+            if (!axis.stepper->isRunning()) {
+                if (triggered) {
+                    //? Still on the switch (debounce lag or long overshoot) - back off again
+                    //? fastTripPos keeps the real trigger point; this is only extra back-off
+                    Serial.printf("  %s still on switch after back-off, backing off further.\n", axis.name);
+                    beginBackOff(axis);
+                } else {
+                    beginSlowSeek(axis);
+                }
+            }
+            break;
+
+        case AXIS_HOMING_SLOW_SEEK:
+            if (triggered) {
+                axis.slowTripPos = position;
+                //? Verification keeps the old frame so the trigger can be compared with it
+                axis.stepper->forceStopAndNewPosition(_verifyMode ? position : 0);
+                Serial.printf("%s Home switch triggered (slow pass) - MOTOR STOPPED IMMEDIATELY\n", axis.name);
+                axis.phase = AXIS_HOMING_DONE;
+                axis.doneMs = millis();
+                return true;
+            }
+            if (_verifyMode && (position - axis.expectedSwitchPos) * axis.towardSwitch > VERIFY_HOME_TOLERANCE_STEPS) {
+                //! Crept past where the switch should be - no point going further
+                axis.stepper->forceStopAndNewPosition(position);
+                axis.slowTripPos = position;
+                Serial.printf("  %s no switch within tolerance of %ld.\n", axis.name, axis.expectedSwitchPos);
+                axis.phase = AXIS_HOMING_DONE;
+                axis.doneMs = millis();
+                return true;
+            }
+            break;
+
+        default:
+            break;
+    }
+    return false;
+}
+
+void Homing::startAllAxesHoming(HomingAxis* axes) {
+    const HomingAxis definitions[HOMING_AXIS_COUNT] = {
+        { "X",       _stepperX,       &_xHomeSwitch,      -1, DEFAULT_X_SPEED, DEFAULT_X_ACCEL, HOMING_FAST_SPEED_X, HOMING_SPEED_X, HOMING_ACCEL_X },
+        { "Y Left",  _stepperY_Left,  &_yLeftHomeSwitch,  -1, DEFAULT_Y_SPEED, DEFAULT_Y_ACCEL, HOMING_FAST_SPEED_Y, HOMING_SPEED_Y, HOMING_ACCEL_Y },
+        { "Y Right", _stepperY_Right, &_yRightHomeSwitch, -1, DEFAULT_Y_SPEED, DEFAULT_Y_ACCEL, HOMING_FAST_SPEED_Y, HOMING_SPEED_Y, HOMING_ACCEL_Y },
+        { "Z",       _stepperZ,       &_zHomeSwitch,      +1, DEFAULT_Z_SPEED, DEFAULT_Z_ACCEL, HOMING_FAST_SPEED_Z, HOMING_SPEED_Z, HOMING_ACCEL_Z }, // Z moves UP (forward) to home
+    };
+    for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+        axes[i] = definitions[i];
+        startAxisHoming(axes[i], i);
+    }
+}
+
+// Runs the axes (and the turntable) until every switch has been found.
+// Returns false on timeout, with everything stopped.
+bool Homing::runAxesToSwitches(HomingAxis* axes, RotationHoming& rotation) {
+    long zClearanceSteps = inchesToStepsXYZ(HOMING_ROTATION_Z_CLEARANCE_INCHES);
+    unsigned long startTime = millis();
+    bool allDone = false;
+    while (!allDone) {
+        if (stopInputReceived()) {
+            return false;
+        }
+        //? Check timeout
+        if (millis() - startTime > HOMING_TIMEOUT_MS) {
+            Serial.println("ERROR: Homing timeout!");
+            //? Stop any motors that haven't homed yet
+            for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+                if (axes[i].phase != AXIS_HOMING_DONE && axes[i].stepper->isRunning()) {
+                    axes[i].stepper->forceStopAndNewPosition(axes[i].stepper->getCurrentPosition());
+                }
+            }
+            // Rotation stepper is already stopped if it was homed, or forceStop if it was stuck in rotateToAngle (though unlikely with its internal timeout)
+            if (rotationStepper && rotationStepper->distanceToGo() != 0) { // Check if it somehow got stuck despite blocking call
+                 rotationStepper->stop(); // Stop the stepper
+                 rotationStepper->setCurrentPosition(rotationStepper->currentPosition()); // Set current position
+            }
+            invalidateHomingReference();
+            return false;
+        }
+        
+        //! Each axis is processed independently so it stops the instant its own sensor triggers
+        allDone = true;
+        for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+            if (!updateAxisHoming(axes[i])) {
+                allDone = false;
+            }
+        }
+
+        //! Rotation: start once Z is clear - known to be near its home, or has
+        //! reached its switch on this cycle
+        if (rotationStepper && !rotation.started) {
+            const HomingAxis& zAxis = axes[HOMING_AXIS_Z];
+            bool zKnownHigh = isHomingReferenceValid() && _stepperZ->getCurrentPosition() >= -zClearanceSteps;
+            bool zAtSwitch = zAxis.phase == AXIS_HOMING_BACK_OFF || zAxis.phase == AXIS_HOMING_SLOW_SEEK ||
+                             zAxis.phase == AXIS_HOMING_DONE;
+            if (zKnownHigh || zAtSwitch) {
+                Serial.printf("Starting rotation homing to 0 degrees (shortest path), Z %s...\n",
+                              zKnownHigh ? "already clear" : "at home switch");
+                startRotationToAngle(0);
+                rotation.started = true;
+                rotation.startMs = millis();
+            } else {
+                allDone = false;
+            }
+        }
+        if (rotation.started && !rotation.homed) {
+            if (rotationStepper->distanceToGo() != 0) {
+                rotationStepper->run();
+                allDone = false;
+            } else {
+                rotationStepper->setCurrentPosition(0); // Explicitly set logical position to 0 steps
+                Serial.println("Rotation axis homed and set to 0 degrees.");
+                rotation.homed = true;
+                rotation.doneMs = millis();
+            }
+        }
+        
+        //! Using yield() instead of delay() to allow other tasks while maintaining tight sensor monitoring
+        yield();
+    }
+    return true;
+}
+
+void Homing::reportHomingDurations(const HomingAxis* axes, unsigned long rotationMs, unsigned long totalMs) {
+    // HOMING_TIMES:X=<ms>,Y_LEFT=<ms>,Y_RIGHT=<ms>,Z=<ms>,ROT=<ms>,TOTAL=<ms>
+    String message = "HOMING_TIMES:";
+    for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+        message += kHomingAxisKeys[i];
+        message += "=";
+        message += axes[i].doneMs - axes[i].startMs;
+        message += ",";
+    }
+    message += "ROT=";
+    message += rotationMs;
+    message += ",TOTAL=";
+    message += totalMs;
+    Serial.println(message);
+    webSocket.broadcastTXT(message);
+}
+
+void Homing::recordTriggerRepeatability(int index, const HomingAxis& axis) {
+    long delta = axis.slowTripPos - axis.fastTripPos;
+    long* history = g_triggerDeltaHistory[index];
+
+    // Shift history so the newest entry is last
+    if (g_triggerDeltaCount[index] == HOMING_REPEATABILITY_HISTORY) {
+        for (int i = 1; i < HOMING_REPEATABILITY_HISTORY; i++) {
+            history[i - 1] = history[i];
+        }
+        g_triggerDeltaCount[index]--;
+    }
+    history[g_triggerDeltaCount[index]++] = delta;
+
+    long minDelta = history[0];
+    long maxDelta = history[0];
+    for (int i = 1; i < g_triggerDeltaCount[index]; i++) {
+        minDelta = min(minDelta, history[i]);
+        maxDelta = max(maxDelta, history[i]);
+    }
+    Serial.printf("  %s trigger repeatability: fast->slow delta %ld steps, spread %ld steps (%.4f in) over last %d homings\n",
+                  axis.name, delta, maxDelta - minDelta, (float)(maxDelta - minDelta) / STEPS_PER_INCH_XYZ,
+                  g_triggerDeltaCount[index]);
+}
+
 // Implementation of the homing logic, now as a class method
 bool Homing::homeAllAxes() {
+    PhaseScope homing(PHASE_HOMING);
     Serial.println("Starting Home All Axes sequence...");
     // setMachineState(MachineState::HOMING); // REMOVED
     
@@ -81,174 +419,44 @@ bool Homing::homeAllAxes() {
         rotationStepper->setAcceleration(DEFAULT_ROT_ACCEL / 2); //? Half acceleration for homing
     }
     
-    //! STEP 4: Track homing status for each motor
-    bool xHomed = false;
-    bool yLeftHomed = false;
-    bool yRightHomed = false;
-    bool zHomed = false;
-    bool rotationActuallyHomed = false; // Flag to indicate if rotation homing was attempted and completed
-
-    // Perform rotation homing FIRST if stepper exists (sequential, not simultaneous)
-    if (rotationStepper) {
-        Serial.println("Starting rotation homing to 0 degrees (shortest path)...");
-        rotateToAngle(0); // This is BLOCKING and uses shortest path logic.
-        rotationStepper->setCurrentPosition(0); // Explicitly set logical position to 0 steps
-        Serial.println("Rotation axis homed and set to 0 degrees.");
-        rotationActuallyHomed = true;
-    }
+    //! STEP 4: Track homing status for the rotation motor (linear axes tracked per stage below)
+    //! The turntable is mechanically independent of the gantry and homes alongside
+    //! it; it only has to wait when Z might be low enough to hit the part
+    RotationHoming rotation = { false, false, 0, 0 };
+    unsigned long homingStartMs = millis();
     
-    //! STEP 5: Start X, Y, Z motors moving toward home switches AFTER rotation homing
-    Serial.println("Moving X, Y, Z axes toward home switches...");
-
-    _xHomeSwitch.update(); // Initial read before moving
-    if (_xHomeSwitch.read() != HIGH) {
-        Serial.println("  X not at switch, starting X homing movement.");
-        // Debug: Check direction pin state BEFORE runBackward()
-        pinMode(X_DIR_PIN, OUTPUT); // Ensure pin mode is set if not already
-        Serial.printf("  DEBUG: X_DIR_PIN (%d) state before runBackward: %d\n", X_DIR_PIN, digitalRead(X_DIR_PIN));
-        _stepperX->runBackward(); 
-        Serial.printf("  DEBUG: X_DIR_PIN (%d) state AFTER runBackward: %d\n", X_DIR_PIN, digitalRead(X_DIR_PIN));
-    } else {
-        Serial.println("  X already at switch, marking as homed.");
-        if (_stepperX->isRunning()) _stepperX->forceStop(); // Stop if somehow running
-        _stepperX->setCurrentPosition(0); // Define current as 0 (avoids issues with forceStopAndNewPosition if not actually moving)
-        xHomed = true; 
-    }
+    //! STEP 5: Start X, Y, Z motors moving toward home switches
+    //! Two-stage: fast seek (rapid to just short of the switch first if the last
+    //! homing reference is still valid), back off, then slow re-approach
+    Serial.printf("Moving X, Y, Z axes toward home switches (%s)...\n",
+                  isHomingReferenceValid() ? "rapid + fast seek from known position" : "fast seek, position unknown");
 
-    _yLeftHomeSwitch.update();
-    if (_yLeftHomeSwitch.read() != HIGH) {
-        Serial.println("  Y-Left not at switch, starting Y-Left homing movement.");
-        _stepperY_Left->runBackward();
-    } else {
-        Serial.println("  Y-Left already at switch, marking as homed.");
-        if (_stepperY_Left->isRunning()) _stepperY_Left->forceStop();
-        _stepperY_Left->setCurrentPosition(0);
-        yLeftHomed = true;
-    }
-
-    _yRightHomeSwitch.update();
-    if (_yRightHomeSwitch.read() != HIGH) {
-        Serial.println("  Y-Right not at switch, starting Y-Right homing movement.");
-        _stepperY_Right->runBackward();
-    } else {
-        Serial.println("  Y-Right already at switch, marking as homed.");
-        if (_stepperY_Right->isRunning()) _stepperY_Right->forceStop();
-        _stepperY_Right->setCurrentPosition(0);
-        yRightHomed = true;
-    }
-
-    _zHomeSwitch.update();
-    // Assuming Z home switch is also HIGH when triggered and Z moves UP (forward) to home
-    if (_zHomeSwitch.read() != HIGH) { 
-        Serial.println("  Z not at switch, starting Z homing movement.");
-        _stepperZ->runForward(); 
-    } else {
-        Serial.println("  Z already at switch, marking as homed.");
-        if (_stepperZ->isRunning()) _stepperZ->forceStop();
-        _stepperZ->setCurrentPosition(0);
-        zHomed = true;
-    }
-
-    bool rotationHomed = (rotationStepper == NULL) || rotationActuallyHomed; // True if no stepper or if homing completed
+    HomingAxis axes[HOMING_AXIS_COUNT];
+    startAllAxesHoming(axes);
     
-    unsigned long startTime = millis();
+    //! STEP 6: Run every axis (and the turntable) through its stages simultaneously
+    if (!runAxesToSwitches(axes, rotation)) {
+        return false;
+    }
     
-    //! STEP 6: Monitor all switches simultaneously using Bounce2
-    // Rotation is already handled if present, so loop focuses on X, Y, Z
-    while (!xHomed || !yLeftHomed || !yRightHomed || !zHomed) { // Removed !rotationHomed from this condition
-        //? Check timeout
-        if (millis() - startTime > HOMING_TIMEOUT_MS) {
-            Serial.println("ERROR: Homing timeout!");
-            //? Stop any motors that haven't homed yet
-            if (!xHomed && _stepperX->isRunning()) _stepperX->forceStopAndNewPosition(_stepperX->getCurrentPosition());
-            if (!yLeftHomed && _stepperY_Left->isRunning()) _stepperY_Left->forceStopAndNewPosition(_stepperY_Left->getCurrentPosition());
-            if (!yRightHomed && _stepperY_Right->isRunning()) _stepperY_Right->forceStopAndNewPosition(_stepperY_Right->getCurrentPosition()); // Stop Y Right too
-            if (!zHomed && _stepperZ->isRunning()) _stepperZ->forceStopAndNewPosition(_stepperZ->getCurrentPosition());
-            // Rotation stepper is already stopped if it was homed, or forceStop if it was stuck in rotateToAngle (though unlikely with its internal timeout)
-            if (rotationStepper && rotationStepper->distanceToGo() != 0) { // Check if it somehow got stuck despite blocking call
-                 rotationStepper->stop(); // Stop the stepper
-                 rotationStepper->setCurrentPosition(rotationStepper->currentPosition()); // Set current position
-            }
-            // setMachineState(MachineState::ERROR); // REMOVED - StateMachine handles transition
-            return false;
-        }
-        
-        //! CRITICAL FIX: Process each sensor immediately and independently
-        //! This ensures maximum responsiveness - each motor stops the instant its sensor is triggered
-        
-        //! Process X switch with Bounce2 - IMMEDIATE RESPONSE
-        if (!xHomed) { // Only process if not already marked homed
-            _xHomeSwitch.update();
-            if (_xHomeSwitch.read() == HIGH) { 
-                if (_stepperX->isRunning()) { // Only stop if it was actually running towards switch
-                    _stepperX->forceStopAndNewPosition(0);
-                    Serial.println("X Home switch triggered - MOTOR STOPPED IMMEDIATELY");
-                } else { // If it wasn't running but switch is high, it means it was pre-homed or an edge case
-                    _stepperX->setCurrentPosition(0); // Ensure logical position is 0
-                    Serial.println("X Home switch triggered - position set to 0");
-                }
-                xHomed = true;
-            }
-        }
-        
-        //! Process Y Left switch with Bounce2 - IMMEDIATE RESPONSE
-        if (!yLeftHomed) {
-            _yLeftHomeSwitch.update();
-            if (_yLeftHomeSwitch.read() == HIGH) { 
-                if (_stepperY_Left->isRunning()) {
-                    _stepperY_Left->forceStopAndNewPosition(0);
-                    Serial.println("Y Left Home switch triggered - MOTOR STOPPED IMMEDIATELY");
-                } else {
-                    _stepperY_Left->setCurrentPosition(0);
-                    Serial.println("Y Left Home switch triggered - position set to 0");
-                }
-                yLeftHomed = true;
-            }
-        }
-        
-        //! Process Y Right switch with Bounce2 - IMMEDIATE RESPONSE
-        if (!yRightHomed) {
-            _yRightHomeSwitch.update();
-            if (_yRightHomeSwitch.read() == HIGH) { 
-                if (_stepperY_Right->isRunning()) {
-                    _stepperY_Right->forceStopAndNewPosition(0);
-                    Serial.println("Y Right Home switch triggered - MOTOR STOPPED IMMEDIATELY");
-                } else {
-                    _stepperY_Right->setCurrentPosition(0);
-                    Serial.println("Y Right Home switch triggered - position set to 0");
-                }
-                yRightHomed = true;
-            }
-        }
-        
-        //! Process Z switch with Bounce2 - IMMEDIATE RESPONSE
-        if (!zHomed) {
-            _zHomeSwitch.update();
-            if (_zHomeSwitch.read() == HIGH) { 
-                if (_stepperZ->isRunning()) {
-                    _stepperZ->forceStopAndNewPosition(0);
-                    Serial.println("Z Home switch triggered - MOTOR STOPPED IMMEDIATELY");
-                } else {
-                    _stepperZ->setCurrentPosition(0);
-                    Serial.println("Z Home switch triggered - position set to 0");
-                }
-                zHomed = true;
-            }
-        }
-        
-        //! Rotation motor homing is already complete (rotateToAngle is blocking)
-        // No need to monitor rotation motor in this loop
-        
-        //! CRITICAL: Minimal delay to allow sensor readings to update but maintain maximum responsiveness
-        //! Using yield() instead of delay() to allow other tasks while maintaining tight sensor monitoring
-        yield(); // Allow other tasks to run but return immediately to sensor checking
+    for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+        recordTriggerRepeatability(i, axes[i]);
     }
+    bool xHomed = axes[HOMING_AXIS_X].phase == AXIS_HOMING_DONE;
+    bool yLeftHomed = axes[HOMING_AXIS_Y_LEFT].phase == AXIS_HOMING_DONE;
+    bool yRightHomed = axes[HOMING_AXIS_Y_RIGHT].phase == AXIS_HOMING_DONE;
+    bool zHomed = axes[HOMING_AXIS_Z].phase == AXIS_HOMING_DONE;
     
     //! STEP 7: All switches triggered
     Serial.println("All X, Y, Z home switches triggered.");
-    if (rotationStepper) {
-        Serial.println("Rotation axis was previously homed.");
-    }
+    //? Both Y sides start from the same count, so the difference in travel to
+    //? their switches is the gantry skew. Measured at the slow trigger - the
+    //? fast one carries the fast-seek polling and debounce lag
+    //? A racked gantry is still squared below; the latched fault then sends the
+    //? machine to ErrorState so the lost steps are looked at
+    bool gantrySquare = recordGantryHomingSkew(
+        (axes[HOMING_AXIS_Y_LEFT].startPos - axes[HOMING_AXIS_Y_LEFT].slowTripPos) -
+        (axes[HOMING_AXIS_Y_RIGHT].startPos - axes[HOMING_AXIS_Y_RIGHT].slowTripPos));
     delay(5); //? Ensure motors stopped and positions registered
     
     //! STEP 8: Move away from switches simultaneously
@@ -270,12 +478,15 @@ bool Homing::homeAllAxes() {
     _stepperZ->moveTo(-moveAwaySteps, false); //? Z moves DOWN (negative) to move away
     
     //! STEP 9: Wait for all motors to complete the move away
-    startTime = millis(); // Reset timer for move away
+    unsigned long startTime = millis(); // Timer for move away
     unsigned long lastPrintTime = 0; // Debug print timer
     while (_stepperX->isRunning() || 
            _stepperY_Left->isRunning() || 
            _stepperY_Right->isRunning() || 
            _stepperZ->isRunning()) {
+        if (stopInputReceived()) {
+            return false;
+        }
         if (millis() - startTime > 5000) { //? 5 second timeout for move away
             Serial.println("ERROR: Timeout moving away from switches!");
             _stepperX->forceStopAndNewPosition(_stepperX->getCurrentPosition());
@@ -283,6 +494,7 @@ bool Homing::homeAllAxes() {
             _stepperY_Right->forceStopAndNewPosition(_stepperY_Right->getCurrentPosition());
             _stepperZ->forceStopAndNewPosition(_stepperZ->getCurrentPosition());
             // setMachineState(MachineState::ERROR); // REMOVED - StateMachine handles transition
+            invalidateHomingReference();
             return false;
         }
         
@@ -299,7 +511,32 @@ bool Homing::homeAllAxes() {
         yield(); 
     }
     
+    //! STEP 9b: Square the gantry - both sides now sit the same distance off their
+    //! switches, so shift Y_Right by the calibrated offset between the two switches
+    long squaringOffset = getGantrySquaringOffset();
+    if (squaringOffset != 0) {
+        Serial.printf("Squaring gantry: moving Y_Right by %ld steps\n", squaringOffset);
+        _stepperY_Right->move(squaringOffset);
+        startTime = millis();
+        while (_stepperY_Right->isRunning()) {
+            if (stopInputReceived()) {
+                return false;
+            }
+            if (millis() - startTime > 5000) {
+                Serial.println("ERROR: Timeout squaring gantry!");
+                _stepperY_Right->forceStopAndNewPosition(_stepperY_Right->getCurrentPosition());
+                invalidateHomingReference();
+                return false;
+            }
+            yield();
+        }
+    }
+    
     //! STEP 10: Set final logical position to 0 for all axes
+    //? Each switch is at 0 in the current frame, so after re-zeroing it sits at -position
+    for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+        g_expectedSwitchPos[i] = -axes[i].stepper->getCurrentPosition();
+    }
     Serial.println("Setting logical positions to 0.");
     _stepperX->setCurrentPosition(0);
     _stepperY_Left->setCurrentPosition(0);
@@ -310,6 +547,7 @@ bool Homing::homeAllAxes() {
     
     //! STEP 11: Homing completed successfully
     Serial.println("Homing sequence completed successfully.");
+    reportHomingDurations(axes, rotation.homed ? rotation.doneMs - rotation.startMs : 0, millis() - homingStartMs);
     
     //! Restore Default Accelerations
     Serial.println("Restoring default accelerations...");
@@ -321,12 +559,13 @@ bool Homing::homeAllAxes() {
         rotationStepper->setAcceleration(DEFAULT_ROT_ACCEL); // Restore rotation accel too
     }
 
-    bool allPhysicalAxesHomed = xHomed && yLeftHomed && yRightHomed && zHomed;
+    bool allPhysicalAxesHomed = xHomed && yLeftHomed && yRightHomed && zHomed && gantrySquare;
+    g_homingReferenceValid = allPhysicalAxesHomed;
 
     if (allPhysicalAxesHomed) { // Check physical axes
-        if (rotationStepper && !rotationActuallyHomed) {
+        if (rotationStepper && !rotation.homed) {
              Serial.println("Warning: Physical axes (X,Y,Z) homed, but rotation motor exists and was not homed (should not happen if no error).");
-        } else if (rotationStepper && rotationActuallyHomed) {
+        } else if (rotationStepper && rotation.homed) {
             Serial.println("All axes (X,Y,Z and Rotation) homed successfully.");
         } else {
             Serial.println("All physical axes (X,Y,Z) homed successfully. No rotation motor or it was not homed.");
@@ -352,6 +591,9 @@ bool Homing::homeAllAxes() {
         
         // Wait for all steppers to complete the move
         while (_stepperX->isRunning() || _stepperY_Left->isRunning() || _stepperY_Right->isRunning() || _stepperZ->isRunning()) {
+            if (stopInputReceived()) {
+                return false;
+            }
             yield(); // Allow other tasks to run
         }
         
@@ -369,6 +611,116 @@ bool Homing::homeAllAxes() {
     return allPhysicalAxesHomed; // Return status of X,Y,Z. Rotation is best-effort or assumed done.
 }
 
+//* ************************************************************************
+//* **************************** VERIFY HOME *******************************
+//* ************************************************************************
+// Short re-home for after a job: rapid to just short of each switch, creep
+// onto it and compare the trigger with where the last homing left it.
+
+bool Homing::verifyHome() {
+    PhaseScope homing(PHASE_HOMING);
+    if (!isHomingReferenceValid()) {
+        Serial.println("Verify home: no valid homing reference - running full homing.");
+        return homeAllAxes();
+    }
+
+    Serial.println("Starting Verify Home sequence...");
+    unsigned long verifyStartMs = millis();
+    if (rotationStepper) {
+        rotationStepper->setMaxSpeed(DEFAULT_ROT_SPEED / 2); //? Half speed for homing
+        rotationStepper->setAcceleration(DEFAULT_ROT_ACCEL / 2); //? Half acceleration for homing
+    }
+
+    _verifyMode = true;
+    HomingAxis axes[HOMING_AXIS_COUNT];
+    startAllAxesHoming(axes);
+    RotationHoming rotation = { false, false, 0, 0 };
+    bool finished = runAxesToSwitches(axes, rotation);
+    _verifyMode = false;
+    if (!finished && _stopped) {
+        return false;
+    }
+    if (!finished) {
+        Serial.println("Verify home: timed out - running full homing.");
+        return homeAllAxes();
+    }
+
+    //! Compare each trigger with the expected switch position
+    bool withinTolerance = true;
+    String drifts = "";
+    for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+        long drift = axes[i].slowTripPos - axes[i].expectedSwitchPos;
+        if (labs(drift) > VERIFY_HOME_TOLERANCE_STEPS) {
+            withinTolerance = false;
+        }
+        Serial.printf("  %s switch at %ld, expected %ld: drift %ld steps (%.4f in)\n", axes[i].name,
+                      axes[i].slowTripPos, axes[i].expectedSwitchPos, drift, (float)drift / STEPS_PER_INCH_XYZ);
+        drifts += ",";
+        drifts += kHomingAxisKeys[i];
+        drifts += "=";
+        drifts += drift;
+    }
+
+    if (!withinTolerance) {
+        Serial.printf("Verify home: drift beyond %d steps - falling back to full homing.\n", VERIFY_HOME_TOLERANCE_STEPS);
+        webSocket.broadcastTXT("VERIFY_HOME:DRIFT" + drifts);
+        invalidateHomingReference();
+        return homeAllAxes();
+    }
+
+    //! Within tolerance: re-zero so each switch is exactly where homing put it
+    for (int i = 0; i < HOMING_AXIS_COUNT; i++) {
+        long sinceTrigger = axes[i].stepper->getCurrentPosition() - axes[i].slowTripPos;
+        axes[i].stepper->setCurrentPosition(axes[i].expectedSwitchPos + sinceTrigger);
+    }
+
+    //! Return to 0 at normal speeds
+    _stepperX->setAcceleration(DEFAULT_X_ACCEL);
+    _stepperY_Left->setAcceleration(DEFAULT_Y_ACCEL);
+    _stepperY_Right->setAcceleration(DEFAULT_Y_ACCEL);
+    _stepperZ->setAcceleration(DEFAULT_Z_ACCEL);
+    _stepperX->setSpeedInHz(DEFAULT_X_SPEED);
+    _stepperY_Left->setSpeedInHz(DEFAULT_Y_SPEED);
+    _stepperY_Right->setSpeedInHz(DEFAULT_Y_SPEED);
+    _stepperZ->setSpeedInHz(DEFAULT_Z_SPEED);
+    _stepperX->moveTo(0);
+    _stepperY_Left->moveTo(0);
+    _stepperY_Right->moveTo(0);
+    _stepperZ->moveTo(0);
+    while (_stepperX->isRunning() || _stepperY_Left->isRunning() || _stepperY_Right->isRunning() || _stepperZ->isRunning()) {
+        if (stopInputReceived()) {
+            return false;
+        }
+        yield();
+    }
+    if (rotationStepper) {
+        rotationStepper->setAcceleration(DEFAULT_ROT_ACCEL);
+    }
+
+    Serial.println("Verify home passed - axes re-zeroed without full homing.");
+    webSocket.broadcastTXT("VERIFY_HOME:OK" + drifts);
+    reportHomingDurations(axes, rotation.homed ? rotation.doneMs - rotation.startMs : 0, millis() - verifyStartMs);
+    return true;
+}
+
+void setVerifyHomeAfterJobs(bool enabled) {
+    g_verifyHomeAfterJobs = enabled;
+    persistence.beginTransaction(false);
+    persistence.saveBool(VERIFY_HOME_KEY, enabled);
+    persistence.endTransaction();
+}
+
+bool isVerifyHomeAfterJobsEnabled() {
+    return g_verifyHomeAfterJobs;
+}
+
+void loadHomingSettingsFromNVS() {
+    persistence.beginTransaction(true);
+    g_verifyHomeAfterJobs = persistence.loadBool(VERIFY_HOME_KEY, DEFAULT_VERIFY_HOME_AFTER_JOBS);
+    persistence.endTransaction();
+    Serial.printf("Verify home after jobs: %s\n", g_verifyHomeAfterJobs ? "enabled" : "disabled");
+}
+
 // REMOVED individual homing functions like homeZ() as they were placeholders/not declared in Homing.h
 // If needed, they should be declared in the header and implemented properly.
 /*
@@ -0,0 +1,146 @@
+#include "motors/LimitSwitches.h"
+#include "motors/LimitLatch.h"
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+#include <WebSocketsServer.h>
+#include "utils/settings.h"
+#include "hardware/FastGPIO.h"
+#include "hardware/paintGun_Functions.h"
+#include "motors/StopAll.h"
+#include "motors/Homing.h"
+#include "system/StateMachine.h"
+#include "system/GlobalState.h"
+
+extern FastAccelStepper *stepperX;
+extern FastAccelStepper *stepperY_Left;
+extern FastAccelStepper *stepperY_Right;
+extern FastAccelStepper *stepperZ;
+extern WebSocketsServer webSocket;
+extern StateMachine* stateMachine;
+
+static LimitLatch g_limitLatch = { false, 0, 0 };
+
+//* ************************************************************************
+//* *************************** LIMIT INTERRUPTS ***************************
+//* ************************************************************************
+// Kept to a level check, the gun register write and the latch; the axes are
+// stopped by serviceLimitSwitches(). Switches read HIGH when triggered.
+
+static inline void IRAM_ATTR handleLimitEdge(uint8_t pin, uint8_t faultBit) {
+    if (limitLatchEdge(g_limitLatch, faultBit, fastInputRead(pin) == HIGH)) {
+        paintGun_ForceOffFromISR();
+    }
+}
+
+static void IRAM_ATTR limitX_ISR() {
+    handleLimitEdge(X_HOME_SWITCH, LIMIT_FAULT_X);
+}
+
+static void IRAM_ATTR limitY_Left_ISR() {
+    handleLimitEdge(Y_LEFT_HOME_SWITCH, LIMIT_FAULT_Y_LEFT);
+}
+
+static void IRAM_ATTR limitY_Right_ISR() {
+    handleLimitEdge(Y_RIGHT_HOME_SWITCH, LIMIT_FAULT_Y_RIGHT);
+}
+
+static void IRAM_ATTR limitZ_ISR() {
+    handleLimitEdge(Z_HOME_SWITCH, LIMIT_FAULT_Z);
+}
+
+void initializeLimitSwitchMonitor() {
+    attachInterrupt(digitalPinToInterrupt(X_HOME_SWITCH), limitX_ISR, RISING);
+    attachInterrupt(digitalPinToInterrupt(Y_LEFT_HOME_SWITCH), limitY_Left_ISR, RISING);
+    attachInterrupt(digitalPinToInterrupt(Y_RIGHT_HOME_SWITCH), limitY_Right_ISR, RISING);
+    attachInterrupt(digitalPinToInterrupt(Z_HOME_SWITCH), limitZ_ISR, RISING);
+    g_limitLatch.armed = true;
+    Serial.println("Limit switch interrupts attached and armed");
+}
+
+//* ************************************************************************
+//* ************************** ARMING / FAULT STATE ************************
+//* ************************************************************************
+
+void setLimitMonitoringEnabled(bool enabled) {
+    g_limitLatch.armed = enabled;
+    Serial.printf("Limit switch monitoring %s\n", enabled ? "ARMED" : "DISARMED");
+}
+
+bool isLimitMonitoringEnabled() {
+    return g_limitLatch.armed;
+}
+
+void latchLimitFault(uint8_t faultMask) {
+    noInterrupts();
+    g_limitLatch.faultMask |= faultMask;
+    interrupts();
+}
+
+bool isLimitFaultLatched() {
+    return g_limitLatch.faultMask != 0;
+}
+
+uint8_t getLimitFaultMask() {
+    return g_limitLatch.faultMask;
+}
+
+String limitFaultMaskToString(uint8_t faultMask) {
+    String axes = "";
+    if (faultMask & LIMIT_FAULT_X) axes += "X,";
+    if (faultMask & LIMIT_FAULT_Y_LEFT) axes += "Y_LEFT,";
+    if (faultMask & LIMIT_FAULT_Y_RIGHT) axes += "Y_RIGHT,";
+    if (faultMask & LIMIT_FAULT_Z) axes += "Z,";
+    if (faultMask & LIMIT_FAULT_Y_RACKED) axes += "Y_RACKED,";
+    if (axes.length() > 0) {
+        axes.remove(axes.length() - 1); // Trailing comma
+    }
+    return axes;
+}
+
+//* ************************************************************************
+//* ************************** TASK-LEVEL SERVICE **************************
+//* ************************************************************************
+
+bool serviceLimitSwitches() {
+    uint8_t newFaults = limitLatchTakeNew(g_limitLatch);
+    if (g_limitLatch.faultMask == 0) {
+        return false;
+    }
+    if (newFaults == 0) {
+        return true;
+    }
+
+    //! The ISR only latched the fault - every axis stops here, so the gantry cannot rack
+    stopAllAxes();
+    invalidateHomingReference(); // A stalled or racked axis may have lost steps
+    paintGun_ForceOffFromISR(); // Already off from the ISR; keeps the state in sync
+    webSocket.broadcastTXT("PAINT_GUN_STATUS:OFF");
+
+    String axes = limitFaultMaskToString(g_limitLatch.faultMask);
+    Serial.printf("!!! LIMIT SWITCH FAULT: %s - all axes stopped !!!\n", axes.c_str());
+    Serial.printf("Positions at fault - X:%ld Y_L:%ld Y_R:%ld Z:%ld\n",
+                  stepperX->getCurrentPosition(), stepperY_Left->getCurrentPosition(),
+                  stepperY_Right->getCurrentPosition(), stepperZ->getCurrentPosition());
+    String message = "LIMIT_FAULT:";
+    message += axes;
+    webSocket.broadcastTXT(message);
+
+    if (stateMachine && stateMachine->getCurrentState() != stateMachine->getErrorState()) {
+        stateMachine->changeState(stateMachine->getErrorState());
+    }
+    return true;
+}
+
+void clearLimitFault() {
+    // An axis stopped by its switch usually still sits on it; the RISING edge
+    // will not re-fire, and homing (the only way out of ErrorState) backs off.
+    if (digitalRead(X_HOME_SWITCH) == HIGH || digitalRead(Y_LEFT_HOME_SWITCH) == HIGH ||
+        digitalRead(Y_RIGHT_HOME_SWITCH) == HIGH || digitalRead(Z_HOME_SWITCH) == HIGH) {
+        Serial.println("Limit fault cleared with a limit switch still active - homing will back off it");
+    }
+    noInterrupts();
+    limitLatchClear(g_limitLatch);
+    interrupts();
+    Serial.println("Limit fault cleared");
+    webSocket.broadcastTXT("LIMIT_FAULT:CLEARED");
+}
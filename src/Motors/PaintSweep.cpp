@@ -0,0 +1,446 @@
+#include "motors/PaintSweep.h"
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+#include "utils/settings.h"
+#include "system/GlobalState.h"
+#include "hardware/paintGun_Functions.h"
+#include "hardware/GunLatency.h"
+#include "hardware/controlPanel_Functions.h"
+#include "web/Web_Dashboard_Commands.h"
+#include "motors/LimitSwitches.h"
+#include "motors/GantrySync.h"
+#include "motors/StopAll.h"
+#include "motors/Homing.h"
+#include "system/StateMachine.h"
+#include "system/machine_state.h"
+#include "system/CycleEstimator.h"
+#include "system/PhaseStats.h"
+#include <WebSocketsServer.h>
+
+extern FastAccelStepper *stepperX;
+extern FastAccelStepper *stepperY_Left;
+extern FastAccelStepper *stepperY_Right;
+extern WebSocketsServer webSocket;
+extern StateMachine* stateMachine;
+
+static PaintSweepPauseRecord g_lastSweepPause = {0, 0, false, false};
+static volatile int g_feedOverridePercent = FEED_OVERRIDE_DEFAULT_PERCENT;
+
+//* ************************************************************************
+//* ************************* AXIS HELPERS *********************************
+//* ************************************************************************
+// Y sweeps always drive both gantry motors; Y_Left is used as the position
+// reference since both are commanded identically.
+
+static void sweepAxisMoveTo(PaintSweepAxis axis, long position, long speedHz) {
+    // Speed must be set before moveTo(); FastAccelStepper only applies a new
+    // speed on the next move command.
+    if (axis == SWEEP_AXIS_X) {
+        stepperX->setSpeedInHz(speedHz);
+        stepperX->moveTo(position);
+    } else {
+        stepperY_Left->setSpeedInHz(speedHz);
+        stepperY_Right->setSpeedInHz(speedHz);
+        stepperY_Left->moveTo(position);
+        stepperY_Right->moveTo(position);
+    }
+}
+
+// Changes the speed of a move already in progress
+static void sweepAxisUpdateSpeed(PaintSweepAxis axis, long speedHz) {
+    if (axis == SWEEP_AXIS_X) {
+        stepperX->setSpeedInHz(speedHz);
+        stepperX->applySpeedAcceleration();
+    } else {
+        stepperY_Left->setSpeedInHz(speedHz);
+        stepperY_Right->setSpeedInHz(speedHz);
+        stepperY_Left->applySpeedAcceleration();
+        stepperY_Right->applySpeedAcceleration();
+    }
+}
+
+static void sweepAxisDecelerate(PaintSweepAxis axis) {
+    // stopMove() ramps down with the configured acceleration (unlike forceStop)
+    if (axis == SWEEP_AXIS_X) {
+        stepperX->stopMove();
+    } else {
+        stepperY_Left->stopMove();
+        stepperY_Right->stopMove();
+    }
+}
+
+static bool sweepAxisIsRunning(PaintSweepAxis axis) {
+    if (axis == SWEEP_AXIS_X) {
+        return stepperX->isRunning();
+    }
+    return stepperY_Left->isRunning() || stepperY_Right->isRunning();
+}
+
+static long sweepAxisPosition(PaintSweepAxis axis) {
+    return (axis == SWEEP_AXIS_X) ? stepperX->getCurrentPosition() : stepperY_Left->getCurrentPosition();
+}
+
+// Actual speed right now, including ramps (steps/sec)
+static long sweepAxisSpeedHz(PaintSweepAxis axis) {
+    FastAccelStepper* stepper = (axis == SWEEP_AXIS_X) ? stepperX : stepperY_Left;
+    return labs((long)stepper->getCurrentSpeedInMilliHz()) / 1000L;
+}
+
+static long sweepAxisTravelSpeed(PaintSweepAxis axis) {
+    return (axis == SWEEP_AXIS_X) ? DEFAULT_X_SPEED : DEFAULT_Y_SPEED;
+}
+
+// Distance (steps) needed to reach speedHz from standstill, plus a small margin
+static long sweepAxisRunUpDistance(PaintSweepAxis axis, long speedHz) {
+    float accel = (axis == SWEEP_AXIS_X) ? (float)DEFAULT_X_ACCEL : (float)DEFAULT_Y_ACCEL;
+    float rampSteps = ((float)speedHz * (float)speedHz) / (2.0f * accel);
+    return (long)rampSteps + (long)(PAUSE_RESUME_LEAD_IN_MARGIN_INCH * STEPS_PER_INCH_XYZ);
+}
+
+static bool sweepPauseRequested() {
+    return digitalRead(MODIFIER_BUTTON_RIGHT) == LOW || isPaused;
+}
+
+//! Stop input, HOME (panel or dashboard), a limit fault, or the state machine
+//! leaving the sweep's state - a dashboard HOME switches to HomingState, whose
+//! enter() clears the flag before the sweep sees it
+static bool sweepAbortRequested(State* sweepState) {
+    serviceStopAll();
+    if (serviceLimitSwitches()) {
+        return true;
+    }
+    if (homeCommandReceived || physicalHomeButtonPressed) {
+        return true;
+    }
+    return stateMachine && stateMachine->getCurrentState() != sweepState;
+}
+
+// Waits out a travel move or deceleration, still watching for an abort.
+// Returns false, with the axes already stopped, if one came in.
+static bool waitForSweepAxisStop(PaintSweepAxis axis, State* sweepState) {
+    while (sweepAxisIsRunning(axis)) {
+        if (sweepAbortRequested(sweepState)) {
+            stopAllAxes();
+            return false;
+        }
+        processWebSocketEventsFrequently();
+        delay(1);
+    }
+    return true;
+}
+
+//* ************************************************************************
+//* ************************** FEED OVERRIDE *******************************
+//* ************************************************************************
+
+int setFeedOverridePercent(int percent) {
+    g_feedOverridePercent = constrain(percent, FEED_OVERRIDE_MIN_PERCENT, FEED_OVERRIDE_MAX_PERCENT);
+    Serial.printf("Feed override set to %d%%\n", g_feedOverridePercent);
+    return g_feedOverridePercent;
+}
+
+int getFeedOverridePercent() {
+    return g_feedOverridePercent;
+}
+
+long applyFeedOverride(long speedHz) {
+    return (speedHz * (long)g_feedOverridePercent) / 100L;
+}
+
+void handleFeedOverrideButtons() {
+    // Sweeps block loop(), so the panel is polled from inside the sweep
+    updateControlPanelButtons();
+    if (!isModifierCenterPressed()) {
+        return;
+    }
+
+    int percent = g_feedOverridePercent;
+    switch (getTriggeredAction()) {
+        case ACTION_LEFT:   percent -= FEED_OVERRIDE_STEP_PERCENT; break;
+        case ACTION_RIGHT:  percent += FEED_OVERRIDE_STEP_PERCENT; break;
+        case ACTION_CENTER: percent = FEED_OVERRIDE_DEFAULT_PERCENT; break;
+        default: return;
+    }
+
+    String message = "FEED_OVERRIDE:";
+    message += setFeedOverridePercent(percent);
+    webSocket.broadcastTXT(message);
+}
+
+//* ************************************************************************
+//* ************************** PAINT SWEEP *********************************
+//* ************************************************************************
+
+PaintSweep makePaintSweep(PaintSweepAxis axis, long startPos, long targetPos, long speedHz,
+                          float gunStartMarginInches, float gunStopMarginInches, const char* tag) {
+    PaintSweep sweep;
+    long length = labs(targetPos - startPos);
+    sweep.axis = axis;
+    sweep.startPos = startPos;
+    sweep.targetPos = targetPos;
+    sweep.speedHz = speedHz;
+    sweep.gunOnOffset = (long)(gunStartMarginInches * STEPS_PER_INCH_XYZ);
+    sweep.gunOffOffset = length - (long)(gunStopMarginInches * STEPS_PER_INCH_XYZ);
+    sweep.windowCount = 1;
+    sweep.windows[0].onOffset = sweep.gunOnOffset;
+    sweep.windows[0].offOffset = sweep.gunOffOffset;
+    sweep.tag = tag;
+    return sweep;
+}
+
+static bool progressInGunWindow(const PaintSweep& sweep, long progress) {
+    for (int i = 0; i < sweep.windowCount; i++) {
+        if (progress >= sweep.windows[i].onOffset && progress < sweep.windows[i].offOffset) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// First progress at or after gate that still needs paint; -1 if none
+static long firstUnpaintedProgress(const PaintSweep& sweep, long gate) {
+    for (int i = 0; i < sweep.windowCount; i++) {
+        if (gate < sweep.windows[i].offOffset) {
+            return max(gate, sweep.windows[i].onOffset);
+        }
+    }
+    return -1;
+}
+
+PaintSweep trimPaintSweepToWindows(const PaintSweep& sweep) {
+    if (sweep.windowCount == 0) {
+        return sweep;
+    }
+    const long direction = (sweep.targetPos >= sweep.startPos) ? 1 : -1;
+    long length = labs(sweep.targetPos - sweep.startPos);
+    long rampSteps = sweepAxisRunUpDistance(sweep.axis, (sweep.speedHz * FEED_OVERRIDE_MAX_PERCENT) / 100L);
+    long startOffset = max(0L, sweep.windows[0].onOffset - rampSteps);
+    long endOffset = min(length, sweep.windows[sweep.windowCount - 1].offOffset + rampSteps);
+    if (startOffset == 0 && endOffset == length) {
+        return sweep;
+    }
+
+    PaintSweep trimmed = sweep;
+    trimmed.startPos = sweep.startPos + startOffset * direction;
+    trimmed.targetPos = sweep.startPos + endOffset * direction;
+    trimmed.gunOnOffset = max(0L, sweep.gunOnOffset - startOffset);
+    trimmed.gunOffOffset = sweep.gunOffOffset - startOffset;
+    for (int i = 0; i < trimmed.windowCount; i++) {
+        trimmed.windows[i].onOffset -= startOffset;
+        trimmed.windows[i].offOffset -= startOffset;
+    }
+    Serial.printf("%s: Sweep trimmed to %ld..%ld (saves %.2f in)\n", sweep.tag, trimmed.startPos,
+                  trimmed.targetPos, (length - (endOffset - startOffset)) / STEPS_PER_INCH_XYZ);
+    return trimmed;
+}
+
+const PaintSweepPauseRecord& getLastPaintSweepPause() {
+    return g_lastSweepPause;
+}
+
+static bool runPaintSweepMotion(const PaintSweep& sweep) {
+    State* sweepState = stateMachine ? stateMachine->getCurrentState() : nullptr;
+    if (isLimitFaultLatched()) {
+        Serial.printf("%s: Sweep skipped - limit fault latched\n", sweep.tag);
+        return false;
+    }
+    if (!isHomingReferenceValid()) {
+        Serial.printf("%s: Sweep refused - axes not homed\n", sweep.tag);
+        return false;
+    }
+
+    if (sweep.windowCount == 0) {
+        Serial.printf("%s: Sweep skipped - nothing to paint\n", sweep.tag);
+        return true;
+    }
+    if (sweepAxisPosition(sweep.axis) != sweep.startPos) {
+        sweepAxisMoveTo(sweep.axis, sweep.startPos, sweepAxisTravelSpeed(sweep.axis));
+        if (!waitForSweepAxisStop(sweep.axis, sweepState) || sweepAbortRequested(sweepState)) {
+            stopAllAxes();
+            Serial.printf("%s: Sweep aborted before start\n", sweep.tag);
+            return false;
+        }
+    }
+
+    const long direction = (sweep.targetPos >= sweep.startPos) ? 1 : -1;
+    // Gun stays closed until the sweep has progressed past this point. After a
+    // pause it is moved to where the gun closed so the gun reopens exactly there.
+    long resumeGate = 0;
+    bool gunOn = false;
+    // Windows before this one are finished; closing at a far edge advances it,
+    // so a shrinking close lead can never reopen a window
+    int windowIndex = 0;
+    int appliedOverride = getFeedOverridePercent();
+    long speedHz = applyFeedOverride(sweep.speedHz);
+    const GunLatency& latency = getGunLatency();
+
+    sweepAxisMoveTo(sweep.axis, sweep.targetPos, speedHz);
+
+    while (sweepAxisIsRunning(sweep.axis)) {
+        long position = sweepAxisPosition(sweep.axis);
+        long progress = (position - sweep.startPos) * direction;
+
+        //! Checked before the pause: the stop combination holds Modifier Right too
+        if (sweepAbortRequested(sweepState)) {
+            paintGun_OFF();
+            stopAllAxes();
+            Serial.printf("%s: Sweep aborted at %ld\n", sweep.tag, position);
+            return false;
+        }
+
+        handleFeedOverrideButtons();
+        if (appliedOverride != getFeedOverridePercent()) {
+            appliedOverride = getFeedOverridePercent();
+            speedHz = applyFeedOverride(sweep.speedHz);
+            sweepAxisUpdateSpeed(sweep.axis, speedHz);
+            Serial.printf("%s: Feed override %d%% -> %ld Hz\n", sweep.tag, appliedOverride, speedHz);
+        }
+
+        if (sweepPauseRequested()) {
+            //! Close the gun first, then ramp down along the path
+            bool gunWasOn = gunOn;
+            if (gunOn) {
+                paintGun_OFF();
+                gunOn = false;
+            }
+            sweepAxisDecelerate(sweep.axis);
+            if (!waitForSweepAxisStop(sweep.axis, sweepState)) {
+                Serial.printf("%s: Sweep aborted while pausing\n", sweep.tag);
+                return false; // Gun already closed
+            }
+
+            g_lastSweepPause.pausePos = position;
+            g_lastSweepPause.stopPos = sweepAxisPosition(sweep.axis);
+            g_lastSweepPause.gunWasOn = gunWasOn;
+            g_lastSweepPause.inGunWindow = progressInGunWindow(sweep, progress);
+            Serial.printf("%s: Sweep paused at %ld (stopped at %ld), gun was %s\n",
+                          sweep.tag, g_lastSweepPause.pausePos, g_lastSweepPause.stopPos,
+                          gunWasOn ? "ON" : "OFF");
+
+            while (sweepPauseRequested()) {
+                if (sweepAbortRequested(sweepState)) {
+                    stopAllAxes();
+                    Serial.printf("%s: Sweep aborted while paused - not resuming\n", sweep.tag);
+                    return false; // Gun already closed
+                }
+                handleFeedOverrideButtons();
+                processWebSocketEventsFrequently();
+                delay(PAUSE_POLL_INTERVAL_MS);
+            }
+            if (sweepAbortRequested(sweepState)) {
+                stopAllAxes();
+                Serial.printf("%s: Sweep aborted on resume\n", sweep.tag);
+                return false;
+            }
+
+            if (progress > resumeGate) {
+                resumeGate = progress;
+            }
+
+            // Pick up any override change made while paused - the run-up below
+            // is sized for the speed the sweep resumes at
+            appliedOverride = getFeedOverridePercent();
+            speedHz = applyFeedOverride(sweep.speedHz);
+
+            //? Back up so the axis is at painting speed again when it reaches the
+            //? first position that still needs paint
+            long firstUnpainted = firstUnpaintedProgress(sweep, resumeGate);
+            if (firstUnpainted >= 0) {
+                long runUpProgress = max(0L, firstUnpainted - sweepAxisRunUpDistance(sweep.axis, speedHz));
+                long stopProgress = (sweepAxisPosition(sweep.axis) - sweep.startPos) * direction;
+                if (stopProgress > runUpProgress) {
+                    long runUpPos = sweep.startPos + runUpProgress * direction;
+                    Serial.printf("%s: Backing up to %ld before resuming\n", sweep.tag, runUpPos);
+                    sweepAxisMoveTo(sweep.axis, runUpPos, sweepAxisTravelSpeed(sweep.axis));
+                    if (!waitForSweepAxisStop(sweep.axis, sweepState)) {
+                        Serial.printf("%s: Sweep aborted while backing up\n", sweep.tag);
+                        return false;
+                    }
+                }
+            }
+
+            sweepAxisMoveTo(sweep.axis, sweep.targetPos, speedHz);
+            if (firstUnpainted >= 0) {
+                Serial.printf("%s: Sweep resumed, gun reopens at %ld\n",
+                              sweep.tag, sweep.startPos + firstUnpainted * direction);
+            } else {
+                Serial.printf("%s: Sweep resumed, nothing left to paint\n", sweep.tag);
+            }
+            continue;
+        }
+
+        //? Fire each edge early by the distance the axis covers during the gun's latency
+        long speedNow = sweepAxisSpeedHz(sweep.axis);
+        long openLead = gunLeadSteps(latency.openMs, speedNow);
+        long closeLead = gunLeadSteps(latency.closeMs, speedNow);
+        bool gunWanted = false;
+        while (windowIndex < sweep.windowCount) {
+            const PaintGunWindow& window = sweep.windows[windowIndex];
+            long openAt = max(window.onOffset, resumeGate) - openLead;
+            long closeAt = window.offOffset - closeLead;
+            if (progress < closeAt) {
+                gunWanted = progress >= openAt;
+                break;
+            }
+            // Past this window's close edge: close the gun if it was painting
+            // it, or skip a window that was painted before a pause
+            if (gunOn) {
+                paintGun_OFF();
+                gunOn = false;
+            }
+            windowIndex++;
+        }
+        if (gunWanted && !gunOn) {
+            paintGun_ON();
+            gunOn = true;
+        } else if (!gunWanted && gunOn) {
+            paintGun_OFF();
+            gunOn = false;
+        }
+
+        servicePaintGun();
+
+        // The limit interrupt / sync check has already stopped the axis; leave the gun closed
+        if (sweep.axis == SWEEP_AXIS_Y) {
+            checkGantrySync();
+        }
+        processWebSocketEventsFrequently();
+        delay(1);
+    }
+
+    if (gunOn) {
+        paintGun_OFF();
+    }
+    //? A limit or stop that ended the move early is reported as an abort
+    if (sweepAbortRequested(sweepState)) {
+        Serial.printf("%s: Sweep ended by a stop or fault\n", sweep.tag);
+        return false;
+    }
+    return true;
+}
+
+bool runPaintSweep(const PaintSweep& sweep) {
+    bool completed;
+    {
+        PhaseScope paint(PHASE_PAINT);
+        completed = runPaintSweepMotion(sweep);
+    }
+    if (completed) {
+        noteCycleSweepDone(); // Skipped sweeps count too - they are in the toolpath model
+    }
+    return completed;
+}
+
+void abortPaintSide(const char* tag) {
+    Serial.printf("%s: Sweep aborted - abandoning the side\n", tag);
+    paintGun_OFF();
+    stopAllAxes();
+    //? A limit fault has already sent the machine to ErrorState
+    if (!stateMachine || isLimitFaultLatched()) {
+        return;
+    }
+    State* current = stateMachine->getCurrentState();
+    if (current != stateMachine->getHomingState() && current != stateMachine->getErrorState()) {
+        stateMachine->changeState(stateMachine->getHomingState());
+    }
+}
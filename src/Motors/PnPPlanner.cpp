@@ -0,0 +1,165 @@
+#include "motors/PnPPlanner.h"
+#include <Arduino.h>
+#include "utils/settings.h"
+#include "motors/Toolpath.h"
+#include "storage/TrayDefinitions.h"
+#include "storage/Persistence.h"
+
+#define PNP_FAR_ROWS_FIRST_KEY "pnpFarRows"
+
+extern float g_pnp_x_speed, g_pnp_y_speed;
+
+static bool g_farRowsFirst = false;
+
+//* ************************************************************************
+//* ***************************** SETTINGS *********************************
+//* ************************************************************************
+
+void setPnPFarRowsFirst(bool enabled) {
+    g_farRowsFirst = enabled;
+    persistence.beginTransaction(false);
+    persistence.saveInt(PNP_FAR_ROWS_FIRST_KEY, enabled ? 1 : 0);
+    persistence.endTransaction();
+    Serial.printf("PnP far rows first %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool isPnPFarRowsFirst() {
+    return g_farRowsFirst;
+}
+
+void loadPnPPlannerFromNVS() {
+    persistence.beginTransaction(true);
+    g_farRowsFirst = persistence.loadInt(PNP_FAR_ROWS_FIRST_KEY, 0) != 0;
+    persistence.endTransaction();
+    Serial.printf("PnP far rows first loaded: %s\n", g_farRowsFirst ? "enabled" : "disabled");
+}
+
+//* ************************************************************************
+//* ***************************** MOVE TIMES *******************************
+//* ************************************************************************
+
+static float travelSeconds(long fromX, long fromY, long toX, long toY, float xSpeed, float ySpeed) {
+    float tx = estimateAxisMoveSeconds(toX - fromX, xSpeed, DEFAULT_X_ACCEL);
+    float ty = estimateAxisMoveSeconds(toY - fromY, ySpeed, DEFAULT_Y_ACCEL);
+    return max(tx, ty);
+}
+
+struct PlanLegs {
+    float outbound[TRAY_MAX_POSITIONS + 1]; // pick -> place
+    float back[TRAY_MAX_POSITIONS + 1];     // place -> pick
+    float finish[TRAY_MAX_POSITIONS + 1];   // place -> painting start
+    float pickToFinish;
+};
+
+static float orderSeconds(const PlanLegs& legs, const int* order, int count, bool returnAfterLast) {
+    float total = 0.0f;
+    for (int i = 0; i < count; i++) {
+        int pos = order[i];
+        total += legs.outbound[pos];
+        if (i < count - 1) {
+            total += legs.back[pos];
+        } else if (returnAfterLast) {
+            total += legs.back[pos] + legs.pickToFinish;
+        } else {
+            total += legs.finish[pos];
+        }
+    }
+    return total;
+}
+
+//* ************************************************************************
+//* ******************************* PLANNER ********************************
+//* ************************************************************************
+
+void planPnPPlacementOrder(PnPPlacementPlan& plan, long pickX, long pickY, long finishX, long finishY) {
+    PlanLegs legs;
+    long rowDistance[TRAY_MAX_POSITIONS + 1];
+    int rowMajor[TRAY_MAX_POSITIONS];
+    plan.count = 0;
+
+    for (int pos = 1; pos <= getTrayPositionCount(); pos++) {
+        if (isTrayPositionSkipped(pos)) {
+            continue;
+        }
+        long x, y;
+        getTrayPlacementSteps(pos, x, y);
+        legs.outbound[pos] = travelSeconds(pickX, pickY, x, y, DEFAULT_X_SPEED, DEFAULT_Y_SPEED);
+        legs.back[pos] = travelSeconds(x, y, pickX, pickY, g_pnp_x_speed, g_pnp_y_speed);
+        legs.finish[pos] = travelSeconds(x, y, finishX, finishY, DEFAULT_X_SPEED, DEFAULT_Y_SPEED);
+        rowDistance[pos] = labs(y - pickY);
+        rowMajor[plan.count] = pos;
+        plan.order[plan.count++] = pos;
+    }
+    legs.pickToFinish = travelSeconds(pickX, pickY, finishX, finishY, DEFAULT_X_SPEED, DEFAULT_Y_SPEED);
+
+    if (plan.count == 0) {
+        plan.plannedSeconds = plan.rowMajorSeconds = plan.finishSeconds = 0.0f;
+        return;
+    }
+
+    //! Constraint first: stable sort by row distance from pick, farthest first
+    if (g_farRowsFirst) {
+        for (int i = 1; i < plan.count; i++) {
+            int pos = plan.order[i];
+            int j = i - 1;
+            while (j >= 0 && rowDistance[plan.order[j]] < rowDistance[pos]) {
+                plan.order[j + 1] = plan.order[j];
+                j--;
+            }
+            plan.order[j + 1] = pos;
+        }
+    }
+
+    // Last-part candidates: the nearest row under the constraint, otherwise any position
+    int firstCandidate = 0;
+    if (g_farRowsFirst) {
+        long lastRow = rowDistance[plan.order[plan.count - 1]];
+        firstCandidate = plan.count - 1;
+        while (firstCandidate > 0 && rowDistance[plan.order[firstCandidate - 1]] == lastRow) {
+            firstCandidate--;
+        }
+    }
+
+    //! Ending at a position trades its return to pick for the move to the painting start
+    int best = plan.count - 1;
+    for (int i = firstCandidate; i < plan.count; i++) {
+        int pos = plan.order[i];
+        int bestPos = plan.order[best];
+        if (legs.finish[pos] - legs.back[pos] < legs.finish[bestPos] - legs.back[bestPos]) {
+            best = i;
+        }
+    }
+    int lastPos = plan.order[best];
+    for (int i = best; i < plan.count - 1; i++) {
+        plan.order[i] = plan.order[i + 1];
+    }
+    plan.order[plan.count - 1] = lastPos;
+
+    plan.plannedSeconds = orderSeconds(legs, plan.order, plan.count, false);
+    plan.rowMajorSeconds = orderSeconds(legs, rowMajor, plan.count, true);
+    plan.finishSeconds = legs.finish[lastPos];
+
+    String orderText;
+    for (int i = 0; i < plan.count; i++) {
+        if (i > 0) {
+            orderText += ",";
+        }
+        orderText += plan.order[i];
+    }
+    Serial.printf("PnP plan: order %s%s\n", orderText.c_str(), g_farRowsFirst ? " (far rows first)" : "");
+    Serial.printf("PnP plan: predicted travel %.2f s vs %.2f s row-major (saving %.2f s)\n",
+                  plan.plannedSeconds, plan.rowMajorSeconds, plan.rowMajorSeconds - plan.plannedSeconds);
+}
+
+void reportPnPPlanOutcome(const PnPPlacementPlan& plan, unsigned long measuredTravelMs) {
+    float predictedPnPSeconds = plan.plannedSeconds - plan.finishSeconds;
+    float predictedSaving = plan.rowMajorSeconds - plan.plannedSeconds;
+    if (predictedPnPSeconds <= 0.0f || measuredTravelMs == 0) {
+        return;
+    }
+    float ratio = (measuredTravelMs / 1000.0f) / predictedPnPSeconds;
+    Serial.printf("PnP plan: travel predicted %.2f s, measured %.2f s (x%.2f)\n",
+                  predictedPnPSeconds, measuredTravelMs / 1000.0f, ratio);
+    Serial.printf("PnP plan: saving predicted %.2f s, measured-scaled %.2f s\n",
+                  predictedSaving, predictedSaving * ratio);
+}
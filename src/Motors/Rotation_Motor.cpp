@@ -1,5 +1,7 @@
 #include "motors/Rotation_Motor.h"
 #include "utils/settings.h"
+#include "system/PhaseStats.h" // Rotation phase timing
+#include "motors/StopAll.h" // Stop input polled while the turntable moves
 
 // Define the global rotation stepper pointer
 AccelStepper *rotationStepper = NULL;
@@ -26,14 +28,16 @@ void setupRotationMotor() {
 }
 
 /**
- * Rotates the turntable to a specific angle
+ * Starts a shortest-path move of the turntable to a specific angle.
+ * Non-blocking: the caller must keep calling rotationStepper->run().
  * @param angle The target angle in degrees (0-360)
+ * @return false if the rotation stepper is not initialized
  */
-void rotateToAngle(float angle) {
+bool startRotationToAngle(float angle) {
     // Check if rotation stepper is initialized
     if (!rotationStepper) {
         Serial.println("ERROR: Rotation stepper not initialized!");
-        return;
+        return false;
     }
 
     // Get current position and angle
@@ -63,9 +67,38 @@ void rotateToAngle(float angle) {
 
     // Move to the target position
     rotationStepper->moveTo(targetPosition);
+    return true;
+}
+
+/**
+ * Polls the stop input from a blocking rotation loop. serviceStopAll() stops
+ * the linear axes; the turntable is halted here, without deceleration.
+ * @return true if the rotation must be abandoned
+ */
+static bool rotationStopRequested() {
+    if (!serviceStopAll()) {
+        return false;
+    }
+    rotationStepper->setCurrentPosition(rotationStepper->currentPosition()); // Zeroes speed and target
+    Serial.println("Stop input: rotation halted");
+    return true;
+}
+
+/**
+ * Rotates the turntable to a specific angle
+ * @param angle The target angle in degrees (0-360)
+ */
+void rotateToAngle(float angle) {
+    PhaseScope rotate(PHASE_ROTATE);
+    if (!startRotationToAngle(angle)) {
+        return;
+    }
     
     // Run the stepper until it reaches the target position
     while (rotationStepper->distanceToGo() != 0) {
+        if (rotationStopRequested()) {
+            return;
+        }
         rotationStepper->run();
         // Remove delay(1) - it interferes with smooth acceleration
         // Use yield() instead to prevent watchdog timeout on ESP32
@@ -144,6 +177,9 @@ void manualRotateClockwise90() {
     
     // Run the stepper until it reaches the target
     while (rotationStepper->distanceToGo() != 0) {
+        if (rotationStopRequested()) {
+            break; // Tracking is still restored below
+        }
         rotationStepper->run();
         yield(); // Prevent watchdog timeout
     }
@@ -196,6 +232,9 @@ void manualRotateCounterClockwise90() {
     
     // Run the stepper until it reaches the target
     while (rotationStepper->distanceToGo() != 0) {
+        if (rotationStopRequested()) {
+            break; // Tracking is still restored below
+        }
         rotationStepper->run();
         yield(); // Prevent watchdog timeout
     }
@@ -0,0 +1,103 @@
+#include "motors/StopAll.h"
+#include <Arduino.h>
+#include <FastAccelStepper.h>
+#include <WebSocketsServer.h>
+#include "hardware/FastGPIO.h"
+#include "hardware/paintGun_Functions.h"
+#include "utils/settings.h"
+#include "system/machine_state.h"
+
+extern FastAccelStepper *stepperX;
+extern FastAccelStepper *stepperY_Left;
+extern FastAccelStepper *stepperY_Right;
+extern FastAccelStepper *stepperZ;
+extern WebSocketsServer webSocket;
+
+static volatile bool g_stopAllPending = false;
+static volatile unsigned long g_stopEdgeMicros = 0;
+static bool g_measureStopLatency = false;
+
+//* ************************************************************************
+//* ************************** AXIS GROUP STOP *****************************
+//* ************************************************************************
+
+void stopAllAxes() {
+    FastAccelStepper* axes[] = { stepperX, stepperY_Left, stepperY_Right, stepperZ };
+    for (FastAccelStepper* axis : axes) {
+        if (axis && axis->isRunning()) {
+            axis->forceStopAndNewPosition(axis->getCurrentPosition());
+        }
+    }
+}
+
+//* ************************************************************************
+//* *************************** STOP INTERRUPT *****************************
+//* ************************************************************************
+
+static void IRAM_ATTR stopAllISR() {
+    // Only the physical force-home combination stops the machine; the same
+    // action button is used with other modifiers for unrelated functions.
+    if (fastInputRead(STOP_ALL_QUALIFIER_PIN) != LOW) {
+        return;
+    }
+
+    //! Paint and vacuum off with register writes; the axes are stopped by
+    //! serviceStopAll() at task level - the stepper calls are not ISR-safe
+    paintGun_ForceOffFromISR();
+    fastOutputLow(SUCTION_PIN);
+
+    if (!g_stopAllPending) {
+        g_stopEdgeMicros = micros();
+    }
+    g_stopAllPending = true;
+    physicalHomeButtonPressed = true; // Existing abort paths take it from here
+}
+
+void initializeStopAllInterrupt() {
+    attachInterrupt(digitalPinToInterrupt(STOP_ALL_INPUT_PIN), stopAllISR, RISING);
+    Serial.printf("Stop-all interrupt attached (input %d, qualifier %d)\n", STOP_ALL_INPUT_PIN, STOP_ALL_QUALIFIER_PIN);
+}
+
+//* ************************************************************************
+//* ************************** TASK-LEVEL SERVICE **************************
+//* ************************************************************************
+
+static bool anyAxisRunning() {
+    return (stepperX && stepperX->isRunning()) ||
+           (stepperY_Left && stepperY_Left->isRunning()) ||
+           (stepperY_Right && stepperY_Right->isRunning()) ||
+           (stepperZ && stepperZ->isRunning());
+}
+
+bool serviceStopAll() {
+    if (!g_stopAllPending) {
+        return false;
+    }
+
+    stopAllAxes();
+    g_stopAllPending = false;
+
+    if (g_measureStopLatency) {
+        // The first poll where nothing is running marks the last step pulse
+        // (resolution = this poll loop)
+        unsigned long waitStart = micros();
+        while (anyAxisRunning() && (micros() - waitStart) < STOP_LATENCY_MAX_WAIT_US) {
+        }
+        unsigned long latency = micros() - g_stopEdgeMicros;
+        Serial.printf("STOP LATENCY: %lu us from input edge to last step pulse\n", latency);
+        String message = "STOP_LATENCY:";
+        message += latency;
+        webSocket.broadcastTXT(message);
+    }
+    Serial.println("Stop-all input: axes stopped, paint gun and vacuum off");
+    return true;
+}
+
+void setStopLatencyMeasurement(bool enabled) {
+    g_measureStopLatency = enabled;
+    Serial.printf("Stop latency measurement %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool isStopLatencyMeasurementEnabled() {
+    return g_measureStopLatency;
+}
@@ -0,0 +1,442 @@
+#include "motors/Toolpath.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "settings/motion.h"
+#include "settings/painting.h"
+
+//* ************************************************************************
+//* *************************** TIME ESTIMATES *****************************
+//* ************************************************************************
+
+float estimateAxisMoveSeconds(long distanceSteps, float speedHz, float accel) {
+    float distance = (float)labs(distanceSteps);
+    if (distance <= 0.0f || speedHz <= 0.0f || accel <= 0.0f) {
+        return 0.0f;
+    }
+    // Reaches full speed only if the two ramps fit inside the move
+    float rampDistance = (speedHz * speedHz) / accel;
+    if (distance >= rampDistance) {
+        return distance / speedHz + speedHz / accel;
+    }
+    return 2.0f * sqrtf(distance / accel); // Triangular profile
+}
+
+// AccelStepper, shortest path - same delta as startRotationToAngle()
+static float rotationDeltaDegrees(float fromAngle, float toAngle) {
+    float delta = toAngle - fromAngle;
+    while (delta > 180.0f) delta -= 360.0f;
+    while (delta <= -180.0f) delta += 360.0f;
+    return delta;
+}
+
+static long inchesToSteps(float inches) {
+    return (long)(inches * STEPS_PER_INCH_XYZ);
+}
+
+//* ************************************************************************
+//* ****************************** BUILDER *********************************
+//* ************************************************************************
+// Tracks where the machine would be and appends one segment per blocking move.
+
+struct ToolpathBuilder {
+    ToolpathSegment* segments;
+    int maxSegments;
+    ToolpathSummary* summary;
+    int side;
+    long x, y, z;
+    float angle;
+
+    ToolpathSegment* append(uint8_t type) {
+        if (summary->segmentCount >= maxSegments) {
+            summary->truncated = true;
+            return nullptr;
+        }
+        ToolpathSegment* segment = &segments[summary->segmentCount++];
+        segment->type = type;
+        segment->side = (uint8_t)side;
+        segment->x0 = x;
+        segment->y0 = y;
+        segment->z0 = z;
+        segment->angle0 = angle;
+        segment->angle1 = angle;
+        segment->gunOnOffset = 0;
+        segment->gunOffOffset = 0;
+        segment->speedHz = 0;
+        segment->seconds = 0.0f;
+        return segment;
+    }
+
+    void account(const ToolpathSegment* segment) {
+        summary->totalSeconds += segment->seconds;
+        summary->sideSeconds[segment->side - 1] += segment->seconds;
+        switch (segment->type) {
+            case TOOLPATH_TRAVEL: summary->travelSeconds += segment->seconds; break;
+            case TOOLPATH_PAINT:  summary->paintSeconds += segment->seconds; break;
+            case TOOLPATH_ROTATE: summary->rotateSeconds += segment->seconds; break;
+        }
+    }
+
+    // moveToXYZ(): all axes start together at their default speeds, so the slowest axis sets the time
+    void travelTo(long toX, long toY, long toZ) {
+        if (toX == x && toY == y && toZ == z) {
+            return;
+        }
+        ToolpathSegment* segment = append(TOOLPATH_TRAVEL);
+        if (!segment) return;
+        float tx = estimateAxisMoveSeconds(toX - x, DEFAULT_X_SPEED, DEFAULT_X_ACCEL);
+        float ty = estimateAxisMoveSeconds(toY - y, DEFAULT_Y_SPEED, DEFAULT_Y_ACCEL);
+        float tz = estimateAxisMoveSeconds(toZ - z, DEFAULT_Z_SPEED, DEFAULT_Z_ACCEL);
+        segment->seconds = fmaxf(tx, fmaxf(ty, tz));
+        segment->speedHz = (tz >= tx && tz >= ty) ? DEFAULT_Z_SPEED : (ty >= tx ? DEFAULT_Y_SPEED : DEFAULT_X_SPEED);
+        x = toX;
+        y = toY;
+        z = toZ;
+        segment->x1 = x;
+        segment->y1 = y;
+        segment->z1 = z;
+        account(segment);
+    }
+
+    // runPaintSweep(makePaintSweep(...)) along one axis, gun margins in inches
+    void sweepTo(bool alongX, long target, long speedHz, float gunStartMarginInches, float gunStopMarginInches) {
+        ToolpathSegment* segment = append(TOOLPATH_PAINT);
+        if (!segment) return;
+        long start = alongX ? x : y;
+        long length = labs(target - start);
+        float accel = alongX ? (float)DEFAULT_X_ACCEL : (float)DEFAULT_Y_ACCEL;
+        segment->gunOnOffset = inchesToSteps(gunStartMarginInches);
+        segment->gunOffOffset = length - inchesToSteps(gunStopMarginInches);
+        segment->speedHz = speedHz;
+        segment->seconds = estimateAxisMoveSeconds(length, (float)speedHz, accel);
+        if (alongX) x = target; else y = target;
+        segment->x1 = x;
+        segment->y1 = y;
+        segment->z1 = z;
+
+        long gunSteps = segment->gunOffOffset - segment->gunOnOffset;
+        if (gunSteps > 0 && speedHz > 0) {
+            summary->gunOnSeconds += (float)gunSteps / (float)speedHz;
+            summary->gunOnInches += (float)gunSteps / STEPS_PER_INCH_XYZ;
+        }
+        account(segment);
+    }
+
+    // rotateToAngle() at the default rotation speed
+    void rotateTo(float toAngle) {
+        float delta = rotationDeltaDegrees(angle, toAngle);
+        if (delta == 0.0f) {
+            return;
+        }
+        ToolpathSegment* segment = append(TOOLPATH_ROTATE);
+        if (!segment) return;
+        segment->seconds = estimateAxisMoveSeconds((long)(delta * STEPS_PER_DEGREE), DEFAULT_ROT_SPEED, DEFAULT_ROT_ACCEL);
+        segment->speedHz = DEFAULT_ROT_SPEED;
+        angle = toAngle;
+        segment->angle1 = angle;
+        segment->x1 = x;
+        segment->y1 = y;
+        segment->z1 = z;
+        account(segment);
+    }
+};
+
+//* ************************************************************************
+//* *************************** SIDE PATTERNS ******************************
+//* ************************************************************************
+// One function per Side state. Button waits and servo moves take no time here.
+
+// Steps shared by every side: safe Z, rotate, start position, lower to painting Z
+static void compileSideApproach(ToolpathBuilder& path, const ToolpathSideRecipe& side) {
+    long sideZ = inchesToSteps(side.sideZHeight);
+    path.travelTo(path.x, path.y, sideZ);
+    path.rotateTo(side.rotationAngle);
+    path.travelTo(inchesToSteps(side.startX), inchesToSteps(side.startY), sideZ);
+    path.travelTo(path.x, path.y, inchesToSteps(side.zHeight));
+}
+
+// moveToPositionOneOneBeforeHoming()
+static void compileMoveToOneOne(ToolpathBuilder& path) {
+    path.travelTo(inchesToSteps(1.0f), inchesToSteps(1.0f), 0);
+}
+
+static void compileSide1(ToolpathBuilder& path, const ToolpathSideRecipe& side) {
+    compileSideApproach(path, side);
+    path.sweepTo(true, path.x + inchesToSteps(side.shiftX), side.paintingXSpeed, side.gunStartMargin, side.gunStopMargin);
+    path.travelTo(path.x, path.y, inchesToSteps(side.sideZHeight));
+    compileMoveToOneOne(path);
+}
+
+// Side 2 and 4 share a shape: -Y sweeps from startY (five in firmware), X
+// shift between them, an end X move, then a final 23" X sweep at Z -1.75".
+static void compileVerticalSweepSide(ToolpathBuilder& path, const ToolpathSideRecipe& side,
+                                     long shiftDirection, float endMoveInches, bool raiseAfterFinal) {
+    const int numSweeps = side.sweepCount;
+    long startY = inchesToSteps(side.startY);
+    long finalY = startY - inchesToSteps(side.sweepY);
+    long shiftX = inchesToSteps(side.shiftX);
+
+    compileSideApproach(path, side);
+    for (int sweep = 0; sweep < numSweeps; sweep++) {
+        long speed = side.paintingYSpeed;
+        if (sweep == 0) {
+            speed = (long)(side.paintingYSpeed * 0.75f);
+            path.travelTo(path.x, startY, path.z);
+        }
+        path.sweepTo(false, finalY, speed, side.gunStartMargin, side.gunStopMargin);
+        if (sweep < numSweeps - 1) {
+            path.travelTo(path.x + shiftDirection * shiftX, startY, path.z);
+        }
+    }
+    path.travelTo(path.x + shiftDirection * inchesToSteps(endMoveInches), path.y, path.z);
+    path.travelTo(path.x, path.y, inchesToSteps(-1.75f));
+    path.sweepTo(true, path.x - shiftDirection * inchesToSteps(23.0f), side.paintingXSpeed,
+                 TOOLPATH_GUN_START_MARGIN, TOOLPATH_EDGE_GUN_STOP_MARGIN);
+    if (raiseAfterFinal) {
+        path.travelTo(path.x, path.y, inchesToSteps(side.sideZHeight));
+    }
+    compileMoveToOneOne(path);
+}
+
+static void compileSide3(ToolpathBuilder& path, const ToolpathSideRecipe& side) {
+    const int numSweeps = side.sweepCount;
+    // Side 3 swaps the UI meaning: ShiftX is the sweep length, SweepY the shift
+    long sweepX = inchesToSteps(side.shiftX);
+    long shiftY = inchesToSteps(side.sweepY);
+
+    compileSideApproach(path, side);
+    for (int sweep = 0; sweep < numSweeps; sweep++) {
+        bool negative = (sweep % 2 == 0);
+        bool finalSweep = (sweep == numSweeps - 1);
+        long speed = finalSweep ? (long)(side.paintingXSpeed * 0.75f) : side.paintingXSpeed;
+        path.sweepTo(true, path.x + (negative ? -sweepX : sweepX), speed, side.gunStartMargin, side.gunStopMargin);
+        if (!finalSweep) {
+            path.travelTo(path.x, path.y - shiftY, path.z);
+        }
+    }
+    path.travelTo(path.x, path.y, inchesToSteps(side.sideZHeight));
+    compileMoveToOneOne(path);
+}
+
+static void compileSide(ToolpathBuilder& path, const ToolpathRecipe& recipe, int side) {
+    path.side = side;
+    const ToolpathSideRecipe& sideRecipe = recipe.sides[side - 1];
+    switch (side) {
+        case 1: compileSide1(path, sideRecipe); break;
+        case 2: compileVerticalSweepSide(path, sideRecipe, -1, 2.0f, true); break;
+        case 3: compileSide3(path, sideRecipe); break;
+        case 4: compileVerticalSweepSide(path, sideRecipe, 1, 1.0f, false); break;
+    }
+}
+
+//* ************************************************************************
+//* ***************************** PUBLIC API *******************************
+//* ************************************************************************
+
+void getDefaultToolpathRecipe(ToolpathRecipe& recipe) {
+    const ToolpathSideRecipe defaults[TOOLPATH_SIDE_COUNT] = {
+        { SIDE1_START_X, SIDE1_START_Y, SIDE1_Z_HEIGHT, SIDE1_SIDE_Z_HEIGHT, SIDE1_SWEEP_Y, SIDE1_SHIFT_X,
+          SIDE1_PAINTING_X_SPEED, SIDE1_PAINTING_Y_SPEED, SIDE1_ROTATION_ANGLE,
+          1, TOOLPATH_GUN_START_MARGIN, TOOLPATH_EDGE_GUN_STOP_MARGIN },
+        { SIDE2_START_X, SIDE2_START_Y, SIDE2_Z_HEIGHT, SIDE2_SIDE_Z_HEIGHT, SIDE2_SWEEP_Y, SIDE2_SHIFT_X,
+          SIDE2_PAINTING_X_SPEED, SIDE2_PAINTING_Y_SPEED, SIDE2_ROTATION_ANGLE,
+          TOOLPATH_SIDE_SWEEP_COUNT, TOOLPATH_GUN_START_MARGIN, TOOLPATH_GUN_STOP_MARGIN },
+        { SIDE3_START_X, SIDE3_START_Y, SIDE3_Z_HEIGHT, SIDE3_SIDE_Z_HEIGHT, SIDE3_SWEEP_Y, SIDE3_SHIFT_X,
+          SIDE3_PAINTING_X_SPEED, SIDE3_PAINTING_Y_SPEED, SIDE3_ROTATION_ANGLE,
+          TOOLPATH_SIDE_SWEEP_COUNT, TOOLPATH_GUN_START_MARGIN, TOOLPATH_GUN_STOP_MARGIN },
+        { SIDE4_START_X, SIDE4_START_Y, SIDE4_Z_HEIGHT, SIDE4_SIDE_Z_HEIGHT, SIDE4_SWEEP_Y, SIDE4_SHIFT_X,
+          SIDE4_PAINTING_X_SPEED, SIDE4_PAINTING_Y_SPEED, SIDE4_ROTATION_ANGLE,
+          TOOLPATH_SIDE_SWEEP_COUNT, TOOLPATH_GUN_START_MARGIN, TOOLPATH_GUN_STOP_MARGIN },
+    };
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        recipe.sides[i] = defaults[i];
+    }
+}
+
+void applyFirmwarePatternShape(ToolpathSideRecipe& side, int sideNumber) {
+    side.sweepCount = sideNumber == 1 ? 1 : TOOLPATH_SIDE_SWEEP_COUNT;
+    side.gunStartMargin = TOOLPATH_GUN_START_MARGIN;
+    side.gunStopMargin = sideNumber == 1 ? TOOLPATH_EDGE_GUN_STOP_MARGIN : TOOLPATH_GUN_STOP_MARGIN;
+}
+
+bool isFirmwarePatternShape(const ToolpathSideRecipe& side, int sideNumber) {
+    ToolpathSideRecipe firmware = side;
+    applyFirmwarePatternShape(firmware, sideNumber);
+    return side.sweepCount == firmware.sweepCount &&
+           fabsf(side.gunStartMargin - firmware.gunStartMargin) < 0.001f &&
+           fabsf(side.gunStopMargin - firmware.gunStopMargin) < 0.001f;
+}
+
+int compileToolpath(const ToolpathRecipe& recipe, int side,
+                    ToolpathSegment* segments, int maxSegments, ToolpathSummary& summary) {
+    summary = ToolpathSummary();
+    ToolpathBuilder path = { segments, maxSegments, &summary, 1, 0, 0, 0, 0.0f };
+
+    if (side == TOOLPATH_ALL_SIDES) {
+        // Same order as PaintingState
+        for (int s = TOOLPATH_SIDE_COUNT; s >= 1; s--) {
+            compileSide(path, recipe, s);
+        }
+    } else if (side >= 1 && side <= TOOLPATH_SIDE_COUNT) {
+        compileSide(path, recipe, side);
+    }
+    return summary.segmentCount;
+}
+
+// Appends printf output at out + used, returns false once out is full
+static bool appendFormat(char* out, size_t outSize, size_t& used, const char* format, ...) {
+    if (used >= outSize) return false;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(out + used, outSize - used, format, args);
+    va_end(args);
+    if (written < 0 || (size_t)written >= outSize - used) {
+        used = outSize;
+        return false;
+    }
+    used += (size_t)written;
+    return true;
+}
+
+static long toHundredths(long steps) {
+    return lroundf((float)steps * 100.0f / STEPS_PER_INCH_XYZ);
+}
+
+static bool appendPoint(char* out, size_t outSize, size_t& used, long x, long y, long z, int gun) {
+    return appendFormat(out, outSize, used, "%s%ld,%ld,%ld,%d", used ? ";" : "",
+                        toHundredths(x), toHundredths(y), toHundredths(z), gun);
+}
+
+int formatToolpathPolyline(const ToolpathSegment* segments, int count, char* out, size_t outSize) {
+    if (!out || outSize == 0) return -1;
+    size_t used = 0;
+    out[0] = '\0';
+    bool ok = count > 0 ? appendPoint(out, outSize, used, segments[0].x0, segments[0].y0, segments[0].z0, 0) : true;
+
+    for (int i = 0; ok && i < count; i++) {
+        const ToolpathSegment& segment = segments[i];
+        if (segment.type == TOOLPATH_ROTATE) {
+            ok = appendFormat(out, outSize, used, ";R,%d", (int)lroundf(segment.angle1));
+            continue;
+        }
+        if (segment.type == TOOLPATH_PAINT && segment.gunOffOffset > segment.gunOnOffset) {
+            // Split the sweep at the gun edges
+            long dx = segment.x1 - segment.x0;
+            long dy = segment.y1 - segment.y0;
+            long length = labs(dx) + labs(dy); // Sweeps run along one axis
+            long offsets[2] = { segment.gunOnOffset, segment.gunOffOffset };
+            for (int edge = 0; ok && edge < 2; edge++) {
+                long px = segment.x0 + (length ? dx * offsets[edge] / length : 0);
+                long py = segment.y0 + (length ? dy * offsets[edge] / length : 0);
+                ok = appendPoint(out, outSize, used, px, py, segment.z0, edge);
+            }
+        }
+        if (ok) {
+            ok = appendPoint(out, outSize, used, segment.x1, segment.y1, segment.z1, 0);
+        }
+    }
+    return ok ? (int)used : -1;
+}
+
+int formatToolpathSummary(const ToolpathSummary& summary, char* out, size_t outSize) {
+    return snprintf(out, outSize,
+                    "total=%.1f,travel=%.1f,paint=%.1f,rotate=%.1f,gun=%.1f,gunIn=%.1f,"
+                    "S1=%.1f,S2=%.1f,S3=%.1f,S4=%.1f,segments=%d%s",
+                    summary.totalSeconds, summary.travelSeconds, summary.paintSeconds, summary.rotateSeconds,
+                    summary.gunOnSeconds, summary.gunOnInches,
+                    summary.sideSeconds[0], summary.sideSeconds[1], summary.sideSeconds[2], summary.sideSeconds[3],
+                    summary.segmentCount, summary.truncated ? ",TRUNCATED" : "");
+}
+
+//* ************************************************************************
+//* ************************** FIRMWARE DRY RUN ****************************
+//* ************************************************************************
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+#include "persistence/PaintingSettings.h"
+
+extern PaintingSettings paintingSettings;
+extern WebSocketsServer webSocket;
+
+static const char* const kSegmentTypeNames[] = { "TRAVEL", "PAINT", "ROTATE" };
+
+// Rotation angles come from painting.h - the Side states use the constants, not the settings
+static void loadToolpathRecipeFromSettings(ToolpathRecipe& recipe) {
+    ToolpathSideRecipe* s = recipe.sides;
+    s[0] = { paintingSettings.getSide1StartX(), paintingSettings.getSide1StartY(),
+             paintingSettings.getSide1ZHeight(), paintingSettings.getSide1SideZHeight(),
+             paintingSettings.getSide1SweepY(), paintingSettings.getSide1ShiftX(),
+             paintingSettings.getSide1PaintingXSpeed(), paintingSettings.getSide1PaintingYSpeed(),
+             SIDE1_ROTATION_ANGLE, 0, 0.0f, 0.0f };
+    s[1] = { paintingSettings.getSide2StartX(), paintingSettings.getSide2StartY(),
+             paintingSettings.getSide2ZHeight(), paintingSettings.getSide2SideZHeight(),
+             paintingSettings.getSide2SweepY(), paintingSettings.getSide2ShiftX(),
+             paintingSettings.getSide2PaintingXSpeed(), paintingSettings.getSide2PaintingYSpeed(),
+             SIDE2_ROTATION_ANGLE, 0, 0.0f, 0.0f };
+    s[2] = { paintingSettings.getSide3StartX(), paintingSettings.getSide3StartY(),
+             paintingSettings.getSide3ZHeight(), paintingSettings.getSide3SideZHeight(),
+             paintingSettings.getSide3SweepY(), paintingSettings.getSide3ShiftX(),
+             paintingSettings.getSide3PaintingXSpeed(), paintingSettings.getSide3PaintingYSpeed(),
+             SIDE3_ROTATION_ANGLE, 0, 0.0f, 0.0f };
+    s[3] = { paintingSettings.getSide4StartX(), paintingSettings.getSide4StartY(),
+             paintingSettings.getSide4ZHeight(), paintingSettings.getSide4SideZHeight(),
+             paintingSettings.getSide4SweepY(), paintingSettings.getSide4ShiftX(),
+             paintingSettings.getSide4PaintingXSpeed(), paintingSettings.getSide4PaintingYSpeed(),
+             SIDE4_ROTATION_ANGLE, 0, 0.0f, 0.0f };
+    // Sweep count and gun margins are not settings; use what the Side states paint
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        applyFirmwarePatternShape(s[i], i + 1);
+    }
+}
+
+//? Static: too large for the loop task stack. Shared by the dry run and the cycle estimator.
+static ToolpathSegment g_settingsSegments[TOOLPATH_MAX_SEGMENTS];
+
+const ToolpathSegment* compileSettingsToolpath(int side, int& count, ToolpathSummary& summary) {
+    ToolpathRecipe recipe;
+    loadToolpathRecipeFromSettings(recipe);
+    count = compileToolpath(recipe, side, g_settingsSegments, TOOLPATH_MAX_SEGMENTS, summary);
+    return g_settingsSegments;
+}
+
+void broadcastToolpathDryRun(int side) {
+    static char buffer[TOOLPATH_POLYLINE_BUFFER_SIZE];
+
+    ToolpathSummary summary;
+    int count;
+    const ToolpathSegment* segments = compileSettingsToolpath(side, count, summary);
+
+    Serial.printf("Toolpath dry run (%s): %d segments\n", side == TOOLPATH_ALL_SIDES ? "all sides" : "single side", count);
+    for (int i = 0; i < count; i++) {
+        const ToolpathSegment& s = segments[i];
+        Serial.printf("  %2d S%d %-6s (%.2f,%.2f,%.2f)->(%.2f,%.2f,%.2f) %6.2fs", i, s.side, kSegmentTypeNames[s.type],
+                      s.x0 / STEPS_PER_INCH_XYZ, s.y0 / STEPS_PER_INCH_XYZ, s.z0 / STEPS_PER_INCH_XYZ,
+                      s.x1 / STEPS_PER_INCH_XYZ, s.y1 / STEPS_PER_INCH_XYZ, s.z1 / STEPS_PER_INCH_XYZ, s.seconds);
+        if (s.type == TOOLPATH_PAINT) {
+            Serial.printf(" gun %.2f-%.2f in @ %ld Hz", s.gunOnOffset / STEPS_PER_INCH_XYZ,
+                          s.gunOffOffset / STEPS_PER_INCH_XYZ, s.speedHz);
+        } else if (s.type == TOOLPATH_ROTATE) {
+            Serial.printf(" %.0f -> %.0f deg", s.angle0, s.angle1);
+        }
+        Serial.println();
+    }
+
+    formatToolpathSummary(summary, buffer, sizeof(buffer));
+    Serial.printf("Toolpath summary: %s\n", buffer);
+    String message = "TOOLPATH_SUMMARY:";
+    message += buffer;
+    webSocket.broadcastTXT(message);
+
+    if (formatToolpathPolyline(segments, count, buffer, sizeof(buffer)) < 0) {
+        Serial.println("Toolpath polyline too long for the dashboard buffer");
+        webSocket.broadcastTXT("TOOLPATH:");
+        return;
+    }
+    message = "TOOLPATH:";
+    message += buffer;
+    webSocket.broadcastTXT(message);
+}
+#endif
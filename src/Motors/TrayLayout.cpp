@@ -0,0 +1,183 @@
+#include "motors/TrayLayout.h"
+#include <Arduino.h>
+#include "utils/settings.h"
+#include "settings/pnp.h"
+#include "storage/Persistence.h"
+
+#define TRAY_GUN_WINDOWS_KEY "trayGunWin"
+#define TRAY_OCCUPANCY_KEY "trayOcc"
+
+static bool g_trayGunWindows = false;
+static uint32_t g_trayOccupancy = 0xFFFFFFFFUL; // Masked to the active tray when read
+
+//* ************************************************************************
+//* ***************************** SETTINGS *********************************
+//* ************************************************************************
+
+void setTrayGunWindowsEnabled(bool enabled) {
+    g_trayGunWindows = enabled;
+    persistence.beginTransaction(false);
+    persistence.saveInt(TRAY_GUN_WINDOWS_KEY, enabled ? 1 : 0);
+    persistence.endTransaction();
+    Serial.printf("Tray gun windows %s\n", enabled ? "enabled" : "disabled");
+}
+
+bool areTrayGunWindowsEnabled() {
+    return g_trayGunWindows;
+}
+
+void loadTrayLayoutFromNVS() {
+    persistence.beginTransaction(true);
+    g_trayGunWindows = persistence.loadInt(TRAY_GUN_WINDOWS_KEY, 0) != 0;
+    g_trayOccupancy = (uint32_t)persistence.loadInt(TRAY_OCCUPANCY_KEY, -1) & getTrayFillableMask();
+    persistence.endTransaction();
+    Serial.printf("Tray gun windows loaded: %s, occupancy %s\n", g_trayGunWindows ? "enabled" : "disabled",
+                  trayOccupancyString().c_str());
+}
+
+//* ************************************************************************
+//* **************************** OCCUPANCY *********************************
+//* ************************************************************************
+
+void setTrayOccupancy(uint32_t mask, bool save) {
+    g_trayOccupancy = mask & getTrayFillableMask();
+    if (save) {
+        saveTrayOccupancy();
+    }
+    Serial.printf("Tray occupancy set: %s\n", trayOccupancyString().c_str());
+}
+
+void saveTrayOccupancy() {
+    persistence.beginTransaction(false);
+    persistence.saveInt(TRAY_OCCUPANCY_KEY, (int)g_trayOccupancy);
+    persistence.endTransaction();
+}
+
+uint32_t getTrayOccupancy() {
+    return g_trayOccupancy & getTrayFillableMask();
+}
+
+void setTrayPositionOccupied(int position, bool occupied) {
+    if (position < 1 || position > getTrayPositionCount()) {
+        return;
+    }
+    uint32_t bit = 1UL << (position - 1);
+    g_trayOccupancy = (occupied ? (g_trayOccupancy | bit) : (g_trayOccupancy & ~bit)) & getTrayFillableMask();
+}
+
+bool isTrayPositionOccupied(int position) {
+    if (position < 1 || position > getTrayPositionCount()) {
+        return false;
+    }
+    return (getTrayOccupancy() & (1UL << (position - 1))) != 0;
+}
+
+String trayOccupancyString() {
+    String text;
+    for (int position = 1; position <= getTrayPositionCount(); position++) {
+        text += isTrayPositionOccupied(position) ? '1' : '0';
+    }
+    return text;
+}
+
+bool parseTrayOccupancy(const String& text, uint32_t& mask) {
+    if ((int)text.length() != getTrayPositionCount()) {
+        return false;
+    }
+    mask = 0;
+    for (int i = 0; i < getTrayPositionCount(); i++) {
+        if (text[i] == '1') {
+            mask |= 1UL << i;
+        } else if (text[i] != '0') {
+            return false;
+        }
+    }
+    return true;
+}
+
+//* ************************************************************************
+//* *************************** GUN WINDOWS ********************************
+//* ************************************************************************
+
+// Carriage positions (inches) along the sweep axis over which the gun covers a part
+static void trayPartExtent(int position, PaintSweepAxis axis, float cosA, float sinA,
+                           float& lowInch, float& highInch) {
+    const TrayDefinition& tray = getActiveTray();
+    float x, y;
+    getTrayPositionInches(position, x, y);
+    float dx = x - TURNTABLE_CENTER_X;
+    float dy = y - TURNTABLE_CENTER_Y;
+    float centre, halfWidth;
+    //? Half-extent of the rotated footprint's bounding box; exact at multiples of 90 degrees
+    if (axis == SWEEP_AXIS_X) {
+        centre = TURNTABLE_CENTER_X + cosA * dx - sinA * dy - TRAY_GUN_OFFSET_X;
+        halfWidth = 0.5f * (tray.partWidth * fabsf(cosA) + tray.partLength * fabsf(sinA));
+    } else {
+        centre = TURNTABLE_CENTER_Y + sinA * dx + cosA * dy - TRAY_GUN_OFFSET_Y;
+        halfWidth = 0.5f * (tray.partWidth * fabsf(sinA) + tray.partLength * fabsf(cosA));
+    }
+    halfWidth += TRAY_GUN_WINDOW_MARGIN;
+    lowInch = centre - halfWidth;
+    highInch = centre + halfWidth;
+}
+
+PaintSweep withTrayGunWindows(PaintSweep sweep, float rotationAngle) {
+    if (!g_trayGunWindows) {
+        return sweep;
+    }
+
+    const long direction = (sweep.targetPos >= sweep.startPos) ? 1 : -1;
+    const long minGapSteps = (long)(TRAY_GUN_WINDOW_MIN_GAP * STEPS_PER_INCH_XYZ);
+    float radians = rotationAngle * DEG_TO_RAD;
+    float cosA = cosf(radians);
+    float sinA = sinf(radians);
+
+    PaintGunWindow windows[TRAY_MAX_POSITIONS];
+    int count = 0;
+    for (int position = 1; position <= getTrayPositionCount(); position++) {
+        if (!isTrayPositionOccupied(position)) {
+            continue; // Empty or skipped position
+        }
+        float lowInch, highInch;
+        trayPartExtent(position, sweep.axis, cosA, sinA, lowInch, highInch);
+        long a = ((long)(lowInch * STEPS_PER_INCH_XYZ) - sweep.startPos) * direction;
+        long b = ((long)(highInch * STEPS_PER_INCH_XYZ) - sweep.startPos) * direction;
+        PaintGunWindow window = { max(min(a, b), sweep.gunOnOffset), min(max(a, b), sweep.gunOffOffset) };
+        if (window.onOffset >= window.offOffset) {
+            continue; // Part lies outside the sweep's gun margins
+        }
+        // Insertion sort by opening offset
+        int slot = count++;
+        while (slot > 0 && windows[slot - 1].onOffset > window.onOffset) {
+            windows[slot] = windows[slot - 1];
+            slot--;
+        }
+        windows[slot] = window;
+    }
+
+    // Parts in the same row or column project onto the same interval; merge
+    // overlaps and gaps too short to be worth closing the gun for
+    sweep.windowCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (sweep.windowCount > 0 &&
+            windows[i].onOffset - sweep.windows[sweep.windowCount - 1].offOffset < minGapSteps) {
+            PaintGunWindow& last = sweep.windows[sweep.windowCount - 1];
+            last.offOffset = max(last.offOffset, windows[i].offOffset);
+        } else if (sweep.windowCount < PAINT_SWEEP_MAX_WINDOWS) {
+            sweep.windows[sweep.windowCount++] = windows[i];
+        } else {
+            // Out of slots: paint through to the end of this part
+            PaintGunWindow& last = sweep.windows[sweep.windowCount - 1];
+            last.offOffset = max(last.offOffset, windows[i].offOffset);
+        }
+    }
+
+    long gunOnSteps = 0;
+    for (int i = 0; i < sweep.windowCount; i++) {
+        gunOnSteps += sweep.windows[i].offOffset - sweep.windows[i].onOffset;
+    }
+    Serial.printf("%s: %d tray gun window(s), gun on %.2f of %.2f in\n", sweep.tag, sweep.windowCount,
+                  gunOnSteps / STEPS_PER_INCH_XYZ,
+                  max(0L, sweep.gunOffOffset - sweep.gunOnOffset) / STEPS_PER_INCH_XYZ);
+    return trimPaintSweepToWindows(sweep);
+}
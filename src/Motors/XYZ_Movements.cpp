@@ -8,6 +8,11 @@
 #include <FastAccelStepper.h>
 #include <Bounce2.h>   // For debouncing limit switches
 #include "web/Web_Dashboard_Commands.h" // For checking home commands
+#include "motors/StopAll.h" // Centralised axis-group stop
+#include "motors/LimitSwitches.h" // Latched limit faults
+#include "motors/GantrySync.h" // Y_Left / Y_Right cross-check
+#include "motors/Homing.h" // Moves need a valid homing reference
+#include "system/PhaseStats.h" // Travel phase timing
 
 // Define stepper engine and steppers (example)
 extern FastAccelStepperEngine engine; // Use the global one from Setup.cpp
@@ -66,6 +71,34 @@ void setupMotors() {
 */
 
 void moveToXYZ(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z, unsigned int zSpeed) {
+    PhaseScope travel(PHASE_TRAVEL);
+    if (!startMoveToXYZ(x, xSpeed, y, ySpeed, z, zSpeed)) {
+        return;
+    }
+    
+    // Wait until all steppers have completed their movements
+    while (isMoveToXYZRunning()) {
+        if (!serviceMoveToXYZ()) {
+            break; // Axes already stopped
+        }
+        delay(1); // Reduced delay from 5ms to 1ms for more responsive command processing
+    }
+    
+    if (!homeCommandReceived && !isLimitFaultLatched()) {
+        Serial.printf("Move complete - Position: X:%ld Y_L:%ld Y_R:%ld Z:%ld\n", stepperX->getCurrentPosition(), stepperY_Left->getCurrentPosition(), stepperY_Right->getCurrentPosition(), stepperZ->getCurrentPosition()); // Updated printf
+    }
+}
+
+bool startMoveToXYZ(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z, unsigned int zSpeed) {
+    if (isLimitFaultLatched()) {
+        Serial.println("Move refused - limit fault latched, home to recover");
+        return false;
+    }
+    if (!isHomingReferenceValid()) {
+        Serial.println("Move refused - axes not homed, home first");
+        return false;
+    }
+
     // Set speed for each stepper individually
     stepperX->setSpeedInHz(xSpeed);
     stepperY_Left->setSpeedInHz(ySpeed); // Renamed
@@ -77,62 +110,42 @@ void moveToXYZ(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z,
     stepperY_Left->moveTo(y); // Renamed
     stepperY_Right->moveTo(y); // Added second Y motor move
     stepperZ->moveTo(z);
-    
-    // Wait until all steppers have completed their movements
-    while (stepperX->isRunning() || stepperY_Left->isRunning() || stepperY_Right->isRunning() || stepperZ->isRunning()) { // Updated condition
-        // Check for limit switches while running
-        checkMotors();
-        
-        // Also check for home/pause commands during movement
-        if (checkForPauseCommand()) {
-            // Home command received, stop all motors immediately
-            Serial.println("HOME command received during movement - aborting movement");
-            stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-            stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-            stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-            stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
-            break; // Exit the wait loop
-        }
-        
-        delay(1); // Reduced delay from 5ms to 1ms for more responsive command processing
+    return true;
+}
+
+bool isMoveToXYZRunning() {
+    return stepperX->isRunning() || stepperY_Left->isRunning() || stepperY_Right->isRunning() || stepperZ->isRunning();
+}
+
+bool serviceMoveToXYZ() {
+    // Check for limit switches while running
+    if (checkMotors()) {
+        Serial.println("Limit fault during movement - aborting movement");
+        return false; // Axes already stopped by the limit service
     }
     
-    if (!homeCommandReceived) {
-        Serial.printf("Move complete - Position: X:%ld Y_L:%ld Y_R:%ld Z:%ld\n", stepperX->getCurrentPosition(), stepperY_Left->getCurrentPosition(), stepperY_Right->getCurrentPosition(), stepperZ->getCurrentPosition()); // Updated printf
+    // Also check for home/pause commands during movement
+    if (checkForPauseCommand()) {
+        // Home command received, stop all motors immediately
+        Serial.println("HOME command received during movement - aborting movement");
+        stopAllAxes();
+        return false;
     }
+    return true;
 }
 
 // New function that checks for home command during movement
 // Returns true if movement completed, false if aborted due to home command
 bool moveToXYZ_HomeCheck(long x, unsigned int xSpeed, long y, unsigned int ySpeed, long z, unsigned int zSpeed) {
-    // Set speed for each stepper individually
-    stepperX->setSpeedInHz(xSpeed);
-    stepperY_Left->setSpeedInHz(ySpeed);
-    stepperY_Right->setSpeedInHz(ySpeed);
-    stepperZ->setSpeedInHz(zSpeed);
-    
-    // Command the move to the absolute position
-    stepperX->moveTo(x);
-    stepperY_Left->moveTo(y);
-    stepperY_Right->moveTo(y);
-    stepperZ->moveTo(z);
+    if (!startMoveToXYZ(x, xSpeed, y, ySpeed, z, zSpeed)) {
+        return false;
+    }
     
     // Wait until all steppers have completed their movements
-    while (stepperX->isRunning() || stepperY_Left->isRunning() || stepperY_Right->isRunning() || stepperZ->isRunning()) {
-        // Check for limit switches while running
-        checkMotors();
-        
-        // Also check for home/pause commands during movement
-        if (checkForPauseCommand()) {
-            // Home command received, stop all motors immediately
-            Serial.println("HOME command received during movement - aborting movement");
-            stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-            stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-            stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-            stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
-            return false; // Movement aborted
+    while (isMoveToXYZRunning()) {
+        if (!serviceMoveToXYZ()) {
+            return false; // Movement aborted, axes already stopped
         }
-        
         delay(1); // Reduced delay from 5ms to 1ms for more responsive command processing
     }
     
@@ -145,44 +158,30 @@ bool moveToXYZ_HomeCheck(long x, unsigned int xSpeed, long y, unsigned int ySpee
 }
 
 // This function replaces checkSwitches from Functionality.cpp
-void checkMotors() {
+// The limit interrupts do the actual stopping; this is the polling fallback
+// for an edge the interrupt missed (e.g. a switch already closed when armed).
+// Returns true if a limit fault is latched and the move must be abandoned.
+bool checkMotors() {
     // Update debouncers
     debounceX.update();
     debounceY_Left.update(); // Renamed
     debounceY_Right.update(); // Added second Y debouncer update
     debounceZ.update();
 
-    // Read switch states
-    bool limitX = debounceX.read() == HIGH; // HIGH when triggered (assuming active high)
-    bool limitY_Left = debounceY_Left.read() == HIGH; // Renamed & active high
-    bool limitY_Right = debounceY_Right.read() == HIGH; // Added second Y switch read & active high
-    bool limitZ = debounceZ.read() == HIGH; // active high
-    
-    // Example of using switch readings (add your own logic)
-    if (limitX) {
-        Serial.println("X limit switch triggered");
-        // Take action like stopping X motor
-        // stepperX->forceStop(); // Example action
-    }
-    
-    // Similar handling for Y and Z
-    if (limitY_Left) {
-        Serial.println("Y Left limit switch triggered");
-        // Take action like stopping Y motors during homing or if unexpected
-        // stepperY_Left->forceStop(); // Example action
-        // stepperY_Right->forceStop(); // Example action (if gantry safety requires stopping both)
-    }
-    if (limitY_Right) {
-        Serial.println("Y Right limit switch triggered");
-        // Take action like stopping Y motors during homing or if unexpected
-        // stepperY_Left->forceStop(); // Example action (if gantry safety requires stopping both)
-        // stepperY_Right->forceStop(); // Example action
-    }
-    if (limitZ) {
-        Serial.println("Z limit switch triggered");
-        // Take action like stopping Z motor
-        // stepperZ->forceStop(); // Example action
+    if (isLimitMonitoringEnabled() && !isLimitFaultLatched()) {
+        uint8_t faultMask = 0;
+        if (debounceX.read() == HIGH) faultMask |= LIMIT_FAULT_X; // HIGH when triggered (active high)
+        if (debounceY_Left.read() == HIGH) faultMask |= LIMIT_FAULT_Y_LEFT;
+        if (debounceY_Right.read() == HIGH) faultMask |= LIMIT_FAULT_Y_RIGHT;
+        if (debounceZ.read() == HIGH) faultMask |= LIMIT_FAULT_Z;
+        if (faultMask) {
+            Serial.printf("Limit switch active during move (%s) - latching fault\n", limitFaultMaskToString(faultMask).c_str());
+            latchLimitFault(faultMask);
+        }
     }
+    checkGantrySync();
+
+    return serviceLimitSwitches();
 }
 
 //! ************************************************************************
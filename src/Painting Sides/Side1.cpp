@@ -1,8 +1,11 @@
 #include <Arduino.h>
 #include "../../include/system/StateMachine.h"
+#include "../../include/states/HomingState.h" // For requestVerifyHome
 #include "../../include/states/State.h"
 #include "../../include/states/PaintingState.h"
 #include "../../include/motors/XYZ_Movements.h"
+#include "../../include/motors/PaintSweep.h"
+#include "../../include/motors/TrayLayout.h"
 #include "../../include/utils/settings.h"
 #include "../../include/motors/Rotation_Motor.h"
 #include "../../include/hardware/paintGun_Functions.h"
@@ -13,6 +16,7 @@
 #include "../../include/motors/ServoMotor.h"
 #include "../../include/web/Web_Dashboard_Commands.h"
 #include "../config/Pins_Definitions.h"
+#include "system/PhaseStats.h" // Modifier waits count as button-wait time
 
 // External references
 extern FastAccelStepper *stepperX;
@@ -60,16 +64,14 @@ private:
     long zPos;
     long sideZPos;
     long finalX;
-    long paintStartX;
-    long paintStopX;
-    bool paintGunOn;
     
     // Helper methods
     void performCurrentStep();
     void transitionToNextStep();
+    bool isModifierWaitStep() const;
 };
 
-Side1State::Side1State() : currentStep(S1_IDLE), paintGunOn(false) {
+Side1State::Side1State() : currentStep(S1_IDLE) {
     Serial.println("Side1State: Constructor called");
 }
 
@@ -85,6 +87,7 @@ void Side1State::update() {
 void Side1State::exit() {
     Serial.println("Side1State: Exiting Side 1 painting state");
     paintGun_OFF();
+    setPhaseBackground(PHASE_OTHER); // A stop or home mid-wait is not button wait
 }
 
 const char* Side1State::getName() const {
@@ -156,68 +159,14 @@ void Side1State::performCurrentStep() {
                 long shiftXDistance = (long)(paintingSettings.getSide1ShiftX() * STEPS_PER_INCH_XYZ);
                 long xSpeed = paintingSettings.getSide1PaintingXSpeed();
                 finalX = startX_steps + shiftXDistance;
-                paintStartX = startX_steps + (long)(0.25f * STEPS_PER_INCH_XYZ);
-                paintStopX = finalX - (long)(0.75f * STEPS_PER_INCH_XYZ);
                 
                 Serial.println("Side1State: Executing painting pattern");
                 
-                // Start continuous movement
-                stepperX->moveTo(finalX);
-                stepperX->setSpeedInHz(xSpeed);
-                
-                // Monitor movement and control paint gun
-                while (stepperX->isRunning()) {
-                    long currentX = stepperX->getCurrentPosition();
-                    
-                    // Check for pause button press
-                    if (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-                        bool wasGunOn = paintGunOn;
-                        if (paintGunOn) {
-                            paintGun_OFF();
-                            paintGunOn = false;
-                            Serial.println("Side1State: Paint gun OFF (paused)");
-                        }
-                        stepperX->forceStop();
-                        Serial.println("Side1State: Movement paused");
-                        
-                        // Wait for button release
-                        while (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-                            delay(10);
-                        }
-                        
-                        // Resume movement
-                        stepperX->moveTo(finalX);
-                        stepperX->setSpeedInHz(xSpeed);
-                        if (wasGunOn && currentX >= paintStartX && currentX < paintStopX) {
-                            paintGun_ON();
-                            paintGunOn = true;
-                            Serial.println("Side1State: Paint gun ON (resumed)");
-                        }
-                        Serial.println("Side1State: Movement resumed");
-                    }
-                    
-                    // Turn paint gun ON when reaching paint start position
-                    if (!paintGunOn && currentX >= paintStartX) {
-                        paintGun_ON();
-                        paintGunOn = true;
-                        Serial.println("Side1State: Paint gun ON");
-                    }
-                    
-                    // Turn paint gun OFF when reaching paint stop position
-                    if (paintGunOn && currentX >= paintStopX) {
-                        paintGun_OFF();
-                        paintGunOn = false;
-                        Serial.println("Side1State: Paint gun OFF");
-                    }
-                    
-                    processWebSocketEventsFrequently();
-                    delay(1);
-                }
-            
-                // Ensure paint gun is OFF after movement completes
-                if (paintGunOn) {
-                    paintGun_OFF();
-                    paintGunOn = false;
+                // Continuous X movement with position-tracked paint gun window
+                if (!runPaintSweep(withTrayGunWindows(makePaintSweep(SWEEP_AXIS_X, startX_steps, finalX, xSpeed,
+                                                                     0.25f, 0.75f, "Side1State"), SIDE1_ROTATION_ANGLE))) {
+                    abortPaintSide("Side1State");
+                    return;
                 }
                 
                 transitionToNextStep();
@@ -260,6 +209,7 @@ void Side1State::performCurrentStep() {
                 paintingState->onSideCompleted(); // Notify that this side is complete
             } else {
                 Serial.println("Side1State: Individual side mode - transitioning to homing");
+                requestVerifyHome(); // Job finished - a verify-home is enough
                 stateMachine->changeState(stateMachine->getHomingState());
             }
             break;
@@ -268,6 +218,19 @@ void Side1State::performCurrentStep() {
 
 void Side1State::transitionToNextStep() {
     currentStep = static_cast<Side1SubStep>(static_cast<int>(currentStep) + 1);
+    // Time until the wait step passes is button wait (system/PhaseStats.h)
+    setPhaseBackground(isModifierWaitStep() ? PHASE_BUTTON_WAIT : PHASE_OTHER);
+}
+
+bool Side1State::isModifierWaitStep() const {
+    switch (currentStep) {
+        case S1_WAIT_FOR_MODIFIER_BUTTON:
+        case S1_WAIT_FOR_MODIFIER_BUTTON_AFTER_PAINT:
+        case S1_WAIT_FOR_MODIFIER_BUTTON_FINAL:
+            return true;
+        default:
+            return false;
+    }
 }
 
 //* ************************************************************************
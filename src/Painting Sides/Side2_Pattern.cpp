@@ -1,8 +1,11 @@
 #include <Arduino.h>
 #include "../../include/system/StateMachine.h"
+#include "../../include/states/HomingState.h" // For requestVerifyHome
 #include "../../include/states/State.h"
 #include "../../include/states/PaintingState.h"
 #include "../../include/motors/XYZ_Movements.h"
+#include "../../include/motors/PaintSweep.h"
+#include "../../include/motors/TrayLayout.h"
 #include "../../include/utils/settings.h"
 #include "../../include/motors/Rotation_Motor.h"
 #include "../../include/hardware/paintGun_Functions.h"
@@ -13,6 +16,7 @@
 #include "../../include/motors/ServoMotor.h"
 #include "../../include/web/Web_Dashboard_Commands.h"
 #include "../config/Pins_Definitions.h"
+#include "system/PhaseStats.h" // Modifier waits count as button-wait time
 
 // External references
 extern FastAccelStepper *stepperX;
@@ -72,18 +76,16 @@ private:
     long paint_y_speed;
     long first_sweep_paint_y_speed_side2;
     int currentSweep;
-    bool paintGunActivated;
-    bool paintGunDeactivated;
-    unsigned long moveStartTime;
     
     // Helper methods
     void performCurrentStep();
     void transitionToNextStep();
+    bool isModifierWaitStep() const;
     void executeYSweep(int sweepNumber);
     void performCombinedXShiftYMove();
 };
 
-Side2State::Side2State() : currentStep(S2_IDLE), currentSweep(0), paintGunActivated(false), paintGunDeactivated(false) {
+Side2State::Side2State() : currentStep(S2_IDLE), currentSweep(0) {
     Serial.println("Side2State: Constructor called");
 }
 
@@ -99,6 +101,7 @@ void Side2State::update() {
 void Side2State::exit() {
     Serial.println("Side2State: Exiting Side 2 painting state");
     paintGun_OFF();
+    setPhaseBackground(PHASE_OTHER); // A stop or home mid-wait is not button wait
 }
 
 const char* Side2State::getName() const {
@@ -210,59 +213,11 @@ void Side2State::performCurrentStep() {
             Serial.println("Side2State: Executing final X sweep");
             {
                 long finalX = currentX + (long)(23.0f * STEPS_PER_INCH_XYZ);
-                long paintStartX = currentX + (long)(0.25f * STEPS_PER_INCH_XYZ);
-                long paintStopX = finalX - (long)(0.75f * STEPS_PER_INCH_XYZ);
                 
-                stepperX->moveTo(finalX);
-                stepperX->setSpeedInHz(paint_x_speed);
-                
-                bool paintGunOn = false;
-                while (stepperX->isRunning()) {
-                    long currentXPos = stepperX->getCurrentPosition();
-                    
-                    // Check for pause button press
-                    if (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-                        bool wasGunOn = paintGunOn;
-                        if (paintGunOn) {
-                            paintGun_OFF();
-                            paintGunOn = false;
-                            Serial.println("Side2State: Paint gun OFF (paused)");
-                        }
-                        stepperX->forceStop();
-                        Serial.println("Side2State: Movement paused");
-                        
-                        // Wait for button release
-                        while (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-                            delay(10);
-                        }
-                        
-                        // Resume movement
-                        stepperX->moveTo(finalX);
-                        stepperX->setSpeedInHz(paint_x_speed);
-                        if (wasGunOn && currentXPos >= paintStartX && currentXPos < paintStopX) {
-                            paintGun_ON();
-                            paintGunOn = true;
-                            Serial.println("Side2State: Paint gun ON (resumed)");
-                        }
-                        Serial.println("Side2State: Movement resumed");
-                    }
-                    
-                    if (!paintGunOn && currentXPos >= paintStartX) {
-                        paintGun_ON();
-                        paintGunOn = true;
-                    }
-                    
-                    if (paintGunOn && currentXPos >= paintStopX) {
-                        paintGun_OFF();
-                        paintGunOn = false;
-                    }
-                    
-                    processWebSocketEventsFrequently();
-                    delay(1);
-                }
-                
-                if (paintGunOn) {
-                    paintGun_OFF();
+                if (!runPaintSweep(withTrayGunWindows(makePaintSweep(SWEEP_AXIS_X, currentX, finalX, paint_x_speed,
+                                                                     0.25f, 0.75f, "Side2State"), SIDE2_ROTATION_ANGLE))) {
+                    abortPaintSide("Side2State");
+                    return;
                 }
                 
                 currentX = finalX;
@@ -306,6 +261,7 @@ void Side2State::performCurrentStep() {
                 paintingState->onSideCompleted(); // Notify that this side is complete
             } else {
                 Serial.println("Side2State: Individual side mode - transitioning to homing");
+                requestVerifyHome(); // Job finished - a verify-home is enough
                 stateMachine->changeState(stateMachine->getHomingState());
             }
             break;
@@ -314,6 +270,21 @@ void Side2State::performCurrentStep() {
 
 void Side2State::transitionToNextStep() {
     currentStep = static_cast<Side2SubStep>(static_cast<int>(currentStep) + 1);
+    // Time until the wait step passes is button wait (system/PhaseStats.h)
+    setPhaseBackground(isModifierWaitStep() ? PHASE_BUTTON_WAIT : PHASE_OTHER);
+}
+
+bool Side2State::isModifierWaitStep() const {
+    switch (currentStep) {
+        case S2_WAIT_FOR_MODIFIER_BUTTON:
+        case S2_WAIT_FOR_MODIFIER_BUTTON_AFTER_SWEEPS:
+        case S2_WAIT_FOR_MODIFIER_BUTTON_BEFORE_SERVO:
+        case S2_WAIT_FOR_MODIFIER_BUTTON_FINAL:
+        case S2_WAIT_FOR_MODIFIER_BUTTON_LAST:
+            return true;
+        default:
+            return false;
+    }
 }
 
 void Side2State::executeYSweep(int sweepNumber) {
@@ -341,69 +312,13 @@ void Side2State::executeYSweep(int sweepNumber) {
     long finalY = startY_steps - sweepYDistance;
     Serial.printf("Side2State: Painting while moving -Y down to Y=%ld\n", finalY);
     
-    // Calculate smooth movement parameters
-    float totalDistance = (float)sweepYDistance / STEPS_PER_INCH_XYZ;
-    float timeToStart = 0.25f * STEPS_PER_INCH_XYZ / (float)current_paint_y_speed;
-    float timeToStop = (totalDistance - 0.5f) * STEPS_PER_INCH_XYZ / (float)current_paint_y_speed;
-    
-    // Start smooth movement for BOTH Y motors
-    moveStartTime = millis();
-    stepperY_Left->moveTo(finalY);
-    stepperY_Left->setSpeedInHz(current_paint_y_speed);
-    stepperY_Right->moveTo(finalY);
-    stepperY_Right->setSpeedInHz(current_paint_y_speed);
-    
-    paintGunActivated = false;
-    paintGunDeactivated = false;
-    
-    while(stepperY_Left->isRunning() || stepperY_Right->isRunning()) {
-        unsigned long currentTime = millis();
-        float elapsedSeconds = (currentTime - moveStartTime) / 1000.0f;
-        
-        // Check for pause button press
-        if (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-            bool wasGunOn = paintGunActivated && !paintGunDeactivated;
-            if (wasGunOn) {
-                paintGun_OFF();
-                Serial.println("Side2State: Paint gun OFF (paused)");
-            }
-            stepperY_Left->forceStop();
-            stepperY_Right->forceStop();
-            Serial.println("Side2State: Movement paused");
-            
-            // Wait for button release
-            while (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-                delay(10);
-            }
-            
-            // Resume movement
-            stepperY_Left->moveTo(finalY);
-            stepperY_Left->setSpeedInHz(current_paint_y_speed);
-            stepperY_Right->moveTo(finalY);
-            stepperY_Right->setSpeedInHz(current_paint_y_speed);
-            moveStartTime = millis() - (unsigned long)(elapsedSeconds * 1000); // Adjust start time
-            if (wasGunOn && elapsedSeconds >= timeToStart && elapsedSeconds < timeToStop) {
-                paintGun_ON();
-                Serial.println("Side2State: Paint gun ON (resumed)");
-            }
-            Serial.println("Side2State: Movement resumed");
-        }
-        
-        if (!paintGunActivated && elapsedSeconds >= timeToStart) {
-            paintGun_ON();
-            paintGunActivated = true;
-        }
-        
-        if (paintGunActivated && !paintGunDeactivated && elapsedSeconds >= timeToStop) {
-            paintGun_OFF();
-            paintGunDeactivated = true;
-        }
-        
-        processWebSocketEventsFrequently();
-        delay(1);
+    // Gun window: on 0.25" after start, off 0.5" before end
+    if (!runPaintSweep(withTrayGunWindows(makePaintSweep(SWEEP_AXIS_Y, startY_steps, finalY, current_paint_y_speed,
+                                                         0.25f, 0.5f, "Side2State"), SIDE2_ROTATION_ANGLE))) {
+        abortPaintSide("Side2State");
+        return;
     }
     
-    paintGun_OFF();
     currentY = finalY;
     
     // Move to next sweep or finish
@@ -417,8 +332,11 @@ void Side2State::executeYSweep(int sweepNumber) {
 
 void Side2State::performCombinedXShiftYMove() {
     // Wait for modifier button release
-    while(digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-        delay(10);
+    {
+        PhaseScope buttonWait(PHASE_BUTTON_WAIT);
+        while(digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
+            delay(10);
+        }
     }
     
     Serial.printf("Side2State: Combined shift -X and move to top Y after sweep %d at fast speed\n", currentSweep);
@@ -1,8 +1,11 @@
 #include <Arduino.h>
 #include "../../include/system/StateMachine.h"
+#include "../../include/states/HomingState.h" // For requestVerifyHome
 #include "../../include/states/State.h"
 #include "../../include/states/PaintingState.h"
 #include "../../include/motors/XYZ_Movements.h"
+#include "../../include/motors/PaintSweep.h"
+#include "../../include/motors/TrayLayout.h"
 #include "../../include/utils/settings.h"
 #include "../../include/motors/Rotation_Motor.h"
 #include "../../include/hardware/paintGun_Functions.h"
@@ -13,6 +16,7 @@
 #include "../../include/motors/ServoMotor.h"
 #include "../../include/web/Web_Dashboard_Commands.h"
 #include "../config/Pins_Definitions.h"
+#include "system/PhaseStats.h" // Modifier waits count as button-wait time
 
 // External references
 extern FastAccelStepper *stepperX;
@@ -80,18 +84,16 @@ private:
     long paint_x_speed;
     long paint_y_speed;
     long final_sweep_paint_x_speed_side3;
-    bool paintGunActivated;
-    bool paintGunDeactivated;
-    unsigned long moveStartTime;
     
     // Helper methods
     void performCurrentStep();
     void transitionToNextStep();
-    void executeXSweep(bool isNegativeDirection, bool isFinalSweep = false);
+    bool isModifierWaitStep() const;
+    bool executeXSweep(bool isNegativeDirection, bool isFinalSweep = false); // false if the sweep was aborted
     void performYShift();
 };
 
-Side3State::Side3State() : currentStep(S3_IDLE), paintGunActivated(false), paintGunDeactivated(false) {
+Side3State::Side3State() : currentStep(S3_IDLE) {
     Serial.println("Side3State: Constructor called");
 }
 
@@ -107,6 +109,7 @@ void Side3State::update() {
 void Side3State::exit() {
     Serial.println("Side3State: Exiting Side 3 painting state");
     paintGun_OFF();
+    setPhaseBackground(PHASE_OTHER); // A stop or home mid-wait is not button wait
 }
 
 const char* Side3State::getName() const {
@@ -173,8 +176,9 @@ void Side3State::performCurrentStep() {
             break;
             
         case S3_EXECUTE_FIRST_X_SWEEP:
-            executeXSweep(true, false); // -X direction, not final
-            transitionToNextStep();
+            if (executeXSweep(true, false)) { // -X direction, not final
+                transitionToNextStep();
+            }
             break;
             
         case S3_WAIT_FOR_MODIFIER_BUTTON_1:
@@ -195,8 +199,9 @@ void Side3State::performCurrentStep() {
             break;
             
         case S3_EXECUTE_SECOND_X_SWEEP:
-            executeXSweep(false, false); // +X direction, not final
-            transitionToNextStep();
+            if (executeXSweep(false, false)) { // +X direction, not final
+                transitionToNextStep();
+            }
             break;
             
         case S3_WAIT_FOR_MODIFIER_BUTTON_3:
@@ -217,8 +222,9 @@ void Side3State::performCurrentStep() {
             break;
             
         case S3_EXECUTE_THIRD_X_SWEEP:
-            executeXSweep(true, false); // -X direction, not final
-            transitionToNextStep();
+            if (executeXSweep(true, false)) { // -X direction, not final
+                transitionToNextStep();
+            }
             break;
             
         case S3_WAIT_FOR_MODIFIER_BUTTON_5:
@@ -239,8 +245,9 @@ void Side3State::performCurrentStep() {
             break;
             
         case S3_EXECUTE_FOURTH_X_SWEEP:
-            executeXSweep(false, false); // +X direction, not final
-            transitionToNextStep();
+            if (executeXSweep(false, false)) { // +X direction, not final
+                transitionToNextStep();
+            }
             break;
             
         case S3_WAIT_FOR_MODIFIER_BUTTON_7:
@@ -261,8 +268,9 @@ void Side3State::performCurrentStep() {
             break;
             
         case S3_EXECUTE_FIFTH_X_SWEEP:
-            executeXSweep(true, true); // -X direction, final sweep
-            transitionToNextStep();
+            if (executeXSweep(true, true)) { // -X direction, final sweep
+                transitionToNextStep();
+            }
             break;
             
         case S3_WAIT_FOR_MODIFIER_BUTTON_FINAL:
@@ -293,6 +301,7 @@ void Side3State::performCurrentStep() {
                 paintingState->onSideCompleted(); // Notify that this side is complete
             } else {
                 Serial.println("Side3State: Individual side mode - transitioning to homing");
+                requestVerifyHome(); // Job finished - a verify-home is enough
                 stateMachine->changeState(stateMachine->getHomingState());
             }
             break;
@@ -301,9 +310,28 @@ void Side3State::performCurrentStep() {
 
 void Side3State::transitionToNextStep() {
     currentStep = static_cast<Side3SubStep>(static_cast<int>(currentStep) + 1);
+    // Time until the wait step passes is button wait (system/PhaseStats.h)
+    setPhaseBackground(isModifierWaitStep() ? PHASE_BUTTON_WAIT : PHASE_OTHER);
 }
 
-void Side3State::executeXSweep(bool isNegativeDirection, bool isFinalSweep) {
+bool Side3State::isModifierWaitStep() const {
+    switch (currentStep) {
+        case S3_WAIT_FOR_MODIFIER_BUTTON_1:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_2:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_3:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_4:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_5:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_6:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_7:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_8:
+        case S3_WAIT_FOR_MODIFIER_BUTTON_FINAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool Side3State::executeXSweep(bool isNegativeDirection, bool isFinalSweep) {
     long finalX;
     long current_paint_x_speed = isFinalSweep ? final_sweep_paint_x_speed_side3 : paint_x_speed;
     
@@ -319,63 +347,15 @@ void Side3State::executeXSweep(bool isNegativeDirection, bool isFinalSweep) {
         Serial.printf("Side3State: Applying 75%% speed for final sweep: %ld\n", current_paint_x_speed);
     }
     
-    float totalDistance = (float)sweepX_steps / STEPS_PER_INCH_XYZ;
-    float timeToStart = 0.25f * STEPS_PER_INCH_XYZ / (float)current_paint_x_speed;
-    float timeToStop = (totalDistance - 0.5f) * STEPS_PER_INCH_XYZ / (float)current_paint_x_speed;
-    
-    moveStartTime = millis();
-    stepperX->moveTo(finalX);
-    stepperX->setSpeedInHz(current_paint_x_speed);
-    
-    paintGunActivated = false;
-    paintGunDeactivated = false;
-    
-    while(stepperX->isRunning()) {
-        unsigned long currentTime = millis();
-        float elapsedSeconds = (currentTime - moveStartTime) / 1000.0f;
-        
-        // Check for pause button press
-        if (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-            bool wasGunOn = paintGunActivated && !paintGunDeactivated;
-            if (wasGunOn) {
-                paintGun_OFF();
-                Serial.println("Side3State: Paint gun OFF (paused)");
-            }
-            stepperX->forceStop();
-            Serial.println("Side3State: Movement paused");
-            
-            // Wait for button release
-            while (digitalRead(MODIFIER_BUTTON_RIGHT) == LOW) {
-                delay(10);
-            }
-            
-            // Resume movement
-            stepperX->moveTo(finalX);
-            stepperX->setSpeedInHz(current_paint_x_speed);
-            moveStartTime = millis() - (unsigned long)(elapsedSeconds * 1000); // Adjust start time
-            if (wasGunOn && elapsedSeconds >= timeToStart && elapsedSeconds < timeToStop) {
-                paintGun_ON();
-                Serial.println("Side3State: Paint gun ON (resumed)");
-            }
-            Serial.println("Side3State: Movement resumed");
-        }
-        
-        if (!paintGunActivated && elapsedSeconds >= timeToStart) {
-            paintGun_ON();
-            paintGunActivated = true;
-        }
-        
-        if (paintGunActivated && !paintGunDeactivated && elapsedSeconds >= timeToStop) {
-            paintGun_OFF();
-            paintGunDeactivated = true;
-        }
-        
-        processWebSocketEventsFrequently();
-        delay(1);
+    // Gun window: on 0.25" after start, off 0.5" before end
+    if (!runPaintSweep(withTrayGunWindows(makePaintSweep(SWEEP_AXIS_X, currentX, finalX, current_paint_x_speed,
+                                                         0.25f, 0.5f, "Side3State"), SIDE3_ROTATION_ANGLE))) {
+        abortPaintSide("Side3State");
+        return false;
     }
     
-    paintGun_OFF();
     currentX = finalX;
+    return true;
 }
 
 void Side3State::performYShift() {
@@ -7,6 +7,7 @@
 #include <Arduino.h>
 #include "utils/settings.h" 
 #include "motors/XYZ_Movements.h"
+#include "motors/StopAll.h"
 #include "hardware/cylinder_Functions.h"
 #include "hardware/vacuum_Functions.h"
 #include "system/StateMachine.h"
@@ -14,16 +15,19 @@
 #include "settings/pnp.h"
 #include "system/machine_state.h"  // For physicalHomeButtonPressed
 #include "hardware/controlPanel_Functions.h"  // For paintAllSidesTwice function
+#include "motors/TrayLayout.h"  // Tray occupancy for painting
+#include "storage/TrayDefinitions.h"  // Runtime tray layouts and placement table
+#include "hardware/Pneumatics.h"  // Polled pick/place actuation steps
+#include "motors/PnPPlanner.h"  // Placement order
+#include "persistence/PaintingSettings.h"  // Side 4 start, where painting begins
+#include "system/PhaseStats.h"  // Phase time breakdown
+#include "web/Web_Dashboard_Commands.h"  // Dashboard pumped from the PnP wait loops
 
 // ===========================================================================
 //                              PNP CONFIGURATION  
 // ===========================================================================
 struct PnPConfig {
-    // Grid positions (calculated once)
-    float gridX[GRID_ROWS * GRID_COLS];
-    float gridY[GRID_ROWS * GRID_COLS];
-    
-    // Pick location in steps
+    // Pick location in steps (placement targets come from the active tray)
     long pickX_steps;
     long pickY_steps;
     
@@ -51,23 +55,7 @@ bool pnp_checkForHomeButton() {
         Serial.println("PnP: HOME button pressed - aborting PnP operation!");
         
         // Stop all motors immediately
-        extern FastAccelStepper* stepperX;
-        extern FastAccelStepper* stepperY_Left;
-        extern FastAccelStepper* stepperY_Right;
-        extern FastAccelStepper* stepperZ;
-        
-        if (stepperX && stepperX->isRunning()) {
-            stepperX->forceStopAndNewPosition(stepperX->getCurrentPosition());
-        }
-        if (stepperY_Left && stepperY_Left->isRunning()) {
-            stepperY_Left->forceStopAndNewPosition(stepperY_Left->getCurrentPosition());
-        }
-        if (stepperY_Right && stepperY_Right->isRunning()) {
-            stepperY_Right->forceStopAndNewPosition(stepperY_Right->getCurrentPosition());
-        }
-        if (stepperZ && stepperZ->isRunning()) {
-            stepperZ->forceStopAndNewPosition(stepperZ->getCurrentPosition());
-        }
+        stopAllAxes();
         
         // Turn off vacuum and retract cylinder for safety
         vacuumOff();
@@ -88,6 +76,31 @@ bool pnp_checkForHomeButton() {
     return false;
 }
 
+/**
+ * @brief Keeps the dashboard serviced from the PnP wait loops, which hold off
+ * loop() for the whole pick and place. A dashboard HOME changes state while
+ * events are pumped (and HomingState::enter() clears its flag), so leaving
+ * the state the wait started in is the abort signal.
+ * @return true if the operation should abort
+ */
+static bool pnp_serviceDashboard(State* pnpState) {
+    extern StateMachine* stateMachine;
+    processWebSocketEventsFrequently();
+    if (stateMachine && stateMachine->getCurrentState() != pnpState) {
+        Serial.println("PnP: State changed from the dashboard - aborting PnP operation");
+        stopAllAxes();
+        vacuumOff();
+        cylinderUp();
+        return true;
+    }
+    return false;
+}
+
+static State* pnp_currentState() {
+    extern StateMachine* stateMachine;
+    return stateMachine ? stateMachine->getCurrentState() : nullptr;
+}
+
 // ===========================================================================
 //                              SENSOR RELEASE FUNCTION
 // ===========================================================================
@@ -109,6 +122,7 @@ bool pnp_waitForSensorRelease() {
     
     const unsigned long RELEASE_TIMEOUT_MS = 10000; // 10 second timeout
     unsigned long startTime = millis();
+    State* pnpState = pnp_currentState();
     
     while (true) {
         // Check for timeout
@@ -139,6 +153,9 @@ bool pnp_waitForSensorRelease() {
             lastPrint = millis();
         }
         
+        if (pnp_serviceDashboard(pnpState)) {
+            return false; // Abort operation
+        }
         delay(10); // Small delay to prevent busy waiting
     }
 }
@@ -147,23 +164,15 @@ bool pnp_waitForSensorRelease() {
 //                              CORE PNP FUNCTIONS
 // ===========================================================================
 
-void pnp_calculateGridPositions() {
-    const float X_SHIFT = 9.4f; // Inches between columns  
-    const float Y_SHIFT = 5.0f; // Inches between rows
-    
-    for (int row = 0; row < GRID_ROWS; row++) {
-        for (int col = 0; col < GRID_COLS; col++) {
-            int index = row * GRID_COLS + col;
-            g_pnp.gridX[index] = GRID_ORIGIN_X - (col * X_SHIFT);
-            g_pnp.gridY[index] = GRID_ORIGIN_Y - (row * Y_SHIFT);
-        }
-    }
-    Serial.println("PnP: Grid positions calculated");
+// Logs which cell of the active tray a position is
+static void pnp_logPosition(const char* action, int position) {
+    int cols = getActiveTray().cols;
+    Serial.printf("PnP: %s Row %d Col %d (position %d)\n", action, (position - 1) / cols + 1,
+                  (position - 1) % cols + 1, position);
 }
 
 void pnp_initialize() {
     if (!g_pnp.isInitialized) {
-        pnp_calculateGridPositions();
         g_pnp.pickX_steps = (long)(PICK_LOCATION_X * STEPS_PER_INCH_XYZ);
         g_pnp.pickY_steps = (long)(PICK_LOCATION_Y * STEPS_PER_INCH_XYZ);
         g_pnp.isInitialized = true;
@@ -176,6 +185,7 @@ bool pnp_waitForSensor(const char* message = "Waiting for cycle sensor...") {
     
     const unsigned long SENSOR_TIMEOUT_MS = 30000; // 30 second timeout
     unsigned long startTime = millis();
+    State* pnpState = pnp_currentState();
     
     while (true) {
         // Check for timeout first
@@ -207,6 +217,9 @@ bool pnp_waitForSensor(const char* message = "Waiting for cycle sensor...") {
             lastPrint = millis();
         }
         
+        if (pnp_serviceDashboard(pnpState)) {
+            return false; // Abort operation
+        }
         delay(10); // Small delay to prevent busy waiting
     }
 }
@@ -231,24 +244,90 @@ bool pnp_moveToPickLocation(const char* reason = "Moving to pick location") {
     return true;
 }
 
+// Extend, grip, retract until clear
+static const PneumaticStep kPickSteps[] = { PNEUMATIC_PICK_EXTEND, PNEUMATIC_PICK_GRIP, PNEUMATIC_PICK_RETRACT };
+// Extend, release, retract until clear
+static const PneumaticStep kPlaceSteps[] = { PNEUMATIC_PLACE_EXTEND, PNEUMATIC_PLACE_RELEASE, PNEUMATIC_PLACE_RETRACT };
+
+// Move started by pnp_runActuation() once the head is clear
+struct PnPTravel {
+    long x;
+    long y;
+    unsigned int xSpeed;
+    unsigned int ySpeed;
+};
+
+//! Runs a pick or place sequence from one poll loop. The next step starts on
+//! the poll its predecessor finishes, the travel starts on the poll the
+//! retract reports clear (the cylinder finishes rising while the gantry
+//! moves), and the cycle sensor release is watched throughout. The
+//! dashboard is pumped on every poll, so it stays responsive while loop()
+//! is held off.
+//! Extend, vacuum and release need the head stationary, so they never
+//! overlap a move.
+static bool pnp_runActuation(const PneumaticStep (&steps)[3], const PnPTravel* travel,
+                             bool* released = nullptr, unsigned long* clearAtMs = nullptr) {
+    int index = 0;
+    bool travelling = false;
+    State* pnpState = pnp_currentState();
+    startPneumaticStep(steps[0]);
+    while (index < 3 || travelling) {
+        if (pnp_checkForHomeButton()) {
+            return false;
+        }
+        if (index < 3) {
+            PneumaticStepStatus status = updatePneumaticStep();
+            if (status == PNEUMATIC_FAILED) {
+                //! A switch did not confirm (no part, low air) - leave the head safe
+                Serial.println("PnP: Pneumatic step failed - vacuum off, cylinder retracted");
+                vacuumOff();
+                cylinderUp();
+                return false;
+            }
+            if (status == PNEUMATIC_DONE) {
+                if (++index < 3) {
+                    startPneumaticStep(steps[index]);
+                    continue;
+                }
+                if (clearAtMs) {
+                    *clearAtMs = max(1UL, millis()); // 0 means "not clear yet"
+                }
+                if (travel) {
+                    if (!startMoveToXYZ(travel->x, travel->xSpeed, travel->y, travel->ySpeed, 0, DEFAULT_Z_SPEED)) {
+                        return false;
+                    }
+                    travelling = true;
+                }
+            }
+        }
+        if (travelling) {
+            if (!serviceMoveToXYZ()) {
+                return false;
+            }
+            travelling = isMoveToXYZRunning();
+        }
+        if (released && !*released) {
+            g_pnpCycleSensorDebouncer.update();
+            *released = g_pnpCycleSensorDebouncer.read() == HIGH;
+        }
+        //? serviceMoveToXYZ() already pumps the dashboard while travelling
+        if (!travelling && index < 3 && pnp_serviceDashboard(pnpState)) {
+            return false;
+        }
+        if (index < 3 || travelling) {
+            delay(1);
+        }
+    }
+    return true;
+}
+
 bool pnp_pickComponent() {
     Serial.println("PnP: Picking component...");
     
     // Check for home button before each step
     if (pnp_checkForHomeButton()) return false;
     
-    cylinderDown();
-    delay(PNP_PICK_DELAY_AFTER_CYLINDER_EXTEND);
-    
-    if (pnp_checkForHomeButton()) return false;
-    
-    vacuumOn();
-    delay(PNP_PICK_DELAY_AFTER_VACUUM_ON + 50);
-    
-    if (pnp_checkForHomeButton()) return false;
-    
-    cylinderUp();
-    delay(PNP_PICK_DELAY_AFTER_CYLINDER_RETRACT);
+    if (!pnp_runActuation(kPickSteps, nullptr)) return false;
     
     Serial.println("PnP: Component picked");
     return true;
@@ -258,25 +337,14 @@ bool pnp_placeComponent(int position) {
     // Check for home button before starting
     if (pnp_checkForHomeButton()) return false;
     
-    // Convert position (1-10) to array index (0-9)
-    int gridIndex = position - 1;
-    
-    if (gridIndex < 0 || gridIndex >= (GRID_ROWS * GRID_COLS)) {
+    // Precomputed placement target for the active tray
+    long targetX_steps, targetY_steps;
+    if (!getTrayPlacementSteps(position, targetX_steps, targetY_steps) || isTrayPositionSkipped(position)) {
         Serial.printf("ERROR: Invalid position %d\n", position);
         return false;
     }
     
-    // Get target coordinates
-    float targetX = g_pnp.gridX[gridIndex];
-    float targetY = g_pnp.gridY[gridIndex];
-    long targetX_steps = (long)(targetX * STEPS_PER_INCH_XYZ);
-    long targetY_steps = (long)(targetY * STEPS_PER_INCH_XYZ);
-    
-    int row = gridIndex / GRID_COLS + 1;
-    int col = gridIndex % GRID_COLS;
-    const char* colName = (col == LEFT_COLUMN) ? "Left" : "Right";
-    
-    Serial.printf("PnP: Moving to Row %d %s (position %d)\n", row, colName, position);
+    pnp_logPosition("Moving to", position);
     
     // Check for home button before movement
     if (pnp_checkForHomeButton()) return false;
@@ -293,20 +361,9 @@ bool pnp_placeComponent(int position) {
     // Check for home button before each step
     if (pnp_checkForHomeButton()) return false;
     
-    cylinderDown();
-    delay(PNP_PLACE_DELAY_AFTER_CYLINDER_EXTEND);
+    if (!pnp_runActuation(kPlaceSteps, nullptr)) return false;
     
-    if (pnp_checkForHomeButton()) return false;
-    
-    vacuumOff();
-    delay(PNP_PLACE_DELAY_AFTER_VACUUM_OFF);
-    
-    if (pnp_checkForHomeButton()) return false;
-    
-    cylinderUp();
-    delay(PNP_PLACE_DELAY_AFTER_CYLINDER_RETRACT);
-    
-    Serial.printf("PnP: Component placed at Row %d %s\n", row, colName);
+    pnp_logPosition("Component placed at", position);
     return true;
 }
 
@@ -338,6 +395,8 @@ bool pnp_processSinglePosition(int position) {
         Serial.println("PnP: Operation aborted during place");
         return false;
     }
+    setTrayPositionOccupied(position, true);
+    saveTrayOccupancy();
     
     // Step 5: Wait for sensor to be released before continuing
     if (!pnp_waitForSensorRelease()) {
@@ -365,61 +424,157 @@ bool pnp_processSinglePosition(int position) {
 // ===========================================================================
 // These are the functions you actually call - much simpler!
 
-void startPnPFullCycle() {
+//* ************************************************************************
+//* ************************ PIPELINED FULL CYCLE **************************
+//* ************************************************************************
+// The full cycle overlaps work the single-position cycle does in sequence:
+// the travel after each pick and place starts from the actuation poll loop
+// as soon as the head is clear, and the sensor release is watched from the
+// place steps on. Pneumatic steps that need the head stationary (extend,
+// vacuum, release) are not overlapped with motion.
+
+enum PnPPhase {
+    PNP_PHASE_SENSOR_WAIT,      // Waiting for the cycle sensor at the pick location
+    PNP_PHASE_PICK,             // Extend, vacuum, retract until clear (travel starts at clear)
+    PNP_PHASE_TRAVEL_TO_PLACE,
+    PNP_PHASE_PLACE,            // Extend, release, retract until clear
+    PNP_PHASE_RETURN,           // Travel back from clear, overlapped with the sensor release wait
+    PNP_PHASE_RELEASE_WAIT,     // Sensor release still pending after arriving
+    PNP_PHASE_COUNT
+};
+
+static const char* const kPnPPhaseNames[PNP_PHASE_COUNT] = {
+    "sensor wait", "pick", "to place", "place", "return", "release wait"
+};
+
+struct PnPPhaseTiming {
+    unsigned long totalMs[PNP_PHASE_COUNT];
+    unsigned long maxMs[PNP_PHASE_COUNT];
+    int parts;
+};
+
+// Charges phaseStartMs..endMs (default now) to phase; the next phase starts at endMs
+static void pnp_recordPhase(PnPPhaseTiming& timing, PnPPhase phase, unsigned long& phaseStartMs,
+                            unsigned long partMs[PNP_PHASE_COUNT], unsigned long endMs = 0) {
+    unsigned long now = endMs != 0 ? endMs : millis();
+    unsigned long elapsed = now - phaseStartMs;
+    partMs[phase] += elapsed;
+    timing.totalMs[phase] += elapsed;
+    timing.maxMs[phase] = max(timing.maxMs[phase], elapsed);
+    phaseStartMs = now;
+}
+
+static void pnp_printPhaseTiming(const PnPPhaseTiming& timing, unsigned long cycleMs) {
+    Serial.printf("PnP timing: %d part(s) in %.2f s\n", timing.parts, cycleMs / 1000.0f);
+    Serial.println("PnP timing:   phase          total s   avg ms   max ms   share");
+    for (int phase = 0; phase < PNP_PHASE_COUNT; phase++) {
+        unsigned long avgMs = timing.parts > 0 ? timing.totalMs[phase] / timing.parts : 0;
+        float share = cycleMs > 0 ? 100.0f * timing.totalMs[phase] / cycleMs : 0.0f;
+        Serial.printf("PnP timing:   %-13s %8.2f %8lu %8lu %6.1f%%\n", kPnPPhaseNames[phase],
+                      timing.totalMs[phase] / 1000.0f, avgMs, timing.maxMs[phase], share);
+    }
+}
+
+
+void startPnPFullCycle(int coats) {
+    beginPhaseJob(); // Placement and the painting it hands over to are one job
     pnp_initialize();
-    Serial.println("PnP: Starting full cycle (positions 1-10)");
+    int positionCount = getTrayPositionCount();
+    Serial.printf("PnP: Starting pipelined full cycle (tray %d, positions 1-%d)\n", getActiveTraySlot(), positionCount);
     
     if (!pnp_moveToPickLocation("Starting full cycle")) {
         Serial.println("PnP: Full cycle aborted during initial move");
         return;
     }
     
-    for (int pos = 1; pos <= (GRID_ROWS * GRID_COLS); pos++) {
-        Serial.printf("\n=== PnP Full Cycle: Position %d of %d ===\n", pos, GRID_ROWS * GRID_COLS);
+    // Occupancy is rebuilt in RAM as parts go down and saved once below, so an
+    // aborted cycle leaves a partial tray map
+    setTrayOccupancy(0, false);
+    
+    // Painting starts at the Side 4 start position once the tray is full
+    PnPPlacementPlan plan;
+    planPnPPlacementOrder(plan, g_pnp.pickX_steps, g_pnp.pickY_steps,
+                          (long)(paintingSettings.getSide4StartX() * STEPS_PER_INCH_XYZ),
+                          (long)(paintingSettings.getSide4StartY() * STEPS_PER_INCH_XYZ));
+    
+    PnPPhaseTiming timing = {};
+    unsigned long cycleStartMs = millis();
+    
+    int index;
+    for (index = 0; index < plan.count; index++) {
+        int pos = plan.order[index];
+        bool lastPart = index == plan.count - 1;
+        Serial.printf("\n=== PnP Full Cycle: Position %d (%d of %d) ===\n", pos, index + 1, plan.count);
+        unsigned long partMs[PNP_PHASE_COUNT] = {0};
+        unsigned long phaseStartMs = millis();
         
         // Wait for sensor activation
         if (!pnp_waitForSensor()) {
             Serial.println("PnP: Full cycle aborted during sensor wait");
-            return;
+            break;
         }
+        pnp_recordPhase(timing, PNP_PHASE_SENSOR_WAIT, phaseStartMs, partMs);
         
-        // Pick component
-        if (!pnp_pickComponent()) {
-            Serial.println("PnP: Full cycle aborted during pick");
-            return;
+        // Pick component, then travel to the place location while the cylinder finishes retracting
+        long placeX, placeY;
+        getTrayPlacementSteps(pos, placeX, placeY);
+        pnp_logPosition("Moving to", pos);
+        PnPTravel toPlace = { placeX, placeY, DEFAULT_X_SPEED, DEFAULT_Y_SPEED };
+        unsigned long clearMs = 0;
+        if (!pnp_runActuation(kPickSteps, &toPlace, nullptr, &clearMs)) {
+            Serial.println(clearMs ? "PnP: Full cycle aborted during travel to place" : "PnP: Full cycle aborted during pick");
+            break;
         }
+        pnp_recordPhase(timing, PNP_PHASE_PICK, phaseStartMs, partMs, clearMs);
+        pnp_recordPhase(timing, PNP_PHASE_TRAVEL_TO_PLACE, phaseStartMs, partMs);
         
-        // Place component
-        if (!pnp_placeComponent(pos)) {
-            Serial.println("PnP: Full cycle aborted during place");
-            return;
+        //! Place component, then pre-position at the pick location while watching for the sensor release
+        extern float g_pnp_x_speed, g_pnp_x_accel, g_pnp_y_speed, g_pnp_y_accel;
+        PnPTravel toPick = { g_pnp.pickX_steps, g_pnp.pickY_steps, (unsigned int)g_pnp_x_speed, (unsigned int)g_pnp_y_speed };
+        bool released = false;
+        clearMs = 0;
+        bool placed = pnp_runActuation(kPlaceSteps, lastPart ? nullptr : &toPick, &released, &clearMs);
+        if (clearMs) {
+            setTrayPositionOccupied(pos, true); // The part is down even if the return move was aborted
+        }
+        if (!placed) {
+            Serial.println(clearMs ? "PnP: Full cycle aborted during return move" : "PnP: Full cycle aborted during place");
+            break;
         }
+        pnp_recordPhase(timing, PNP_PHASE_PLACE, phaseStartMs, partMs, clearMs);
+        if (lastPart) {
+            Serial.println("PnP: Last part placed - painting starts from here, skipping the return to pick");
+        }
+        pnp_recordPhase(timing, PNP_PHASE_RETURN, phaseStartMs, partMs);
         
-        // Wait for sensor to be released before continuing to next position
-        if (!pnp_waitForSensorRelease()) {
+        if (released) {
+            Serial.println("PnP: Sensor released during return travel");
+        } else if (!pnp_waitForSensorRelease()) {
             Serial.println("PnP: Full cycle aborted during sensor release wait");
-            return;
+            break;
         }
+        pnp_recordPhase(timing, PNP_PHASE_RELEASE_WAIT, phaseStartMs, partMs);
         
-        // Return to pick location for next cycle (or completion)
-        if (pos < (GRID_ROWS * GRID_COLS)) {
-            if (!pnp_moveToPickLocation("Preparing for next position")) {
-                Serial.println("PnP: Full cycle aborted during return move");
-                return;
-            }
-        } else {
-            if (!pnp_moveToPickLocation("Full cycle complete - final return")) {
-                Serial.println("PnP: Full cycle aborted during final return");
-                return;
-            }
-        }
+        timing.parts++;
+        Serial.printf("PnP: Position %d timing (ms) - sensor %lu, pick %lu, to place %lu, place %lu, return %lu, release %lu\n",
+                      pos, partMs[PNP_PHASE_SENSOR_WAIT], partMs[PNP_PHASE_PICK], partMs[PNP_PHASE_TRAVEL_TO_PLACE],
+                      partMs[PNP_PHASE_PLACE], partMs[PNP_PHASE_RETURN], partMs[PNP_PHASE_RELEASE_WAIT]);
+    }
+    bool completed = index == plan.count;
+    
+    pnp_printPhaseTiming(timing, millis() - cycleStartMs);
+    saveTrayOccupancy();
+    Serial.printf("PnP: Tray occupancy saved: %s\n", trayOccupancyString().c_str());
+    if (!completed) {
+        return;
     }
+    reportPnPPlanOutcome(plan, timing.totalMs[PNP_PHASE_TRAVEL_TO_PLACE] + timing.totalMs[PNP_PHASE_RETURN]);
     
     Serial.println("PnP: Full cycle completed!");
     
-    // Automatically start painting all sides twice after PnP completion
-    Serial.println("PnP: Starting automatic painting sequence (all sides twice)...");
-    paintAllSidesTwice();
+    // Automatically start painting all sides after PnP completion
+    Serial.printf("PnP: Starting automatic painting sequence (all sides, %d coat(s))...\n", coats);
+    paintAllSidesCoats(coats);
 }
 
 // Individual position functions - now just simple wrappers
@@ -436,11 +591,11 @@ void pnpRow5Right() { pnp_processSinglePosition(10); }
 
 // Even simpler - direct position access
 void pnpPosition(int position) {
-    if (position >= 1 && position <= (GRID_ROWS * GRID_COLS)) {
+    if (position >= 1 && position <= getTrayPositionCount() && !isTrayPositionSkipped(position)) {
         pnp_processSinglePosition(position);
     } else {
-        Serial.printf("ERROR: Invalid position %d. Valid range: 1-%d\n", 
-                     position, GRID_ROWS * GRID_COLS);
+        Serial.printf("ERROR: Invalid position %d. Valid range: 1-%d (tray %d)\n", 
+                     position, getTrayPositionCount(), getActiveTraySlot());
     }
 }
 
@@ -8,6 +8,8 @@
 #include "system/StateMachine.h" 
 // #include "motors/XYZ_Movements.h" // XYZ_Movements likely included via Homing.h if needed
 #include "motors/Homing.h" // Include the new Homing class header
+#include "motors/LimitSwitches.h"
+#include "system/JobQueue.h" // Home and stop requests hold the job queue
 
 // Add extern declaration for homeCommandReceived
 extern volatile bool homeCommandReceived;
@@ -15,6 +17,21 @@ extern volatile bool homeCommandReceived;
 // // Declare global variables used by the homing state
 // const unsigned long HOMING_SWITCH_DEBOUNCE_MS = 3; // Moved to Homing class
 bool homeAfterMovement = false; // Keep this if it's used elsewhere for triggering homing
+static bool verifyHomeRequested = false; // One-shot, consumed by the next enter()
+static bool lastHomingSucceeded = false;
+static uint32_t homingCycleCount = 0;
+
+void requestVerifyHome() {
+    verifyHomeRequested = isVerifyHomeAfterJobsEnabled();
+}
+
+bool didLastHomingSucceed() {
+    return lastHomingSucceeded;
+}
+
+uint32_t getHomingCycleCount() {
+    return homingCycleCount;
+}
 
 // // Bounce objects for debouncing the homing switches - Moved to Homing class
 // Bounce xHomeSwitch = Bounce();
@@ -58,7 +75,8 @@ HomingState::HomingState() :
     _homingController(nullptr), // Initialize pointer
     _isHoming(false),
     _homingComplete(false),
-    _homingSuccess(false)
+    _homingSuccess(false),
+    _verifyHome(false)
 { 
     // Constructor implementation
 }
@@ -71,9 +89,23 @@ void HomingState::enter() {
     Serial.println("Entering Homing State");
     
     // Reset both home command flags since we're now processing them
-    homeCommandReceived = false;
     extern volatile bool physicalHomeButtonPressed;
+    if (homeCommandReceived || physicalHomeButtonPressed) {
+        holdJobQueue("home or stop requested");
+    }
+    homeCommandReceived = false;
     physicalHomeButtonPressed = false;
+
+    //! A latched fault always gets a full homing cycle
+    _verifyHome = verifyHomeRequested && !isLimitFaultLatched();
+    verifyHomeRequested = false;
+
+    //! Homing drives onto the switches on purpose - disarm limit monitoring
+    //! and clear any fault that led here (positions are re-established below)
+    if (isLimitFaultLatched()) {
+        clearLimitFault();
+    }
+    setLimitMonitoringEnabled(false);
     
     // Prepare for homing
     delete _homingController; // Delete previous instance if any
@@ -90,11 +122,16 @@ void HomingState::update() {
     // If homing process hasn't completed yet
     if (_isHoming && !_homingComplete) {
         if (_homingController) {
-            Serial.println("Executing Homing::homeAllAxes()...");
-            _homingSuccess = _homingController->homeAllAxes(); // BLOCKING CALL
+            if (_verifyHome) {
+                Serial.println("Executing Homing::verifyHome()...");
+                _homingSuccess = _homingController->verifyHome(); // BLOCKING CALL
+            } else {
+                Serial.println("Executing Homing::homeAllAxes()...");
+                _homingSuccess = _homingController->homeAllAxes(); // BLOCKING CALL
+            }
             _homingComplete = true; // Mark as complete
             _isHoming = false;      // No longer actively homing
-            Serial.println("Homing::homeAllAxes() finished.");
+            Serial.println("Homing finished.");
         } else {
             Serial.println("ERROR: HomingController is null in HomingState::update()!");
             _homingComplete = true; // Mark complete to allow transition
@@ -103,17 +140,19 @@ void HomingState::update() {
         }
     }
     
-    // If homing is marked as complete, transition back to Idle
+    // If homing is marked as complete, transition to Idle (or Error if it failed)
     if (_homingComplete) {
+        lastHomingSucceeded = _homingSuccess;
+        homingCycleCount++;
         if (_homingSuccess) {
             Serial.println("Homing successful, transitioning to IDLE state.");
         } else {
-            Serial.println("Homing failed, transitioning to IDLE state.");
-            // Future: Transition to ErrorState?
+            //! Positions can't be trusted - moves stay refused until a homing succeeds
+            Serial.println("Homing failed, transitioning to ERROR state.");
         }
         
         if (stateMachine) {
-            stateMachine->changeState(stateMachine->getIdleState()); 
+            stateMachine->changeState(_homingSuccess ? stateMachine->getIdleState() : stateMachine->getErrorState());
             // Reset flag for next entry after transition
             _homingComplete = false; 
         } else {
@@ -128,6 +167,7 @@ void HomingState::exit() {
      Serial.println("Exiting Homing State");
      delete _homingController; // Clean up controller
      _homingController = nullptr;
+     setLimitMonitoringEnabled(true);
      _isHoming = false;
      _homingComplete = false;
 }
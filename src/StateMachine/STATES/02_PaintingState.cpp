@@ -1,7 +1,8 @@
 #include "states/PaintingState.h"
 #include <Arduino.h>
-#include "motors/PaintingSides.h" // Include header for paintAllSides
+#include "motors/PaintingSides.h" // Side patterns, coats and flash-off
 #include "system/StateMachine.h"  // Include header for StateMachine access
+#include "states/HomingState.h"   // For requestVerifyHome
 // #include "motors/Homing.h"        // REMOVE: Homing will be handled by HomingState
 #include <FastAccelStepper.h>      // Include for stepper access
 #include "persistence/PaintingSettings.h"
@@ -11,6 +12,10 @@
 #include "motors/XYZ_Movements.h"      // ADDED: For moveToXYZ
 #include "utils/settings.h"            // ADDED: For default speeds
 #include "system/GlobalState.h"        // ADDED: For isPaused global variable
+#include "system/DryingScheduler.h"    // Per-side drying and drying-window jobs
+#include "system/CycleEstimator.h"     // Progress and ETA
+#include "system/PhaseStats.h"         // Phase time breakdown
+#include "web/Web_Dashboard_Commands.h" // For checkForPauseCommand
 
 // Define necessary variables or includes specific to PaintingState if known
 // #include "settings.h"
@@ -29,10 +34,35 @@ extern FastAccelStepper* stepperZ;
 //* ************************* PAINTING STATE ***************************
 //* ************************************************************************
 
-PaintingState::PaintingState() : currentStep(PS_IDLE) {
+PaintingState::PaintingState() : currentStep(PS_IDLE), totalCoats(1), coat(1), sideIndex(0),
+    sideOrder{4, 3, 2, 1}, sideStartMs(0), dryingStartMs(0), dryingJobsRun(false) {
     // Constructor implementation
 }
 
+void PaintingState::startJob(int coats) {
+    totalCoats = max(1, coats);
+    coat = 1;
+    sideIndex = 0;
+    sideOrder[0] = 4; sideOrder[1] = 3; sideOrder[2] = 2; sideOrder[3] = 1;
+    resetSideDrying();
+    beginDryingJobs();
+    Serial.printf("PaintingState: %d coat(s), %d s flash-off per side\n", totalCoats, g_interCoatDelaySeconds);
+    beginCycleEstimate(totalCoats, (unsigned long)g_interCoatDelaySeconds * 1000);
+    beginPhaseJob();
+}
+
+void PaintingState::startSide(int side) {
+    Serial.printf("PaintingState: Starting Side %d painting (coat %d of %d)\n", side, coat, totalCoats);
+    sideStartMs = millis();
+    noteCycleSideStarted(side);
+    switch (side) {
+        case 4: paintSide4Pattern(); break; // This will transition to Side4State
+        case 3: paintSide3Pattern(); break;
+        case 2: paintSide2Pattern(); break;
+        case 1: paintSide1Pattern(); break;
+    }
+}
+
 void PaintingState::enter() {
     Serial.print("PaintingState: enter() called. CurrentStep BEFORE logic: ");
     Serial.println(currentStep); // Log its value *before* the if. Add specific name if possible later.
@@ -44,12 +74,15 @@ void PaintingState::enter() {
     // Check if we are in the special "Paint All Sides" transition
     if (stateMachine && stateMachine->isTransitioningToPaintAllSides()) {
         Serial.println("PaintingState: Detected 'Paint All Sides' transition. Starting with Side 4.");
-        currentStep = PS_START_SIDE4_PAINTING; // Start with Side 4
+        startJob(g_requestedCoats);
+        g_requestedCoats = 1; // Reset global for next time
+        currentStep = PS_START_NEXT_SIDE; // Start with Side 4
         stateMachine->clearTransitioningToPaintAllSidesFlag(); // Clear the flag as it has been handled
         stateMachine->setInPaintAllSidesMode(true); // Set persistent mode flag
     } else if (currentStep == PS_IDLE) {
         Serial.println("PaintingState: enter() - Normal entry. Starting with Side 4.");
-        currentStep = PS_START_SIDE4_PAINTING; // Start with Side 4
+        startJob(1);
+        currentStep = PS_START_NEXT_SIDE; // Start with Side 4
     } else {
         Serial.print("PaintingState: enter() - CurrentStep is not IDLE. Preserving currentStep: ");
         Serial.println(currentStep); // Log its value if preserved.
@@ -64,54 +97,56 @@ void PaintingState::update() {
     long xPos, yPos, zPos;
     
     switch (currentStep) {
-        case PS_START_SIDE4_PAINTING:
-            Serial.println("PaintingState: Starting Side 4 painting");
-            paintSide4Pattern(); // This will transition to Side4State
-            currentStep = PS_WAIT_FOR_SIDE4_COMPLETION;
-            break;
-            
-        case PS_WAIT_FOR_SIDE4_COMPLETION:
-            // Wait for Side4State to complete and return to PaintingState
-            // The Side4State will transition back to PaintingState when done
-            break;
-            
-        case PS_START_SIDE3_PAINTING:
-            Serial.println("PaintingState: Starting Side 3 painting");
-            paintSide3Pattern(); // This will transition to Side3State
-            currentStep = PS_WAIT_FOR_SIDE3_COMPLETION;
-            break;
-            
-        case PS_WAIT_FOR_SIDE3_COMPLETION:
-            // Wait for Side3State to complete and return to PaintingState
-            break;
-            
-        case PS_START_SIDE2_PAINTING:
-            Serial.println("PaintingState: Starting Side 2 painting");
-            paintSide2Pattern(); // This will transition to Side2State
-            currentStep = PS_WAIT_FOR_SIDE2_COMPLETION;
-            break;
-            
-        case PS_WAIT_FOR_SIDE2_COMPLETION:
-            // Wait for Side2State to complete and return to PaintingState
-            break;
-            
-        case PS_START_SIDE1_PAINTING:
-            Serial.println("PaintingState: Starting Side 1 painting");
-            paintSide1Pattern(); // This will transition to Side1State
-            currentStep = PS_WAIT_FOR_SIDE1_COMPLETION;
-            break;
-            
-        case PS_WAIT_FOR_SIDE1_COMPLETION:
-            // Wait for Side1State to complete and return to PaintingState
+        case PS_START_NEXT_SIDE:
+        {
+            int side = sideOrder[sideIndex];
+            unsigned long leftMs = sideDryingLeftMs(side, (unsigned long)g_interCoatDelaySeconds * 1000);
+            if (leftMs > 0) {
+                Serial.printf("PaintingState: Side %d still flashing off (%.1f s left)\n", side, leftMs / 1000.0f);
+                dryingStartMs = millis();
+                dryingJobsRun = false;
+                setPhaseBackground(PHASE_FLASH_OFF);
+                currentStep = PS_WAIT_FOR_SIDE_DRYING;
+                break;
+            }
+            startSide(side);
+            currentStep = PS_WAIT_FOR_SIDE_COMPLETION;
             break;
+        }
 
-        case PS_PERFORM_ALL_SIDES_PAINTING:
-            Serial.println("PaintingState: Starting all sides painting routine.");
-            paintAllSides(); // This is assumed to be a blocking call
-            Serial.println("PaintingState: All Sides Painting routine finished.");
-            currentStep = PS_MOVE_TO_POSITION_BEFORE_HOMING;
+        case PS_WAIT_FOR_SIDE_DRYING:
+        {
+            int side = sideOrder[sideIndex];
+            unsigned long leftMs = sideDryingLeftMs(side, (unsigned long)g_interCoatDelaySeconds * 1000);
+            //! Jobs get the gantry once per wait; they are only started if they fit in it
+            if (!dryingJobsRun) {
+                dryingJobsRun = true;
+                if (!runDryingJobs(millis(), leftMs)) {
+                    Serial.println("PaintingState: Drying job aborted. Requesting Homing State.");
+                    setPhaseBackground(PHASE_OTHER);
+                    currentStep = PS_REQUEST_HOMING;
+                    break;
+                }
+                leftMs = sideDryingLeftMs(side, (unsigned long)g_interCoatDelaySeconds * 1000);
+            }
+            if (checkForPauseCommand()) {
+                Serial.println("PaintingState: Aborted while waiting for flash-off. Requesting Homing State.");
+                setPhaseBackground(PHASE_OTHER);
+                currentStep = PS_REQUEST_HOMING;
+                break;
+            }
+            if (leftMs == 0) {
+                endDryingWindow(dryingStartMs);
+                setPhaseBackground(PHASE_OTHER);
+                currentStep = PS_START_NEXT_SIDE;
+            }
             break;
+        }
 
+        case PS_WAIT_FOR_SIDE_COMPLETION:
+            // Wait for the side state to complete and return to PaintingState
+            break;
+            
         case PS_MOVE_TO_POSITION_BEFORE_HOMING:
             Serial.println("PaintingState: Moving to position (1,1,0) before Homing.");
             // Convert inches to steps
@@ -126,9 +161,12 @@ void PaintingState::update() {
         
         case PS_REQUEST_HOMING:
             Serial.println("PaintingState: Sequence complete. Requesting Homing State.");
+            reportDryingUtilization();
+            endCycleEstimate(false); // No-op once the last side completed
             if (stateMachine) {
                 stateMachine->setInPaintAllSidesMode(false); // Clear Paint All Sides mode
                 if (stateMachine->getHomingState()) {
+                    requestVerifyHome(); // Job finished - a verify-home is enough
                     stateMachine->changeState(stateMachine->getHomingState());
                 } else {
                     Serial.println("ERROR: PaintingState - Cannot transition to HomingState.");
@@ -160,31 +198,30 @@ const char* PaintingState::getName() const {
 
 // New method to handle side completion callbacks
 void PaintingState::onSideCompleted() {
-    switch (currentStep) {
-        case PS_WAIT_FOR_SIDE4_COMPLETION:
-            Serial.println("PaintingState: Side 4 completed, starting Side 3");
-            currentStep = PS_START_SIDE3_PAINTING;
-            break;
-            
-        case PS_WAIT_FOR_SIDE3_COMPLETION:
-            Serial.println("PaintingState: Side 3 completed, starting Side 2");
-            currentStep = PS_START_SIDE2_PAINTING;
-            break;
-            
-        case PS_WAIT_FOR_SIDE2_COMPLETION:
-            Serial.println("PaintingState: Side 2 completed, starting Side 1");
-            currentStep = PS_START_SIDE1_PAINTING;
-            break;
-            
-        case PS_WAIT_FOR_SIDE1_COMPLETION:
-            Serial.println("PaintingState: Side 1 completed, moving to completion");
-            currentStep = PS_MOVE_TO_POSITION_BEFORE_HOMING;
-            break;
-            
-        default:
-            Serial.println("PaintingState: Unexpected side completion callback");
-            break;
+    if (currentStep != PS_WAIT_FOR_SIDE_COMPLETION) {
+        Serial.println("PaintingState: Unexpected side completion callback");
+        return;
+    }
+    int side = sideOrder[sideIndex];
+    recordSidePainted(side, sideStartMs, millis());
+    noteCycleSideDone(side);
+    Serial.printf("PaintingState: Side %d completed (coat %d of %d)\n", side, coat, totalCoats);
+
+    if (++sideIndex < 4) {
+        currentStep = PS_START_NEXT_SIDE;
+        return;
+    }
+    if (coat >= totalCoats) {
+        Serial.println("PaintingState: Last coat completed, moving to completion");
+        endCycleEstimate(true);
+        currentStep = PS_MOVE_TO_POSITION_BEFORE_HOMING;
+        return;
     }
+    coat++;
+    sideIndex = 0;
+    planCoatSideOrder(sideOrder, (unsigned long)g_interCoatDelaySeconds * 1000);
+    setCycleCoat(coat, sideOrder);
+    currentStep = PS_START_NEXT_SIDE;
 }
 
 
@@ -11,6 +11,7 @@
 // #include "hardware/Brush_Functions.h" // File does not exist
 #include "motors/Rotation_Motor.h" // Added for rotateToAngle
 #include "settings/painting.h"   // Added for SIDE4_ROTATION_ANGLE
+#include "system/PhaseStats.h"     // Cleaning phase timing
 
 // External variable for pressure pot state
 extern bool isPressurePot_ON;
@@ -41,6 +42,24 @@ const unsigned long SHORT_PRESSURE_POT_INIT_DELAY = 100;
 const unsigned long NORMAL_PAINT_GUN_ON_DELAY = 150;
 const unsigned long SHORT_PAINT_GUN_ON_DELAY = 75; // Half of normal
 
+void purgeGunAtCleaningStation(unsigned long gunOnMs) {
+    PhaseScope cleaning(PHASE_CLEANING);
+    // Move to clean station
+    long cleaningX = 0.8 * STEPS_PER_INCH_XYZ;
+    long cleaningY = 4.1* STEPS_PER_INCH_XYZ;
+    long cleaningZ = -3.0 * STEPS_PER_INCH_XYZ;
+    moveToXYZ(cleaningX, CLEANING_X_SPEED, cleaningY, CLEANING_Y_SPEED, cleaningZ, CLEANING_Z_SPEED);
+    
+    // Activate paint gun for specified duration
+    Serial.println("Activating paint gun...");
+    paintGun_ON();
+    delay(gunOnMs);
+    paintGun_OFF();
+    
+    // Retract the paint gun
+    moveToXYZ(cleaningX, CLEANING_X_SPEED, cleaningY, CLEANING_Y_SPEED, 0, CLEANING_Z_SPEED);
+}
+
 CleaningState::CleaningState() : 
     _isCleaning(false),
     _cleaningComplete(false),
@@ -75,6 +94,8 @@ void CleaningState::enter() {
         Serial.println("CleaningState: Not rotating, as not transitioning to Paint All Sides or stateMachine unavailable.");
     }
     
+    beginPhaseJob(); // No-op when cleaning is part of a running job
+
     // Reset cleaning state variables
     _isCleaning = true;
     _cleaningComplete = false;
@@ -94,23 +115,11 @@ void CleaningState::update() {
         PressurePot_ON();
         delay(pressurePotInitDelay); 
 
-        //! Step 3: Move to clean station
-        long cleaningX = 0.8 * STEPS_PER_INCH_XYZ;
-        long cleaningY = 4.1* STEPS_PER_INCH_XYZ;
-        long cleaningZ = -3.0 * STEPS_PER_INCH_XYZ;
-        moveToXYZ(cleaningX, CLEANING_X_SPEED, cleaningY, CLEANING_Y_SPEED, cleaningZ, CLEANING_Z_SPEED);
-        
-        //! Step 4: Activate paint gun for specified duration
-        Serial.println("Activating paint gun...");
-        paintGun_ON();
-        delay(paintGunOnDelay);
-        paintGun_OFF();
+        //! Steps 3-4: Purge the gun at the clean station
+        purgeGunAtCleaningStation(paintGunOnDelay);
         
         //! Step 5: Return to home position
         Serial.println("Returning to home position...");
-        // Retract the paint gun
-        moveToXYZ(cleaningX, CLEANING_X_SPEED, cleaningY, CLEANING_Y_SPEED, 0, CLEANING_Z_SPEED);
-        // Move back to home position
         moveToXYZ(0, CLEANING_X_SPEED, 0, CLEANING_Y_SPEED, 0, CLEANING_Z_SPEED);
         
         //! Step 6: Complete cleaning cycle
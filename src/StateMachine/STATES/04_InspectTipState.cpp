@@ -42,11 +42,11 @@ void InspectTipState::update() {
     switch (currentStep) {
         case ITS_MOVING_TO_INSPECT_POSITION:
         {
-            Serial.println("InspectTipState: Moving to inspect position (10, 0.5, 0)");
+            Serial.printf("InspectTipState: Moving to inspect position (%.1f, %.1f, 0)\n", TIP_INSPECT_X_INCH, TIP_INSPECT_Y_INCH);
             
             // Convert inches to steps
-            long xPos = (long)(10.0 * STEPS_PER_INCH_XYZ);
-            long yPos = (long)(0.5 * STEPS_PER_INCH_XYZ);
+            long xPos = (long)(TIP_INSPECT_X_INCH * STEPS_PER_INCH_XYZ);
+            long yPos = (long)(TIP_INSPECT_Y_INCH * STEPS_PER_INCH_XYZ);
             long zPos = 0; // Stay at current Z or go to 0
             
             // Move to inspect position
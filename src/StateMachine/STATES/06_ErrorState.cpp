@@ -2,6 +2,10 @@
 #include <Arduino.h>
 #include "system/StateMachine.h"
 #include "system/GlobalState.h"
+#include "motors/StopAll.h"
+#include "motors/LimitSwitches.h"
+#include "motors/Homing.h"
+#include "hardware/paintGun_Functions.h"
 
 // Reference to the global state machine instance
 extern StateMachine* stateMachine;
@@ -21,7 +25,8 @@ void ErrorState::enter() {
     Serial.println("!!! ENTERING ERROR STATE !!!");
     
     // Stop all motors immediately for safety
-    // stopAllMotors(); // Implement this function to stop all stepper and servo motors
+    stopAllAxes();
+    paintGun_OFF();
     
     // Turn off all pneumatic systems for safety
     // turnOffAllPneumatics(); // Implement this function to safely disable pneumatics
@@ -37,8 +42,20 @@ void ErrorState::enter() {
     // Clear any active operations
     isPaused = false;
     isActivePainting = false;
+
+    //! A stop press that led here (e.g. the stop input during homing) must
+    //! not re-home straight away - recovery takes a fresh HOME
+    extern volatile bool physicalHomeButtonPressed;
+    physicalHomeButtonPressed = false;
     
-    Serial.println("ERROR: To recover, resolve the issue and restart the system");
+    if (isLimitFaultLatched()) {
+        Serial.printf("ERROR: Limit switch fault on %s\n", limitFaultMaskToString(getLimitFaultMask()).c_str());
+        Serial.println("ERROR: To recover, clear the obstruction and HOME (dashboard or Modifier Right + Action Left)");
+    } else if (!isHomingReferenceValid()) {
+        Serial.println("ERROR: Axes are not homed - moves are refused until HOME succeeds");
+    } else {
+        Serial.println("ERROR: To recover, resolve the issue and restart the system");
+    }
 }
 
 void ErrorState::update() {
@@ -62,12 +79,13 @@ void ErrorState::update() {
         lastErrorMessage = millis();
     }
     
-    // Check for reset conditions (if implemented)
-    // For example, a specific button combination or web command
-    // if (checkForErrorReset()) {
-    //     Serial.println("ERROR: Reset condition detected, returning to IDLE");
-    //     stateMachine->changeState(stateMachine->getIdleState());
-    // }
+    // Physical force-home is the panel's way out (the dashboard HOME command
+    // changes state directly). Homing clears a latched limit fault.
+    extern volatile bool physicalHomeButtonPressed;
+    if (physicalHomeButtonPressed) {
+        Serial.println("ERROR: Physical HOME pressed - homing to recover");
+        stateMachine->changeState(stateMachine->getHomingState());
+    }
 }
 
 void ErrorState::exit() {
@@ -60,6 +60,10 @@
 // --- Cycle Sensors ---
 #define PNP_CYCLE_SENSOR_PIN 21    // Pick and place cycle sensor (Active LOW - Input Pullup)
 
+// --- Pneumatic Feedback (optional, -1 = not fitted) ---
+#define PICK_CYLINDER_DOWN_SENSOR_PIN -1 // Reed switch at full extension (Active LOW - Input Pullup)
+#define VACUUM_SWITCH_PIN -1             // Vacuum switch, LOW while the cup holds vacuum (Input Pullup)
+
 // ==========================================================================
 //                            CONTROL PANEL PINS
 // ==========================================================================
@@ -77,6 +81,11 @@
 #define ACTION_BUTTON_CENTER 7     // Center action button
 #define ACTION_BUTTON_RIGHT 16     // Right action button
 
+// --- Stop-All Input (hardware interrupt) ---
+// Physical force-home: Right Modifier held + Left Action pressed
+#define STOP_ALL_INPUT_PIN ACTION_BUTTON_LEFT
+#define STOP_ALL_QUALIFIER_PIN MODIFIER_BUTTON_RIGHT
+
 // ==========================================================================
 //                            COMMUNICATION PINS
 // ==========================================================================
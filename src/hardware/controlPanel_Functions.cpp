@@ -337,8 +337,16 @@ void startCleaningCycle() {
  */
 void paintAllSidesTwice() {
     Serial.println("SINGLE ACTION: Right Button - Paint All Sides Twice");
+    paintAllSidesCoats(2);
+}
+
+/**
+ * @brief Paint all sides with the given number of coats
+ * Transitions to painting state in Paint All Sides mode
+ */
+void paintAllSidesCoats(int coats) {
     if (stateMachine) {
-        g_requestedCoats = 2; // Set to 2x coats
+        g_requestedCoats = coats;
         stateMachine->setTransitioningToPaintAllSides(true);
         stateMachine->changeState(stateMachine->getPaintingState());
     } else {
@@ -0,0 +1,202 @@
+#include "storage/TrayDefinitions.h"
+#include <Arduino.h>
+#include "utils/settings.h"
+#include "storage/Persistence.h"
+#include "motors/TrayLayout.h"
+
+// NVS keys get the slot index inserted ("tr0r" = slot 0 rows)
+#define TRAY_KEY_PREFIX "tr"
+#define TRAY_ACTIVE_SLOT_KEY "trActive"
+
+static const TrayDefinition kDefaultTray = {
+    GRID_ROWS, GRID_COLS, (GRID_ORIGIN_X), GRID_ORIGIN_Y, GRID_PITCH_X, GRID_PITCH_Y,
+    SQUARE_WIDTH, SQUARE_WIDTH, 0
+};
+
+static TrayDefinition g_trays[TRAY_DEFINITION_SLOTS];
+static int g_activeTraySlot = 0;
+
+// Placement table for the active tray
+static long g_placeX[TRAY_MAX_POSITIONS];
+static long g_placeY[TRAY_MAX_POSITIONS];
+
+static String trayKey(int slot, const char* field) {
+    return String(TRAY_KEY_PREFIX) + slot + field;
+}
+
+static uint32_t allPositionsMask(int count) {
+    return (count >= 32) ? 0xFFFFFFFFUL : ((1UL << count) - 1);
+}
+
+static bool validSlot(int slot) {
+    return slot >= 0 && slot < TRAY_DEFINITION_SLOTS;
+}
+
+static void positionInches(const TrayDefinition& tray, int index, float& x, float& y) {
+    x = tray.originX - (index % tray.cols) * tray.pitchX;
+    y = tray.originY - (index / tray.cols) * tray.pitchY;
+}
+
+static void buildPlacementTable() {
+    const TrayDefinition& tray = g_trays[g_activeTraySlot];
+    for (int index = 0; index < tray.rows * tray.cols; index++) {
+        float x, y;
+        positionInches(tray, index, x, y);
+        g_placeX[index] = (long)(x * STEPS_PER_INCH_XYZ);
+        g_placeY[index] = (long)(y * STEPS_PER_INCH_XYZ);
+    }
+    Serial.printf("Tray %d active: %d x %d, %d positions\n", g_activeTraySlot, tray.rows, tray.cols,
+                  tray.rows * tray.cols);
+}
+
+//* ************************************************************************
+//* *************************** DEFINITIONS ********************************
+//* ************************************************************************
+
+static bool validateTray(const TrayDefinition& tray) {
+    if (tray.rows < 1 || tray.cols < 1 || tray.rows * tray.cols > TRAY_MAX_POSITIONS) {
+        Serial.printf("Tray rejected: %d x %d must be 1..%d positions\n", tray.rows, tray.cols, TRAY_MAX_POSITIONS);
+        return false;
+    }
+    if (tray.pitchX < 0.0f || tray.pitchY < 0.0f || tray.partWidth <= 0.0f || tray.partLength <= 0.0f) {
+        Serial.println("Tray rejected: pitch must be >= 0 and part footprint > 0");
+        return false;
+    }
+    //! Every placement target must be reachable
+    float lastX = tray.originX - (tray.cols - 1) * tray.pitchX;
+    float lastY = tray.originY - (tray.rows - 1) * tray.pitchY;
+    if (lastX < 0.0f || lastY < 0.0f || tray.originX > X_MAX_TRAVEL_POS_INCH || tray.originY > Y_MAX_TRAVEL_POS_INCH) {
+        Serial.printf("Tray rejected: positions span X %.2f-%.2f, Y %.2f-%.2f in, outside travel\n",
+                      lastX, tray.originX, lastY, tray.originY);
+        return false;
+    }
+    return true;
+}
+
+bool setTrayDefinition(int slot, const TrayDefinition& tray) {
+    if (!validSlot(slot) || !validateTray(tray)) {
+        return false;
+    }
+    TrayDefinition saved = tray;
+    saved.skipMask &= allPositionsMask(saved.rows * saved.cols);
+    g_trays[slot] = saved;
+
+    persistence.beginTransaction(false);
+    persistence.saveInt(trayKey(slot, "r").c_str(), saved.rows);
+    persistence.saveInt(trayKey(slot, "c").c_str(), saved.cols);
+    persistence.saveFloat(trayKey(slot, "ox").c_str(), saved.originX);
+    persistence.saveFloat(trayKey(slot, "oy").c_str(), saved.originY);
+    persistence.saveFloat(trayKey(slot, "px").c_str(), saved.pitchX);
+    persistence.saveFloat(trayKey(slot, "py").c_str(), saved.pitchY);
+    persistence.saveFloat(trayKey(slot, "w").c_str(), saved.partWidth);
+    persistence.saveFloat(trayKey(slot, "l").c_str(), saved.partLength);
+    persistence.saveInt(trayKey(slot, "s").c_str(), (int)saved.skipMask);
+    persistence.endTransaction();
+    Serial.printf("Tray %d saved: %s\n", slot, describeTrayDefinition(slot).c_str());
+
+    if (slot == g_activeTraySlot) {
+        buildPlacementTable();
+        setTrayOccupancy(getTrayOccupancy()); // Re-mask to the new layout
+    }
+    return true;
+}
+
+const TrayDefinition& getTrayDefinition(int slot) {
+    return g_trays[validSlot(slot) ? slot : g_activeTraySlot];
+}
+
+bool selectTraySlot(int slot) {
+    if (!validSlot(slot)) {
+        return false;
+    }
+    g_activeTraySlot = slot;
+    persistence.beginTransaction(false);
+    persistence.saveInt(TRAY_ACTIVE_SLOT_KEY, slot);
+    persistence.endTransaction();
+    buildPlacementTable();
+    setTrayOccupancy(0xFFFFFFFFUL); // Full tray of the new type
+    return true;
+}
+
+int getActiveTraySlot() {
+    return g_activeTraySlot;
+}
+
+const TrayDefinition& getActiveTray() {
+    return g_trays[g_activeTraySlot];
+}
+
+//* ************************************************************************
+//* **************************** POSITIONS *********************************
+//* ************************************************************************
+
+int getTrayPositionCount() {
+    return g_trays[g_activeTraySlot].rows * g_trays[g_activeTraySlot].cols;
+}
+
+bool isTrayPositionSkipped(int position) {
+    if (position < 1 || position > getTrayPositionCount()) {
+        return true;
+    }
+    return (g_trays[g_activeTraySlot].skipMask & (1UL << (position - 1))) != 0;
+}
+
+uint32_t getTrayFillableMask() {
+    return allPositionsMask(getTrayPositionCount()) & ~g_trays[g_activeTraySlot].skipMask;
+}
+
+bool getTrayPlacementSteps(int position, long& xSteps, long& ySteps) {
+    if (position < 1 || position > getTrayPositionCount()) {
+        return false;
+    }
+    xSteps = g_placeX[position - 1];
+    ySteps = g_placeY[position - 1];
+    return true;
+}
+
+bool getTrayPositionInches(int position, float& x, float& y) {
+    if (position < 1 || position > getTrayPositionCount()) {
+        return false;
+    }
+    positionInches(g_trays[g_activeTraySlot], position - 1, x, y);
+    return true;
+}
+
+String describeTrayDefinition(int slot) {
+    const TrayDefinition& tray = getTrayDefinition(slot);
+    String text;
+    text += slot;
+    text += "," + String(tray.rows) + "," + String(tray.cols);
+    text += "," + String(tray.originX, 2) + "," + String(tray.originY, 2);
+    text += "," + String(tray.pitchX, 2) + "," + String(tray.pitchY, 2);
+    text += "," + String(tray.partWidth, 2) + "," + String(tray.partLength, 2);
+    text += "," + String(tray.skipMask);
+    return text;
+}
+
+void loadTrayDefinitionsFromNVS() {
+    persistence.beginTransaction(true);
+    for (int slot = 0; slot < TRAY_DEFINITION_SLOTS; slot++) {
+        TrayDefinition tray;
+        tray.rows = persistence.loadInt(trayKey(slot, "r").c_str(), kDefaultTray.rows);
+        tray.cols = persistence.loadInt(trayKey(slot, "c").c_str(), kDefaultTray.cols);
+        tray.originX = persistence.loadFloat(trayKey(slot, "ox").c_str(), kDefaultTray.originX);
+        tray.originY = persistence.loadFloat(trayKey(slot, "oy").c_str(), kDefaultTray.originY);
+        tray.pitchX = persistence.loadFloat(trayKey(slot, "px").c_str(), kDefaultTray.pitchX);
+        tray.pitchY = persistence.loadFloat(trayKey(slot, "py").c_str(), kDefaultTray.pitchY);
+        tray.partWidth = persistence.loadFloat(trayKey(slot, "w").c_str(), kDefaultTray.partWidth);
+        tray.partLength = persistence.loadFloat(trayKey(slot, "l").c_str(), kDefaultTray.partLength);
+        tray.skipMask = (uint32_t)persistence.loadInt(trayKey(slot, "s").c_str(), (int)kDefaultTray.skipMask);
+        if (!validateTray(tray)) {
+            Serial.printf("Tray %d in NVS is invalid - using the default layout\n", slot);
+            tray = kDefaultTray;
+        }
+        g_trays[slot] = tray;
+    }
+    g_activeTraySlot = persistence.loadInt(TRAY_ACTIVE_SLOT_KEY, 0);
+    persistence.endTransaction();
+    if (!validSlot(g_activeTraySlot)) {
+        g_activeTraySlot = 0;
+    }
+    buildPlacementTable();
+}
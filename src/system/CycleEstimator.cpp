@@ -0,0 +1,342 @@
+#include "system/CycleEstimator.h"
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+#include "system/StateMachine.h"
+#include "motors/Toolpath.h"
+#include "motors/PaintSweep.h"
+#include "motors/TrayLayout.h"
+#include "settings/motion.h"
+#include "settings/painting.h"
+#include "storage/Persistence.h"
+
+// NVS key per side, with the side number appended ("etaScl4")
+#define CYCLE_SCALE_KEY "etaScl"
+#define CYCLE_MAX_SIDE_SWEEPS (TOOLPATH_MAX_SWEEP_COUNT + 2) // Main-face sweeps plus the final X sweep
+
+extern StateMachine* stateMachine;
+extern WebSocketsServer webSocket;
+
+struct CycleSideModel {
+    float seconds;                                  // Compiled toolpath time
+    int sweepCount;
+    float sweepDoneSeconds[CYCLE_MAX_SIDE_SWEEPS];  // Model time at the end of each painted sweep
+};
+
+static CycleSideModel g_sideModel[PAINT_SIDE_COUNT + 1];
+static float g_sideScale[PAINT_SIDE_COUNT + 1] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f }; // Measured / modelled
+
+// Tray setup the model was compiled for; sides painted with a different one are not learned from
+static bool g_modelTrayWindows = false;
+static uint32_t g_modelTrayOccupancy = 0;
+
+static bool g_cycleActive = false;
+static int g_totalCoats = 1;
+static int g_coat = 1;
+static int g_coatOrder[PAINT_SIDE_COUNT] = { 4, 3, 2, 1 };
+static int g_sidesDoneInCoat = 0;
+static unsigned long g_flashOffMs = 0;
+static unsigned long g_jobStartMs = 0;
+static unsigned long g_coatStartMs = 0;
+static unsigned long g_lastBroadcastMs = 0;
+
+static int g_activeSide = 0;                        // 0 between sides
+static unsigned long g_sideStartMs = 0;
+static int g_sweepsDone = 0;
+static unsigned long g_lastSweepDoneMs = 0;
+
+struct CycleEta {
+    float sideLeft;     // Seconds until the current (or next) side is done
+    float coatLeft;
+    float jobLeft;
+};
+
+//* ************************************************************************
+//* ******************************* MODEL **********************************
+//* ************************************************************************
+
+// Time of one painted sweep as runPaintSweep() will run it: with tray gun
+// windows on, the sweep is trimmed to the occupied parts (plus a travel to
+// the trimmed start), or skipped when it crosses none. The travel that
+// follows is still modelled from the untrimmed end.
+static float trayTrimmedSweepSeconds(const ToolpathSegment& segment) {
+    bool alongX = segment.x1 != segment.x0;
+    PaintSweep sweep;
+    sweep.axis = alongX ? SWEEP_AXIS_X : SWEEP_AXIS_Y;
+    sweep.startPos = alongX ? segment.x0 : segment.y0;
+    sweep.targetPos = alongX ? segment.x1 : segment.y1;
+    sweep.speedHz = segment.speedHz;
+    sweep.gunOnOffset = segment.gunOnOffset;
+    sweep.gunOffOffset = segment.gunOffOffset;
+    sweep.windowCount = 1;
+    sweep.windows[0].onOffset = segment.gunOnOffset;
+    sweep.windows[0].offOffset = segment.gunOffOffset;
+    sweep.tag = "Cycle estimate";
+
+    PaintSweep trimmed = withTrayGunWindows(sweep, segment.angle1);
+    if (trimmed.windowCount == 0) {
+        return 0.0f; // Skipped
+    }
+    if (trimmed.startPos == sweep.startPos && trimmed.targetPos == sweep.targetPos) {
+        return segment.seconds;
+    }
+    float accel = alongX ? (float)DEFAULT_X_ACCEL : (float)DEFAULT_Y_ACCEL;
+    float travelHz = alongX ? (float)DEFAULT_X_SPEED : (float)DEFAULT_Y_SPEED;
+    return estimateAxisMoveSeconds(labs(trimmed.startPos - sweep.startPos), travelHz, accel) +
+           estimateAxisMoveSeconds(labs(trimmed.targetPos - trimmed.startPos), (float)segment.speedHz, accel);
+}
+
+static void compileSideModels() {
+    ToolpathSummary summary;
+    int count;
+    const ToolpathSegment* segments = compileSettingsToolpath(TOOLPATH_ALL_SIDES, count, summary);
+    g_modelTrayWindows = areTrayGunWindowsEnabled();
+    g_modelTrayOccupancy = getTrayOccupancy();
+
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        g_sideModel[side].sweepCount = 0;
+    }
+    float sideClock[PAINT_SIDE_COUNT + 1] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < count; i++) {
+        const ToolpathSegment& segment = segments[i];
+        if (segment.side < 1 || segment.side > PAINT_SIDE_COUNT) {
+            continue;
+        }
+        //! Skipped sweeps still count: runPaintSweep() reports them done
+        bool paint = segment.type == TOOLPATH_PAINT;
+        sideClock[segment.side] += (paint && g_modelTrayWindows) ? trayTrimmedSweepSeconds(segment) : segment.seconds;
+        CycleSideModel& model = g_sideModel[segment.side];
+        if (paint && model.sweepCount < CYCLE_MAX_SIDE_SWEEPS) {
+            model.sweepDoneSeconds[model.sweepCount++] = sideClock[segment.side];
+        }
+    }
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        g_sideModel[side].seconds = sideClock[side];
+    }
+    if (summary.truncated) {
+        Serial.println("Cycle estimate: toolpath truncated - ETAs will run short");
+    }
+}
+
+// The tray windows or occupancy changed since the model was compiled
+static bool trayChangedSinceModel() {
+    return areTrayGunWindowsEnabled() != g_modelTrayWindows ||
+           (g_modelTrayWindows && getTrayOccupancy() != g_modelTrayOccupancy);
+}
+
+static float scaledSideSeconds(int side) {
+    return g_sideModel[side].seconds * g_sideScale[side];
+}
+
+// Remaining time of the side being painted; finished sweeps replace the learned scale with a live one
+static float activeSideLeftSeconds(unsigned long nowMs) {
+    const CycleSideModel& model = g_sideModel[g_activeSide];
+    float elapsed = (nowMs - g_sideStartMs) / 1000.0f;
+    float predicted = scaledSideSeconds(g_activeSide);
+    if (g_sweepsDone > 0 && g_sweepsDone <= model.sweepCount) {
+        float modelDone = model.sweepDoneSeconds[g_sweepsDone - 1];
+        float measuredDone = (g_lastSweepDoneMs - g_sideStartMs) / 1000.0f;
+        if (modelDone > 0.0f) {
+            float liveScale = constrain(measuredDone / modelDone, CYCLE_SCALE_MIN, CYCLE_SCALE_MAX);
+            predicted = measuredDone + (model.seconds - modelDone) * liveScale;
+        }
+    }
+    return max(0.0f, predicted - elapsed);
+}
+
+//! Replays the rest of the job the way PaintingState runs it: each side waits
+//! for its own flash-off, later coats reuse the current side order
+static void computeEta(unsigned long nowMs, CycleEta& eta) {
+    float flashOff = g_flashOffMs / 1000.0f;
+    float readyAt[PAINT_SIDE_COUNT + 1];
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        readyAt[side] = sideDryingLeftMs(side, g_flashOffMs) / 1000.0f;
+    }
+
+    float clock = 0.0f;
+    int index = g_sidesDoneInCoat;
+    eta.sideLeft = -1.0f;
+    if (g_activeSide != 0) {
+        clock = activeSideLeftSeconds(nowMs);
+        readyAt[g_activeSide] = clock + flashOff;
+        eta.sideLeft = clock;
+        index++;
+    }
+    eta.coatLeft = clock;
+    for (int coat = g_coat; coat <= g_totalCoats; coat++) {
+        for (; index < PAINT_SIDE_COUNT; index++) {
+            int side = g_coatOrder[index];
+            clock = max(clock, readyAt[side]) + scaledSideSeconds(side);
+            readyAt[side] = clock + flashOff;
+            if (eta.sideLeft < 0.0f) {
+                eta.sideLeft = clock;
+            }
+        }
+        if (coat == g_coat) {
+            eta.coatLeft = clock;
+        }
+        index = 0;
+    }
+    eta.jobLeft = clock;
+    if (eta.sideLeft < 0.0f) {
+        eta.sideLeft = 0.0f;
+    }
+}
+
+static int percentDone(unsigned long elapsedMs, float leftSeconds) {
+    float elapsed = elapsedMs / 1000.0f;
+    if (elapsed + leftSeconds <= 0.0f) {
+        return 0;
+    }
+    // 100 only once tracking says it is done
+    return min(99, (int)(100.0f * elapsed / (elapsed + leftSeconds)));
+}
+
+//* ************************************************************************
+//* ***************************** BROADCAST ********************************
+//* ************************************************************************
+
+static void broadcastProgress() {
+    unsigned long nowMs = millis();
+    CycleEta eta;
+    computeEta(nowMs, eta);
+    g_lastBroadcastMs = nowMs;
+
+    int side = g_activeSide != 0 ? g_activeSide : g_coatOrder[min(g_sidesDoneInCoat, PAINT_SIDE_COUNT - 1)];
+    char buffer[192];
+    snprintf(buffer, sizeof(buffer),
+             "PROGRESS:side=%d,coat=%d/%d,phase=%s,sidePct=%d,sideEta=%.1f,coatPct=%d,coatEta=%.1f,jobPct=%d,jobEta=%.1f",
+             side, g_coat, g_totalCoats, g_activeSide != 0 ? "painting" : "drying",
+             g_activeSide != 0 ? percentDone(nowMs - g_sideStartMs, eta.sideLeft) : 0, eta.sideLeft,
+             percentDone(nowMs - g_coatStartMs, eta.coatLeft), eta.coatLeft,
+             percentDone(nowMs - g_jobStartMs, eta.jobLeft), eta.jobLeft);
+    String message = buffer;
+    webSocket.broadcastTXT(message);
+}
+
+//* ************************************************************************
+//* ****************************** TRACKING ********************************
+//* ************************************************************************
+
+void beginCycleEstimate(int coats, unsigned long flashOffMs) {
+    compileSideModels();
+    g_cycleActive = true;
+    g_totalCoats = max(1, coats);
+    g_flashOffMs = flashOffMs;
+    g_jobStartMs = millis();
+    g_activeSide = 0;
+
+    static const int kDefaultOrder[PAINT_SIDE_COUNT] = { 4, 3, 2, 1 };
+    setCycleCoat(1, kDefaultOrder);
+
+    CycleEta eta;
+    computeEta(g_jobStartMs, eta);
+    float modelSeconds = 0.0f;
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        modelSeconds += g_sideModel[side].seconds;
+    }
+    Serial.printf("Cycle estimate: %d coat(s), predicted %.1f s (toolpath %.1f s per coat, scales %.2f/%.2f/%.2f/%.2f)\n",
+                  g_totalCoats, eta.jobLeft, modelSeconds,
+                  g_sideScale[1], g_sideScale[2], g_sideScale[3], g_sideScale[4]);
+    broadcastProgress();
+}
+
+void setCycleCoat(int coat, const int order[PAINT_SIDE_COUNT]) {
+    g_coat = coat;
+    g_sidesDoneInCoat = 0;
+    g_coatStartMs = millis();
+    for (int i = 0; i < PAINT_SIDE_COUNT; i++) {
+        g_coatOrder[i] = order[i];
+    }
+}
+
+void noteCycleSideStarted(int side) {
+    if (!g_cycleActive || side < 1 || side > PAINT_SIDE_COUNT) {
+        return;
+    }
+    g_activeSide = side;
+    g_sideStartMs = millis();
+    g_sweepsDone = 0;
+    broadcastProgress();
+}
+
+void noteCycleSweepDone() {
+    if (!g_cycleActive || g_activeSide == 0) {
+        return;
+    }
+    g_sweepsDone++;
+    g_lastSweepDoneMs = millis();
+    broadcastProgress();
+}
+
+void noteCycleSideDone(int side) {
+    if (!g_cycleActive || side != g_activeSide) {
+        return;
+    }
+    float measured = (millis() - g_sideStartMs) / 1000.0f;
+    float model = g_sideModel[side].seconds;
+    if (trayChangedSinceModel()) {
+        Serial.printf("Cycle estimate: Side %d not learned - tray setup changed since the job started\n", side);
+    } else if (model > 0.0f) {
+        float ratio = constrain(measured / model, CYCLE_SCALE_MIN, CYCLE_SCALE_MAX);
+        Serial.printf("Cycle estimate: Side %d took %.1f s, predicted %.1f s (toolpath %.1f s x%.2f)\n",
+                      side, measured, scaledSideSeconds(side), model, g_sideScale[side]);
+        g_sideScale[side] += CYCLE_ESTIMATE_LEARN_RATE * (ratio - g_sideScale[side]);
+    }
+    if (g_sweepsDone != g_sideModel[side].sweepCount) {
+        Serial.printf("Cycle estimate: Side %d ran %d sweep(s), toolpath has %d\n",
+                      side, g_sweepsDone, g_sideModel[side].sweepCount);
+    }
+    g_activeSide = 0;
+    g_sidesDoneInCoat++;
+    broadcastProgress();
+}
+
+void endCycleEstimate(bool completed) {
+    if (!g_cycleActive) {
+        return;
+    }
+    g_cycleActive = false;
+    g_activeSide = 0;
+    unsigned long jobMs = millis() - g_jobStartMs;
+    if (!completed) {
+        Serial.printf("Cycle estimate: job stopped after %.1f s\n", jobMs / 1000.0f);
+        webSocket.broadcastTXT("PROGRESS:stopped");
+        return;
+    }
+
+    Serial.printf("Cycle estimate: job done in %.1f s\n", jobMs / 1000.0f);
+    persistence.beginTransaction(false);
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        String key = String(CYCLE_SCALE_KEY) + side;
+        persistence.saveFloat(key.c_str(), g_sideScale[side]);
+    }
+    persistence.endTransaction();
+    webSocket.broadcastTXT("PROGRESS:done");
+}
+
+void serviceCycleEstimate() {
+    if (!g_cycleActive || !stateMachine) {
+        return;
+    }
+    //? Homing, Idle or Error before PaintingState reported the last side: the job was stopped
+    State* current = stateMachine->getCurrentState();
+    if (current == stateMachine->getHomingState() || current == stateMachine->getIdleState() ||
+        current == stateMachine->getErrorState()) {
+        endCycleEstimate(false);
+        return;
+    }
+    if (millis() - g_lastBroadcastMs >= PROGRESS_BROADCAST_INTERVAL_MS) {
+        broadcastProgress();
+    }
+}
+
+void loadCycleEstimatorFromNVS() {
+    persistence.beginTransaction(true);
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        String key = String(CYCLE_SCALE_KEY) + side;
+        g_sideScale[side] = constrain(persistence.loadFloat(key.c_str(), 1.0f), CYCLE_SCALE_MIN, CYCLE_SCALE_MAX);
+    }
+    persistence.endTransaction();
+    Serial.printf("Cycle estimate scales loaded: %.2f/%.2f/%.2f/%.2f\n",
+                  g_sideScale[1], g_sideScale[2], g_sideScale[3], g_sideScale[4]);
+}
@@ -0,0 +1,264 @@
+#include "system/DryingScheduler.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <FastAccelStepper.h>
+#include "utils/settings.h"
+#include "motors/XYZ_Movements.h"
+#include "motors/ServoMotor.h"
+#include "motors/Homing.h"
+#include "motors/LimitSwitches.h"
+#include "states/CleaningState.h"
+#include "storage/Persistence.h"
+#include "web/Web_Dashboard_Commands.h" // For checkForPauseCommand
+
+#define DRYING_JOBS_KEY "dryJobs"
+
+extern ServoMotor myServo;
+extern FastAccelStepperEngine engine;
+extern FastAccelStepper *stepperX;
+extern FastAccelStepper *stepperY_Left;
+extern FastAccelStepper *stepperY_Right;
+extern FastAccelStepper *stepperZ;
+
+struct DryingJobInfo {
+    const char* name;
+    bool oncePerJob;
+    bool (*run)();
+    unsigned long estimateMs;   // Last measured time, or the configured first-run estimate
+    bool doneThisJob;
+    unsigned long totalMs;      // Since beginDryingJobs()
+    int runs;
+};
+
+static bool runCleanJob();
+static bool runTipInspectJob();
+static bool runPreHomeJob();
+
+static DryingJobInfo g_dryingJobs[DRYING_JOB_COUNT] = {
+    { "clean",       false, runCleanJob,      DRYING_CLEAN_ESTIMATE_MS,       false, 0, 0 },
+    { "tip inspect", true,  runTipInspectJob, DRYING_TIP_INSPECT_ESTIMATE_MS, false, 0, 0 },
+    { "pre-home",    true,  runPreHomeJob,    DRYING_PRE_HOME_ESTIMATE_MS,    false, 0, 0 },
+};
+
+static int g_dryingJobMask = DEFAULT_DRYING_JOBS;
+static unsigned long g_windowBusyMs = 0;
+static unsigned long g_totalWindowMs = 0;
+static unsigned long g_totalBusyMs = 0;
+static int g_windowCount = 0;
+
+static bool g_sidePainted[PAINT_SIDE_COUNT + 1];
+static unsigned long g_sideDoneMs[PAINT_SIDE_COUNT + 1];
+static unsigned long g_sideDurationMs[PAINT_SIDE_COUNT + 1];
+
+//* ************************************************************************
+//* ***************************** SETTINGS *********************************
+//* ************************************************************************
+
+void setDryingJobMask(int mask) {
+    g_dryingJobMask = mask & ((1 << DRYING_JOB_COUNT) - 1);
+    persistence.beginTransaction(false);
+    persistence.saveInt(DRYING_JOBS_KEY, g_dryingJobMask);
+    persistence.endTransaction();
+    Serial.printf("Drying jobs set: mask %d\n", g_dryingJobMask);
+}
+
+int getDryingJobMask() {
+    return g_dryingJobMask;
+}
+
+void loadDryingJobsFromNVS() {
+    persistence.beginTransaction(true);
+    g_dryingJobMask = persistence.loadInt(DRYING_JOBS_KEY, DEFAULT_DRYING_JOBS) & ((1 << DRYING_JOB_COUNT) - 1);
+    persistence.endTransaction();
+    Serial.printf("Drying jobs loaded: mask %d\n", g_dryingJobMask);
+}
+
+//* ************************************************************************
+//* ******************************** JOBS **********************************
+//* ************************************************************************
+
+static bool runCleanJob() {
+    myServo.setAngle(35); // Cleaning angle, as in CleaningState
+    purgeGunAtCleaningStation(DRYING_CLEAN_GUN_ON_MS);
+    myServo.setAngle(180); // Back to the inter-coat angle
+    return !isLimitFaultLatched();
+}
+
+static bool runTipInspectJob() {
+    moveToXYZ((long)(TIP_INSPECT_X_INCH * STEPS_PER_INCH_XYZ), DEFAULT_X_SPEED,
+              (long)(TIP_INSPECT_Y_INCH * STEPS_PER_INCH_XYZ), DEFAULT_Y_SPEED, 0, DEFAULT_Z_SPEED);
+    unsigned long dwellStartMs = millis();
+    while (millis() - dwellStartMs < DRYING_TIP_INSPECT_DWELL_MS) {
+        if (checkForPauseCommand()) {
+            return false;
+        }
+        delay(10);
+    }
+    return !isLimitFaultLatched();
+}
+
+static bool runPreHomeJob() {
+    //! Verify-home drives onto the switches on purpose, as in HomingState
+    setLimitMonitoringEnabled(false);
+    Homing homing(engine, stepperX, stepperY_Left, stepperY_Right, stepperZ);
+    bool homed = homing.verifyHome();
+    setLimitMonitoringEnabled(true);
+    return homed;
+}
+
+//* ************************************************************************
+//* ***************************** SCHEDULER ********************************
+//* ************************************************************************
+
+void beginDryingJobs() {
+    for (int i = 0; i < DRYING_JOB_COUNT; i++) {
+        g_dryingJobs[i].doneThisJob = false;
+        g_dryingJobs[i].totalMs = 0;
+        g_dryingJobs[i].runs = 0;
+    }
+    g_totalWindowMs = 0;
+    g_totalBusyMs = 0;
+    g_windowCount = 0;
+}
+
+bool runDryingJobs(unsigned long dryingStartMs, unsigned long dryingMs) {
+    g_windowBusyMs = 0;
+    for (int i = 0; i < DRYING_JOB_COUNT; i++) {
+        DryingJobInfo& job = g_dryingJobs[i];
+        if (!(g_dryingJobMask & (1 << i)) || (job.oncePerJob && job.doneThisJob)) {
+            continue;
+        }
+        unsigned long elapsedMs = millis() - dryingStartMs;
+        unsigned long leftMs = elapsedMs < dryingMs ? dryingMs - elapsedMs : 0;
+        if (job.estimateMs + DRYING_JOB_MARGIN_MS > leftMs) {
+            Serial.printf("Drying: %s skipped - needs ~%lu ms, %lu ms left\n", job.name, job.estimateMs, leftMs);
+            continue;
+        }
+        if (checkForPauseCommand()) {
+            return false;
+        }
+
+        Serial.printf("Drying: running %s (~%lu ms, %lu ms left)\n", job.name, job.estimateMs, leftMs);
+        unsigned long jobStartMs = millis();
+        bool ok = job.run();
+        unsigned long jobMs = millis() - jobStartMs;
+        g_windowBusyMs += jobMs;
+        job.totalMs += jobMs;
+        job.runs++;
+        job.doneThisJob = true;
+        if (jobMs > job.estimateMs + DRYING_JOB_MARGIN_MS) {
+            Serial.printf("Drying: %s overran its estimate (%lu ms vs %lu ms)\n", job.name, jobMs, job.estimateMs);
+        }
+        job.estimateMs = jobMs;
+        if (!ok) {
+            Serial.printf("Drying: %s aborted\n", job.name);
+            return false;
+        }
+        Serial.printf("Drying: %s done in %lu ms\n", job.name, jobMs);
+    }
+    return true;
+}
+
+void endDryingWindow(unsigned long dryingStartMs) {
+    unsigned long windowMs = millis() - dryingStartMs;
+    g_windowCount++;
+    g_totalWindowMs += windowMs;
+    g_totalBusyMs += g_windowBusyMs;
+    Serial.printf("Drying window %d: %.1f s, jobs %.1f s (%.0f%%), idle %.1f s\n", g_windowCount,
+                  windowMs / 1000.0f, g_windowBusyMs / 1000.0f,
+                  windowMs > 0 ? 100.0f * g_windowBusyMs / windowMs : 0.0f,
+                  (windowMs - min(windowMs, g_windowBusyMs)) / 1000.0f);
+}
+
+void reportDryingUtilization() {
+    if (g_windowCount == 0) {
+        return;
+    }
+    Serial.printf("Drying utilization: %d window(s), %.1f s total, jobs %.1f s (%.0f%%)\n", g_windowCount,
+                  g_totalWindowMs / 1000.0f, g_totalBusyMs / 1000.0f,
+                  g_totalWindowMs > 0 ? 100.0f * g_totalBusyMs / g_totalWindowMs : 0.0f);
+    for (int i = 0; i < DRYING_JOB_COUNT; i++) {
+        if (g_dryingJobs[i].runs > 0) {
+            Serial.printf("Drying utilization:   %-12s %d run(s), %.1f s\n", g_dryingJobs[i].name,
+                          g_dryingJobs[i].runs, g_dryingJobs[i].totalMs / 1000.0f);
+        }
+    }
+}
+
+//* ************************************************************************
+//* **************************** SIDE DRYING *******************************
+//* ************************************************************************
+
+void resetSideDrying() {
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        g_sidePainted[side] = false;
+        g_sideDoneMs[side] = 0;
+        g_sideDurationMs[side] = 0;
+    }
+}
+
+void recordSidePainted(int side, unsigned long startMs, unsigned long doneMs) {
+    if (side < 1 || side > PAINT_SIDE_COUNT) {
+        return;
+    }
+    g_sidePainted[side] = true;
+    g_sideDoneMs[side] = doneMs;
+    g_sideDurationMs[side] = doneMs - startMs;
+}
+
+// Wrap-safe: negative once the side is dry
+static long sideReadyInMs(int side, unsigned long flashOffMs, unsigned long nowMs) {
+    if (!g_sidePainted[side]) {
+        return 0;
+    }
+    return (long)(g_sideDoneMs[side] + flashOffMs - nowMs);
+}
+
+unsigned long sideDryingLeftMs(int side, unsigned long flashOffMs) {
+    if (side < 1 || side > PAINT_SIDE_COUNT) {
+        return 0;
+    }
+    long readyInMs = sideReadyInMs(side, flashOffMs, millis());
+    return readyInMs > 0 ? (unsigned long)readyInMs : 0;
+}
+
+// Total wait (ms) to paint the sides in this order, starting now
+static long coatWaitMs(const int order[PAINT_SIDE_COUNT], const long readyInMs[PAINT_SIDE_COUNT + 1]) {
+    long clockMs = 0;
+    long waitMs = 0;
+    for (int i = 0; i < PAINT_SIDE_COUNT; i++) {
+        int side = order[i];
+        if (readyInMs[side] > clockMs) {
+            waitMs += readyInMs[side] - clockMs;
+            clockMs = readyInMs[side];
+        }
+        clockMs += (long)g_sideDurationMs[side];
+    }
+    return waitMs;
+}
+
+void planCoatSideOrder(int order[PAINT_SIDE_COUNT], unsigned long flashOffMs) {
+    static const int kDefaultOrder[PAINT_SIDE_COUNT] = { 4, 3, 2, 1 };
+    unsigned long nowMs = millis();
+    long readyInMs[PAINT_SIDE_COUNT + 1];
+    for (int side = 1; side <= PAINT_SIDE_COUNT; side++) {
+        readyInMs[side] = sideReadyInMs(side, flashOffMs, nowMs);
+    }
+
+    long defaultWaitMs = coatWaitMs(kDefaultOrder, readyInMs);
+    long bestWaitMs = defaultWaitMs;
+    std::copy(kDefaultOrder, kDefaultOrder + PAINT_SIDE_COUNT, order);
+
+    //! 24 orders - cheap enough to try them all
+    int candidate[PAINT_SIDE_COUNT] = { 1, 2, 3, 4 };
+    do {
+        long waitMs = coatWaitMs(candidate, readyInMs);
+        if (waitMs < bestWaitMs) {
+            bestWaitMs = waitMs;
+            std::copy(candidate, candidate + PAINT_SIDE_COUNT, order);
+        }
+    } while (std::next_permutation(candidate, candidate + PAINT_SIDE_COUNT));
+
+    Serial.printf("Side drying: next coat order %d,%d,%d,%d - predicted wait %.1f s (4,3,2,1: %.1f s)\n",
+                  order[0], order[1], order[2], order[3], bestWaitMs / 1000.0f, defaultWaitMs / 1000.0f);
+}
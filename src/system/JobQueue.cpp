@@ -0,0 +1,374 @@
+#include "system/JobQueue.h"
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+#include "system/StateMachine.h"
+#include "motors/PaintingSides.h"
+#include "hardware/controlPanel_Functions.h"
+#include "states/PnPFunctions.h"
+#include "storage/TrayDefinitions.h"
+#include "storage/Persistence.h"
+#include "states/HomingState.h"
+
+// NVS keys; queued jobs get their index appended ("jq0", "jq0d")
+#define JOB_QUEUE_COUNT_KEY "jqCount"
+#define JOB_QUEUE_NEXT_ID_KEY "jqNextId"
+#define JOB_QUEUE_JOB_KEY "jq"
+#define JOB_QUEUE_DATA_KEY "d"
+#define CLEAN_EVERY_JOBS_KEY "jqCleanK"
+#define JOBS_SINCE_CLEAN_KEY "jqSinceCln"
+
+extern StateMachine* stateMachine;
+extern WebSocketsServer webSocket;
+
+static QueuedJob g_jobs[JOB_QUEUE_CAPACITY];
+static int g_jobCount = 0;
+static int g_nextJobId = 1;
+static bool g_queueRunning = false;
+static int g_cleanEveryJobs = DEFAULT_CLEAN_EVERY_JOBS;
+static int g_jobsSinceClean = 0;
+
+// The job the queue started, tracked until the machine is idle again
+static bool g_hasActiveJob = false;
+static QueuedJob g_activeJob;
+static bool g_activeJobStopped = false;
+static uint32_t g_activeJobHomingCycles = 0;   // getHomingCycleCount() when the job started
+
+static const char* const kJobTypeNames[QUEUED_JOB_TYPE_COUNT] = { "paint", "pnp", "clean" };
+
+const char* queuedJobTypeName(QueuedJobType type) {
+    return type >= 0 && type < QUEUED_JOB_TYPE_COUNT ? kJobTypeNames[type] : "?";
+}
+
+bool parseQueuedJobType(const String& text, QueuedJobType& type) {
+    for (int i = 0; i < QUEUED_JOB_TYPE_COUNT; i++) {
+        if (text.equalsIgnoreCase(kJobTypeNames[i])) {
+            type = (QueuedJobType)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//* ************************************************************************
+//* ***************************** PERSISTENCE ******************************
+//* ************************************************************************
+// Two ints per job: id | type | priority | coats, then flash-off | tray + 1.
+
+static void saveJobQueue() {
+    persistence.beginTransaction(false);
+    persistence.saveInt(JOB_QUEUE_COUNT_KEY, g_jobCount);
+    persistence.saveInt(JOB_QUEUE_NEXT_ID_KEY, g_nextJobId);
+    for (int i = 0; i < g_jobCount; i++) {
+        const QueuedJob& job = g_jobs[i];
+        String jobKey = String(JOB_QUEUE_JOB_KEY) + i;
+        String dataKey = jobKey + JOB_QUEUE_DATA_KEY;
+        uint32_t packed = ((uint32_t)(job.id & 0xFFFF) << 16) | ((uint32_t)job.type << 12) |
+                          ((uint32_t)job.priority << 8) | (uint32_t)(job.coats & 0xFF);
+        uint32_t data = ((uint32_t)(job.flashOffSeconds & 0xFFFF) << 8) | (uint32_t)((job.traySlot + 1) & 0xFF);
+        persistence.saveInt(jobKey.c_str(), (int)packed);
+        persistence.saveInt(dataKey.c_str(), (int)data);
+    }
+    persistence.endTransaction();
+}
+
+static void broadcastJobQueue() {
+    String message = "JOB_QUEUE:" + describeJobQueue();
+    webSocket.broadcastTXT(message);
+}
+
+static void broadcastJobEvent(const QueuedJob& job, const char* event) {
+    String message = "JOB_EVENT:";
+    message += job.id;
+    message += ",";
+    message += event;
+    webSocket.broadcastTXT(message);
+    Serial.printf("Job queue: job %d (%s) %s\n", job.id, queuedJobTypeName(job.type), event);
+}
+
+void loadJobQueueFromNVS() {
+    persistence.beginTransaction(true);
+    g_jobCount = constrain(persistence.loadInt(JOB_QUEUE_COUNT_KEY, 0), 0, JOB_QUEUE_CAPACITY);
+    g_nextJobId = max(1, persistence.loadInt(JOB_QUEUE_NEXT_ID_KEY, 1));
+    g_cleanEveryJobs = max(0, persistence.loadInt(CLEAN_EVERY_JOBS_KEY, DEFAULT_CLEAN_EVERY_JOBS));
+    g_jobsSinceClean = max(0, persistence.loadInt(JOBS_SINCE_CLEAN_KEY, 0));
+    for (int i = 0; i < g_jobCount; i++) {
+        String jobKey = String(JOB_QUEUE_JOB_KEY) + i;
+        String dataKey = jobKey + JOB_QUEUE_DATA_KEY;
+        uint32_t packed = (uint32_t)persistence.loadInt(jobKey.c_str(), 0);
+        uint32_t data = (uint32_t)persistence.loadInt(dataKey.c_str(), 0);
+        QueuedJob& job = g_jobs[i];
+        job.id = (int)(packed >> 16);
+        job.type = (QueuedJobType)constrain((int)((packed >> 12) & 0xF), 0, QUEUED_JOB_TYPE_COUNT - 1);
+        job.priority = (int)((packed >> 8) & 0xF);
+        job.coats = (int)(packed & 0xFF);
+        job.flashOffSeconds = (int)(data >> 8);
+        job.traySlot = (int)(data & 0xFF) - 1;
+    }
+    persistence.endTransaction();
+    g_queueRunning = false;
+    Serial.printf("Job queue loaded: %d job(s), clean every %d job(s) - held until resumed\n",
+                  g_jobCount, g_cleanEveryJobs);
+}
+
+//* ************************************************************************
+//* ******************************* EDITING ********************************
+//* ************************************************************************
+
+static int findJob(int id) {
+    for (int i = 0; i < g_jobCount; i++) {
+        if (g_jobs[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int enqueueJob(QueuedJob job) {
+    if (g_jobCount >= JOB_QUEUE_CAPACITY) {
+        Serial.println("Job queue: full");
+        return -1;
+    }
+    job.id = g_nextJobId;
+    g_nextJobId = g_nextJobId >= 0xFFFF ? 1 : g_nextJobId + 1;
+    job.priority = constrain(job.priority, 0, JOB_PRIORITY_MAX);
+    job.coats = constrain(job.coats, 1, 99);
+    job.flashOffSeconds = constrain(job.flashOffSeconds, 0, 600); // Same cap as PAINT_ALL_SIDES_MULTIPLE
+    if (job.traySlot < -1 || job.traySlot >= TRAY_DEFINITION_SLOTS) {
+        job.traySlot = -1;
+    }
+    g_jobs[g_jobCount++] = job;
+    saveJobQueue();
+    Serial.printf("Job queue: added job %d (%s, %d coat(s), %d s flash-off, tray %d, priority %d)\n",
+                  job.id, queuedJobTypeName(job.type), job.coats, job.flashOffSeconds, job.traySlot, job.priority);
+    broadcastJobQueue();
+    return job.id;
+}
+
+bool cancelJob(int id) {
+    int index = findJob(id);
+    if (index < 0) {
+        return false;
+    }
+    for (int i = index; i < g_jobCount - 1; i++) {
+        g_jobs[i] = g_jobs[i + 1];
+    }
+    g_jobCount--;
+    saveJobQueue();
+    Serial.printf("Job queue: cancelled job %d\n", id);
+    broadcastJobQueue();
+    return true;
+}
+
+bool moveJob(int id, int index) {
+    int from = findJob(id);
+    if (from < 0) {
+        return false;
+    }
+    int to = constrain(index, 0, g_jobCount - 1);
+    QueuedJob job = g_jobs[from];
+    if (from < to) {
+        for (int i = from; i < to; i++) g_jobs[i] = g_jobs[i + 1];
+    } else {
+        for (int i = from; i > to; i--) g_jobs[i] = g_jobs[i - 1];
+    }
+    g_jobs[to] = job;
+    saveJobQueue();
+    broadcastJobQueue();
+    return true;
+}
+
+bool setJobPriority(int id, int priority) {
+    int index = findJob(id);
+    if (index < 0) {
+        return false;
+    }
+    g_jobs[index].priority = constrain(priority, 0, JOB_PRIORITY_MAX);
+    saveJobQueue();
+    broadcastJobQueue();
+    return true;
+}
+
+//* ************************************************************************
+//* ***************************** SETTINGS *********************************
+//* ************************************************************************
+
+void setJobQueueRunning(bool running) {
+    g_queueRunning = running;
+    Serial.printf("Job queue %s\n", running ? "running" : "held");
+    broadcastJobQueue();
+}
+
+bool isJobQueueRunning() {
+    return g_queueRunning;
+}
+
+void holdJobQueue(const char* reason) {
+    if (g_hasActiveJob) {
+        g_activeJobStopped = true;
+    }
+    if (g_queueRunning) {
+        Serial.printf("Job queue held: %s\n", reason);
+        setJobQueueRunning(false);
+    }
+}
+
+void setCleanEveryJobs(int jobs) {
+    g_cleanEveryJobs = max(0, jobs);
+    persistence.beginTransaction(false);
+    persistence.saveInt(CLEAN_EVERY_JOBS_KEY, g_cleanEveryJobs);
+    persistence.endTransaction();
+    Serial.printf("Job queue: clean every %d job(s)\n", g_cleanEveryJobs);
+    broadcastJobQueue();
+}
+
+int getCleanEveryJobs() {
+    return g_cleanEveryJobs;
+}
+
+String describeJobQueue() {
+    String text;
+    text += g_queueRunning ? 1 : 0;
+    text += ",";
+    text += g_cleanEveryJobs;
+    text += ",";
+    text += g_hasActiveJob ? g_activeJob.id : 0;
+    for (int i = 0; i < g_jobCount; i++) {
+        const QueuedJob& job = g_jobs[i];
+        text += ";";
+        text += job.id;
+        text += ":";
+        text += queuedJobTypeName(job.type);
+        text += ":";
+        text += job.priority;
+        text += ":";
+        text += job.coats;
+        text += ":";
+        text += job.flashOffSeconds;
+        text += ":";
+        text += job.traySlot;
+    }
+    return text;
+}
+
+//* ************************************************************************
+//* ****************************** DISPATCH ********************************
+//* ************************************************************************
+
+// Highest priority, then queue order
+static int nextJobIndex() {
+    int best = -1;
+    for (int i = 0; i < g_jobCount; i++) {
+        if (best < 0 || g_jobs[i].priority > g_jobs[best].priority) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void startJob(const QueuedJob& job) {
+    g_activeJob = job;
+    g_hasActiveJob = true;
+    g_activeJobStopped = false;
+    g_activeJobHomingCycles = getHomingCycleCount();
+    broadcastJobEvent(job, "started");
+
+    if (job.traySlot >= 0 && job.traySlot != getActiveTraySlot()) {
+        selectTraySlot(job.traySlot);
+    }
+    switch (job.type) {
+        case QUEUED_JOB_PAINT:
+            g_interCoatDelaySeconds = job.flashOffSeconds;
+            paintAllSidesCoats(job.coats);
+            break;
+        case QUEUED_JOB_PNP_PAINT:
+            g_interCoatDelaySeconds = job.flashOffSeconds;
+            startPnPFullCycle(job.coats); // Blocking; hands over to painting when the tray is full
+            break;
+        case QUEUED_JOB_CLEAN:
+            stateMachine->changeState(stateMachine->getCleaningState());
+            break;
+        default:
+            break;
+    }
+
+    //! Every job leaves Idle straight away; still idle means it was refused or aborted
+    if (stateMachine->getCurrentState() == stateMachine->getIdleState()) {
+        broadcastJobEvent(job, "failed");
+        g_hasActiveJob = false;
+        holdJobQueue("job did not start");
+        // Back to the front so it is not lost (the cadence clean is not a queued job)
+        if (job.id != 0 && g_jobCount < JOB_QUEUE_CAPACITY) {
+            for (int i = g_jobCount; i > 0; i--) {
+                g_jobs[i] = g_jobs[i - 1];
+            }
+            g_jobs[0] = job;
+            g_jobCount++;
+            saveJobQueue();
+        }
+    }
+    broadcastJobQueue();
+}
+
+static void finishActiveJob() {
+    State* current = stateMachine->getCurrentState();
+    bool idle = current == stateMachine->getIdleState();
+    //! A job that ends by homing is only done if that homing succeeded; the
+    //! next job must not start on an unhomed machine
+    bool homingFailed = getHomingCycleCount() != g_activeJobHomingCycles && !didLastHomingSucceed();
+    if (current == stateMachine->getErrorState() || (idle && homingFailed)) {
+        broadcastJobEvent(g_activeJob, "failed");
+        g_hasActiveJob = false;
+        holdJobQueue(homingFailed ? "homing after the job failed" : "job ended in error");
+    } else if (idle) {
+        g_hasActiveJob = false;
+        if (g_activeJobStopped) {
+            broadcastJobEvent(g_activeJob, "stopped");
+        } else {
+            broadcastJobEvent(g_activeJob, "done");
+            if (g_activeJob.type == QUEUED_JOB_CLEAN) {
+                g_jobsSinceClean = 0;
+            } else {
+                g_jobsSinceClean++;
+            }
+            persistence.beginTransaction(false);
+            persistence.saveInt(JOBS_SINCE_CLEAN_KEY, g_jobsSinceClean);
+            persistence.endTransaction();
+        }
+    } else {
+        return; // Still running
+    }
+    broadcastJobQueue();
+}
+
+void serviceJobQueue() {
+    if (!stateMachine) {
+        return;
+    }
+    if (g_hasActiveJob) {
+        finishActiveJob();
+        return;
+    }
+    if (!g_queueRunning || stateMachine->getCurrentState() != stateMachine->getIdleState()) {
+        return;
+    }
+
+    //! Cleaning cadence comes before the next queued job
+    if (g_cleanEveryJobs > 0 && g_jobsSinceClean >= g_cleanEveryJobs && g_jobCount > 0) {
+        QueuedJob clean = { 0, QUEUED_JOB_CLEAN, JOB_PRIORITY_MAX, 1, 0, -1 };
+        Serial.printf("Job queue: %d job(s) since the last clean - cleaning first\n", g_jobsSinceClean);
+        startJob(clean);
+        return;
+    }
+
+    int index = nextJobIndex();
+    if (index < 0) {
+        return;
+    }
+    QueuedJob job = g_jobs[index];
+    for (int i = index; i < g_jobCount - 1; i++) {
+        g_jobs[i] = g_jobs[i + 1];
+    }
+    g_jobCount--;
+    saveJobQueue();
+    startJob(job);
+}
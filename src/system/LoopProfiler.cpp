@@ -0,0 +1,111 @@
+#include "system/LoopProfiler.h"
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+#include "utils/settings.h"
+
+extern WebSocketsServer webSocket;
+
+struct LoopProfileHistogram {
+    uint32_t buckets[LOOP_PROFILE_BUCKETS];
+    uint32_t samples;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+static const char* const kSectionNames[LOOP_PROFILE_SECTION_COUNT] = {
+    "period", "work", "ota", "safety", "state", "services", "panel", "dashboard", "rotation", "wspump"
+};
+
+static LoopProfileHistogram g_loopProfile[LOOP_PROFILE_SECTION_COUNT];
+static uint32_t g_loopStartUs = 0;
+static bool g_havePreviousLoop = false;
+static volatile bool g_reportRequested = false;
+
+//* ************************************************************************
+//* ****************************** SAMPLING ********************************
+//* ************************************************************************
+
+void recordLoopProfileSample(LoopProfileSection section, uint32_t durationUs) {
+    LoopProfileHistogram& histogram = g_loopProfile[section];
+    int bucket = durationUs == 0 ? 0 : 32 - __builtin_clz(durationUs);
+    if (bucket >= LOOP_PROFILE_BUCKETS) {
+        bucket = LOOP_PROFILE_BUCKETS - 1;
+    }
+    histogram.buckets[bucket]++;
+    histogram.samples++;
+    histogram.totalUs += durationUs;
+    if (durationUs > histogram.maxUs) {
+        histogram.maxUs = durationUs;
+    }
+}
+
+uint32_t loopProfileBegin() {
+    uint32_t nowUs = micros();
+    if (g_havePreviousLoop) {
+        recordLoopProfileSample(LOOP_PROFILE_PERIOD, nowUs - g_loopStartUs);
+    }
+    g_havePreviousLoop = true;
+    g_loopStartUs = nowUs;
+    return nowUs;
+}
+
+//* ************************************************************************
+//* ***************************** REPORTING ********************************
+//* ************************************************************************
+
+// Upper edge (us) of the bucket holding the given fraction of samples
+static uint32_t bucketPercentileUs(const LoopProfileHistogram& histogram, float fraction) {
+    uint32_t target = (uint32_t)(histogram.samples * fraction);
+    uint32_t seen = 0;
+    for (int b = 0; b < LOOP_PROFILE_BUCKETS; b++) {
+        seen += histogram.buckets[b];
+        if (seen > target) {
+            return b == 0 ? 0 : (1UL << b) - 1;
+        }
+    }
+    return histogram.maxUs;
+}
+
+static void reportLoopProfile() {
+    Serial.println("Loop profile (us):  samples     mean      p50      p99      max");
+    for (int i = 0; i < LOOP_PROFILE_SECTION_COUNT; i++) {
+        const LoopProfileHistogram& histogram = g_loopProfile[i];
+        uint32_t meanUs = histogram.samples ? (uint32_t)(histogram.totalUs / histogram.samples) : 0;
+        uint32_t p50Us = bucketPercentileUs(histogram, 0.50f);
+        uint32_t p99Us = bucketPercentileUs(histogram, 0.99f);
+        Serial.printf("  %-10s %10lu %8lu %8lu %8lu %8lu\n", kSectionNames[i], (unsigned long)histogram.samples,
+                      (unsigned long)meanUs, (unsigned long)p50Us, (unsigned long)p99Us, (unsigned long)histogram.maxUs);
+
+        char header[96];
+        snprintf(header, sizeof(header), "LOOP_PROFILE:%s:n=%lu,mean=%lu,p50=%lu,p99=%lu,max=%lu;", kSectionNames[i],
+                 (unsigned long)histogram.samples, (unsigned long)meanUs, (unsigned long)p50Us,
+                 (unsigned long)p99Us, (unsigned long)histogram.maxUs);
+        String message = header;
+        for (int b = 0; b < LOOP_PROFILE_BUCKETS; b++) {
+            if (b > 0) {
+                message += ",";
+            }
+            message += (unsigned long)histogram.buckets[b];
+        }
+        webSocket.broadcastTXT(message);
+    }
+}
+
+void requestLoopProfileReport() {
+    g_reportRequested = true;
+}
+
+void serviceLoopProfileReport() {
+    if (!g_reportRequested) {
+        return;
+    }
+    g_reportRequested = false;
+    reportLoopProfile();
+    g_havePreviousLoop = false; // Keep the report's own time out of the period histogram
+}
+
+void resetLoopProfile() {
+    memset(g_loopProfile, 0, sizeof(g_loopProfile));
+    g_havePreviousLoop = false; // The period spanning the reset would be skewed by the report
+    Serial.println("Loop profile reset");
+}
@@ -0,0 +1,240 @@
+#include "system/PhaseStats.h"
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+#include "system/StateMachine.h"
+#include "settings/painting.h"
+#include "storage/Persistence.h"
+
+// NVS keys; per-phase means get the phase index appended ("phAvg1")
+#define PHASE_JOBS_KEY "phJobs"
+#define PHASE_MEAN_KEY "phAvg"
+
+extern StateMachine* stateMachine;
+extern WebSocketsServer webSocket;
+
+static const char* const kPhaseNames[PHASE_COUNT] = {
+    "other", "travel", "paint", "rotate", "button", "homing", "cleaning", "flashoff"
+};
+
+// Open phases; [0] is the background phase
+static CyclePhase g_phaseStack[PHASE_STACK_DEPTH] = { PHASE_OTHER };
+static uint32_t g_spanStartUs[PHASE_STACK_DEPTH];
+static int g_phaseDepth = 0;
+static int g_phaseOverflow = 0;     // begins dropped because the stack was full
+static uint32_t g_markUs = 0;       // Time up to which the current phase has been charged
+
+static bool g_jobActive = false;
+static unsigned long g_jobStartMs = 0;
+static uint64_t g_jobUs[PHASE_COUNT];
+
+static uint16_t g_histogram[PHASE_COUNT][PHASE_HISTOGRAM_BUCKETS];
+static uint16_t g_histogramSamples[PHASE_COUNT];
+
+static int g_summaryJobs = 0;
+static float g_summaryMeanSeconds[PHASE_COUNT];
+
+const char* cyclePhaseName(CyclePhase phase) {
+    return phase >= 0 && phase < PHASE_COUNT ? kPhaseNames[phase] : "?";
+}
+
+//* ************************************************************************
+//* ****************************** SAMPLING ********************************
+//* ************************************************************************
+//! Called from the motion loops - keep these to a micros() read and a few adds
+
+static inline void chargeCurrentPhase(uint32_t nowUs) {
+    if (g_jobActive) {
+        g_jobUs[g_phaseStack[g_phaseDepth]] += nowUs - g_markUs;
+    }
+    g_markUs = nowUs;
+}
+
+// Bucket 0: under 1 ms; bucket b: [2^(b-1), 2^b) ms; the last bucket is open-ended
+static void recordSpan(CyclePhase phase, uint32_t spanUs) {
+    if (!g_jobActive) {
+        return;
+    }
+    uint32_t spanMs = spanUs / 1000;
+    int bucket = spanMs == 0 ? 0 : min(PHASE_HISTOGRAM_BUCKETS - 1, 32 - __builtin_clz(spanMs));
+    //? Rolling: halve the counts once the window is full so old jobs fade out
+    if (++g_histogramSamples[phase] > PHASE_HISTOGRAM_WINDOW) {
+        g_histogramSamples[phase] = 0;
+        for (int b = 0; b < PHASE_HISTOGRAM_BUCKETS; b++) {
+            g_histogram[phase][b] /= 2;
+            g_histogramSamples[phase] += g_histogram[phase][b];
+        }
+        g_histogramSamples[phase]++;
+    }
+    g_histogram[phase][bucket]++;
+}
+
+void beginPhase(CyclePhase phase) {
+    uint32_t nowUs = micros();
+    if (g_phaseDepth + 1 >= PHASE_STACK_DEPTH) {
+        g_phaseOverflow++;
+        return;
+    }
+    chargeCurrentPhase(nowUs);
+    //! Homing and cleaning keep their own moves
+    CyclePhase outer = g_phaseStack[g_phaseDepth];
+    if (g_phaseDepth > 0 && (outer == PHASE_HOMING || outer == PHASE_CLEANING)) {
+        phase = outer;
+    }
+    g_phaseDepth++;
+    g_phaseStack[g_phaseDepth] = phase;
+    g_spanStartUs[g_phaseDepth] = nowUs;
+}
+
+void endPhase() {
+    uint32_t nowUs = micros();
+    if (g_phaseOverflow > 0) {
+        g_phaseOverflow--;
+        return;
+    }
+    if (g_phaseDepth == 0) {
+        return;
+    }
+    chargeCurrentPhase(nowUs);
+    CyclePhase phase = g_phaseStack[g_phaseDepth];
+    // A span inside one of the same phase is already part of the outer sample
+    if (g_phaseStack[g_phaseDepth - 1] != phase) {
+        recordSpan(phase, nowUs - g_spanStartUs[g_phaseDepth]);
+    }
+    g_phaseDepth--;
+}
+
+void setPhaseBackground(CyclePhase phase) {
+    if (g_phaseStack[0] == phase) {
+        return;
+    }
+    uint32_t nowUs = micros();
+    if (g_phaseDepth == 0) {
+        chargeCurrentPhase(nowUs);
+    }
+    if (g_phaseStack[0] != PHASE_OTHER) {
+        recordSpan(g_phaseStack[0], nowUs - g_spanStartUs[0]);
+    }
+    g_phaseStack[0] = phase;
+    g_spanStartUs[0] = nowUs;
+}
+
+//* ************************************************************************
+//* ******************************** JOBS **********************************
+//* ************************************************************************
+
+void beginPhaseJob() {
+    if (g_jobActive) {
+        return;
+    }
+    g_markUs = micros();
+    g_jobStartMs = millis();
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        g_jobUs[i] = 0;
+    }
+    g_phaseStack[0] = PHASE_OTHER;
+    g_spanStartUs[0] = g_markUs;
+    g_jobActive = true;
+}
+
+static void saveSummary() {
+    persistence.beginTransaction(false);
+    persistence.saveInt(PHASE_JOBS_KEY, g_summaryJobs);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        String key = String(PHASE_MEAN_KEY) + i;
+        persistence.saveFloat(key.c_str(), g_summaryMeanSeconds[i]);
+    }
+    persistence.endTransaction();
+}
+
+static void endPhaseJob(const char* result) {
+    setPhaseBackground(PHASE_OTHER);
+    chargeCurrentPhase(micros());
+    g_jobActive = false;
+
+    float totalSeconds = (millis() - g_jobStartMs) / 1000.0f;
+    String message = "PHASE_BREAKDOWN:result=";
+    message += result;
+    message += ",total=";
+    message += String(totalSeconds, 1);
+    Serial.printf("Phase breakdown (%s): %.1f s\n", result, totalSeconds);
+
+    //! Running mean per phase over all finished jobs
+    g_summaryJobs++;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        float seconds = g_jobUs[i] / 1000000.0f;
+        g_summaryMeanSeconds[i] += (seconds - g_summaryMeanSeconds[i]) / g_summaryJobs;
+        Serial.printf("  %-9s %7.1f s %5.1f%%\n", kPhaseNames[i], seconds,
+                      totalSeconds > 0.0f ? 100.0f * seconds / totalSeconds : 0.0f);
+        message += ",";
+        message += kPhaseNames[i];
+        message += "=";
+        message += String(seconds, 1);
+    }
+    saveSummary();
+    webSocket.broadcastTXT(message);
+}
+
+void servicePhaseStats() {
+    if (!g_jobActive || !stateMachine) {
+        return;
+    }
+    State* current = stateMachine->getCurrentState();
+    if (current == stateMachine->getIdleState()) {
+        endPhaseJob("done");
+    } else if (current == stateMachine->getErrorState()) {
+        endPhaseJob("error");
+    }
+}
+
+//* ************************************************************************
+//* ***************************** REPORTING ********************************
+//* ************************************************************************
+
+void broadcastPhaseStats() {
+    String summary = "PHASE_SUMMARY:jobs=";
+    summary += g_summaryJobs;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        summary += ",";
+        summary += kPhaseNames[i];
+        summary += "=";
+        summary += String(g_summaryMeanSeconds[i], 1);
+    }
+    webSocket.broadcastTXT(summary);
+
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        String histogram = "PHASE_HISTOGRAM:";
+        histogram += kPhaseNames[i];
+        histogram += ":";
+        for (int b = 0; b < PHASE_HISTOGRAM_BUCKETS; b++) {
+            if (b > 0) {
+                histogram += ",";
+            }
+            histogram += g_histogram[i][b];
+        }
+        webSocket.broadcastTXT(histogram);
+    }
+}
+
+void resetPhaseStats() {
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        g_histogramSamples[i] = 0;
+        g_summaryMeanSeconds[i] = 0.0f;
+        for (int b = 0; b < PHASE_HISTOGRAM_BUCKETS; b++) {
+            g_histogram[i][b] = 0;
+        }
+    }
+    g_summaryJobs = 0;
+    saveSummary();
+    Serial.println("Phase stats reset");
+}
+
+void loadPhaseStatsFromNVS() {
+    persistence.beginTransaction(true);
+    g_summaryJobs = persistence.loadInt(PHASE_JOBS_KEY, 0);
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        String key = String(PHASE_MEAN_KEY) + i;
+        g_summaryMeanSeconds[i] = persistence.loadFloat(key.c_str(), 0.0f);
+    }
+    persistence.endTransaction();
+    Serial.printf("Phase stats loaded: %d job(s)\n", g_summaryJobs);
+}
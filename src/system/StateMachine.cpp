@@ -5,10 +5,12 @@
 #include "states/CleaningState.h"
 #include "states/PausedState.h"
 #include "states/InspectTipState.h"
+#include "states/ErrorState.h"
 #include <Arduino.h>
 #include "system/machine_state.h"
 #include "states/State.h"
 #include <WebSocketsServer.h>
+#include "motors/LimitSwitches.h"
 
 //* ************************************************************************
 //* ************************* STATE MACHINE *******************************
@@ -36,6 +38,7 @@ StateMachine::StateMachine() :
     cleaningState = new CleaningState();
     pausedState = new PausedState();
     inspectTipState = new InspectTipState();
+    errorState = new ErrorState();
     
     // Set initial state to idle
     currentState = idleState;
@@ -55,6 +58,7 @@ StateMachine::~StateMachine() {
     delete cleaningState;
     delete pausedState;
     delete inspectTipState;
+    delete errorState;
     
     // Clear the global pointer
     stateMachine = nullptr;
@@ -75,6 +79,14 @@ void StateMachine::changeState(State* newState) {
         return;
     }
 
+    //! A latched limit fault can only be left through homing; this also stops
+    //! sequences that were aborted by the fault from moving on to their next state
+    if (currentState == errorState && isLimitFaultLatched() && newState != homingState) {
+        Serial.print("Limit fault latched - refusing transition from ERROR to ");
+        Serial.println(newStateName);
+        return;
+    }
+
     // Set flag to prevent circular state changes
     inStateTransition = true;
     
@@ -0,0 +1,348 @@
+#include "common/Coverage.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "settings/motion.h"
+
+#define COVERAGE_KERNEL_SIGMAS 4.0f        // Kernel truncated at this many sigma
+#define COVERAGE_SUBSTEPS_PER_CELL 4       // Dwell integration steps per grid cell
+
+// Job score weights (per percent) on top of the uniformity CV
+#define COVERAGE_SCORE_OVERSPRAY_WEIGHT 0.002f
+#define COVERAGE_SCORE_THIN_WEIGHT 0.005f
+
+void getDefaultCoverageConfig(CoverageConfig& config) {
+    config.sprayHalfAngleDeg = 30.0f;  // HVLP fan, ~7" wide at 6"
+    config.standoffInches = 6.0f;
+    config.flowRate = 1.0f;
+    config.cellInches = 0.05f;
+    config.coats = 1;
+    config.thinFraction = 0.8f;
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        config.hasPartOutline[i] = false;
+        config.partMinX[i] = config.partMaxX[i] = 0.0f;
+        config.partMinY[i] = config.partMaxY[i] = 0.0f;
+    }
+}
+
+float coverageSigmaInches(const CoverageConfig& config) {
+    const float degToRad = 3.14159265f / 180.0f;
+    return config.standoffInches * tanf(config.sprayHalfAngleDeg * degToRad) / 2.0f;
+}
+
+//* ************************************************************************
+//* ****************************** SWEEPS **********************************
+//* ************************************************************************
+
+struct CoverageSweep {
+    bool alongX;
+    float start;        // Along-axis start (inches)
+    float direction;    // +1 / -1
+    float length;       // inches
+    float cross;        // Fixed cross-axis position (inches)
+    float gunOn, gunOff; // Gun window, inches from start
+    float speed;        // inches/sec
+    float accel;        // inches/sec^2
+};
+
+static CoverageSweep toCoverageSweep(const ToolpathSegment& segment) {
+    CoverageSweep sweep;
+    sweep.alongX = segment.x0 != segment.x1;
+    long from = sweep.alongX ? segment.x0 : segment.y0;
+    long to = sweep.alongX ? segment.x1 : segment.y1;
+    sweep.start = from / STEPS_PER_INCH_XYZ;
+    sweep.direction = (to >= from) ? 1.0f : -1.0f;
+    sweep.length = labs(to - from) / STEPS_PER_INCH_XYZ;
+    sweep.cross = (sweep.alongX ? segment.y0 : segment.x0) / STEPS_PER_INCH_XYZ;
+    sweep.gunOn = segment.gunOnOffset / STEPS_PER_INCH_XYZ;
+    sweep.gunOff = segment.gunOffOffset / STEPS_PER_INCH_XYZ;
+    sweep.speed = segment.speedHz / STEPS_PER_INCH_XYZ;
+    sweep.accel = (sweep.alongX ? DEFAULT_X_ACCEL : DEFAULT_Y_ACCEL) / STEPS_PER_INCH_XYZ;
+    return sweep;
+}
+
+// Trapezoidal profile: ramps at both ends of the sweep
+static float sweepSpeedAt(const CoverageSweep& sweep, float s) {
+    float rampUp = sqrtf(2.0f * sweep.accel * fmaxf(s, 0.0f));
+    float rampDown = sqrtf(2.0f * sweep.accel * fmaxf(sweep.length - s, 0.0f));
+    return fminf(sweep.speed, fminf(rampUp, rampDown));
+}
+
+static void gunOnBounds(const CoverageSweep& sweep, float& minX, float& maxX, float& minY, float& maxY) {
+    float a = sweep.start + sweep.direction * sweep.gunOn;
+    float b = sweep.start + sweep.direction * sweep.gunOff;
+    float lo = fminf(a, b), hi = fmaxf(a, b);
+    if (sweep.alongX) {
+        minX = fminf(minX, lo); maxX = fmaxf(maxX, hi);
+        minY = fminf(minY, sweep.cross); maxY = fmaxf(maxY, sweep.cross);
+    } else {
+        minY = fminf(minY, lo); maxY = fmaxf(maxY, hi);
+        minX = fminf(minX, sweep.cross); maxX = fmaxf(maxX, sweep.cross);
+    }
+}
+
+//* ************************************************************************
+//* ***************************** RASTERIZER *******************************
+//* ************************************************************************
+
+// Deposits one sweep as a rank-1 update; returns the mass it laid down
+static double depositSweep(CoverageSurface& surface, const CoverageSweep& sweep,
+                           const std::vector<float>& kernel, float sigma, float flowRate, float cell) {
+    if (sweep.gunOff <= sweep.gunOn || sweep.speed <= 0.0f) {
+        return 0.0;
+    }
+    const int alongCells = sweep.alongX ? surface.width : surface.height;
+    const float alongOrigin = sweep.alongX ? surface.originX : surface.originY;
+    const int half = (int)kernel.size() - 1;
+
+    //! Dwell time per along-axis cell inside the gun window
+    std::vector<float> dwell(alongCells, 0.0f);
+    float window = sweep.gunOff - sweep.gunOn;
+    int steps = (int)ceilf(window / (cell / COVERAGE_SUBSTEPS_PER_CELL));
+    float ds = window / steps;
+    double totalDwell = 0.0;
+    for (int k = 0; k < steps; k++) {
+        float s = sweep.gunOn + (k + 0.5f) * ds;
+        float dt = ds / fmaxf(sweepSpeedAt(sweep, s), 1e-3f);
+        int index = (int)lroundf((sweep.start + sweep.direction * s - alongOrigin) / cell);
+        if (index >= 0 && index < alongCells) {
+            dwell[index] += dt;
+        }
+        totalDwell += dt;
+    }
+
+    //! Along-axis profile: dwell convolved with the kernel
+    std::vector<float> profile(alongCells, 0.0f);
+    for (int i = 0; i < alongCells; i++) {
+        if (dwell[i] == 0.0f) continue;
+        int lo = (i - half < 0) ? -i : -half;
+        int hi = (i + half >= alongCells) ? alongCells - 1 - i : half;
+        float* out = &profile[i];
+        for (int d = lo; d <= hi; d++) {
+            out[d] += dwell[i] * kernel[abs(d)];
+        }
+    }
+
+    //! Cross-axis kernel around the sweep line
+    const int crossCells = sweep.alongX ? surface.height : surface.width;
+    const float crossOrigin = sweep.alongX ? surface.originY : surface.originX;
+    int centre = (int)lroundf((sweep.cross - crossOrigin) / cell);
+    int crossLo = centre - half < 0 ? 0 : centre - half;
+    int crossHi = centre + half >= crossCells ? crossCells - 1 : centre + half;
+    const float norm = 1.0f / (sqrtf(2.0f * 3.14159265f) * sigma);
+    std::vector<float> crossWeight(crossCells, 0.0f);
+    for (int j = crossLo; j <= crossHi; j++) {
+        float d = crossOrigin + j * cell - sweep.cross;
+        crossWeight[j] = flowRate * norm * expf(-(d * d) / (2.0f * sigma * sigma));
+    }
+
+    //! Rank-1 update, contiguous inner loop
+    const int width = surface.width;
+    float* grid = surface.thickness.data();
+    if (sweep.alongX) {
+        for (int j = crossLo; j <= crossHi; j++) {
+            float w = crossWeight[j];
+            float* row = grid + (size_t)j * width;
+            const float* p = profile.data();
+            for (int i = 0; i < width; i++) {
+                row[i] += w * p[i];
+            }
+        }
+    } else {
+        for (int j = 0; j < surface.height; j++) {
+            float w = profile[j];
+            if (w == 0.0f) continue;
+            float* row = grid + (size_t)j * width;
+            const float* c = crossWeight.data();
+            for (int i = crossLo; i <= crossHi; i++) {
+                row[i] += w * c[i];
+            }
+        }
+    }
+    return flowRate * totalDwell;
+}
+
+static void computeSurfaceMetrics(CoverageSurface& surface, double expectedMass, const CoverageConfig& config) {
+    const float cell = config.cellInches;
+    double sum = 0.0, sumSq = 0.0;
+    float minValue = 1e30f, maxValue = 0.0f;
+    long count = 0;
+    for (int j = 0; j < surface.height; j++) {
+        float y = surface.originY + j * cell;
+        if (y < surface.partMinY || y > surface.partMaxY) continue;
+        const float* row = &surface.thickness[(size_t)j * surface.width];
+        for (int i = 0; i < surface.width; i++) {
+            float x = surface.originX + i * cell;
+            if (x < surface.partMinX || x > surface.partMaxX) continue;
+            sum += row[i];
+            sumSq += (double)row[i] * row[i];
+            minValue = fminf(minValue, row[i]);
+            maxValue = fmaxf(maxValue, row[i]);
+            count++;
+        }
+    }
+    surface.meanThickness = surface.stddevThickness = surface.uniformityCv = 0.0f;
+    surface.minRatio = surface.maxRatio = surface.thinPercent = 0.0f;
+    surface.oversprayPercent = 100.0f;
+    if (count == 0 || sum <= 0.0) {
+        return;
+    }
+
+    double mean = sum / count;
+    double variance = fmax(sumSq / count - mean * mean, 0.0);
+    surface.meanThickness = (float)mean;
+    surface.stddevThickness = (float)sqrt(variance);
+    surface.uniformityCv = (float)(sqrt(variance) / mean);
+    surface.minRatio = (float)(minValue / mean);
+    surface.maxRatio = (float)(maxValue / mean);
+
+    long thin = 0;
+    float thinLimit = (float)(config.thinFraction * mean);
+    for (int j = 0; j < surface.height; j++) {
+        float y = surface.originY + j * cell;
+        if (y < surface.partMinY || y > surface.partMaxY) continue;
+        const float* row = &surface.thickness[(size_t)j * surface.width];
+        for (int i = 0; i < surface.width; i++) {
+            float x = surface.originX + i * cell;
+            if (x >= surface.partMinX && x <= surface.partMaxX && row[i] < thinLimit) thin++;
+        }
+    }
+    surface.thinPercent = 100.0f * thin / count;
+
+    double insideMass = sum * cell * cell;
+    surface.oversprayPercent = expectedMass > 0.0 ? (float)(100.0 * fmax(0.0, 1.0 - insideMass / expectedMass)) : 0.0f;
+}
+
+//* ************************************************************************
+//* ***************************** PUBLIC API *******************************
+//* ************************************************************************
+
+std::vector<CoverageSurface> simulateCoverage(const ToolpathSegment* segments, int count,
+                                              const ToolpathRecipe& recipe, const CoverageConfig& config) {
+    std::vector<CoverageSurface> surfaces;
+    std::vector<std::vector<CoverageSweep> > surfaceSweeps;
+    const float cell = config.cellInches;
+    const float sigma = coverageSigmaInches(config);
+
+    //! Group the sweeps by (side, Z)
+    for (int i = 0; i < count; i++) {
+        const ToolpathSegment& segment = segments[i];
+        if (segment.type != TOOLPATH_PAINT) continue;
+        size_t s = 0;
+        while (s < surfaces.size() && !(surfaces[s].side == segment.side && surfaces[s].zInches == segment.z0 / STEPS_PER_INCH_XYZ)) {
+            s++;
+        }
+        if (s == surfaces.size()) {
+            CoverageSurface surface = CoverageSurface();
+            surface.side = segment.side;
+            surface.zInches = segment.z0 / STEPS_PER_INCH_XYZ;
+            surface.mainFace = segment.z0 == (long)(recipe.sides[segment.side - 1].zHeight * STEPS_PER_INCH_XYZ);
+            surfaces.push_back(surface);
+            surfaceSweeps.push_back(std::vector<CoverageSweep>());
+        }
+        surfaceSweeps[s].push_back(toCoverageSweep(segment));
+    }
+
+    //! Kernel samples at whole-cell distances
+    int half = (int)ceilf(COVERAGE_KERNEL_SIGMAS * sigma / cell);
+    std::vector<float> kernel(half + 1);
+    const float norm = 1.0f / (sqrtf(2.0f * 3.14159265f) * sigma);
+    for (int d = 0; d <= half; d++) {
+        float distance = d * cell;
+        kernel[d] = norm * expf(-(distance * distance) / (2.0f * sigma * sigma));
+    }
+
+    for (size_t s = 0; s < surfaces.size(); s++) {
+        CoverageSurface& surface = surfaces[s];
+        const std::vector<CoverageSweep>& sweeps = surfaceSweeps[s];
+        surface.sweepCount = (int)sweeps.size();
+
+        float minX = 1e30f, maxX = -1e30f, minY = 1e30f, maxY = -1e30f;
+        for (size_t k = 0; k < sweeps.size(); k++) {
+            gunOnBounds(sweeps[k], minX, maxX, minY, maxY);
+        }
+        int side = surface.side - 1;
+        if (surface.mainFace && config.hasPartOutline[side]) {
+            surface.partMinX = config.partMinX[side];
+            surface.partMaxX = config.partMaxX[side];
+            surface.partMinY = config.partMinY[side];
+            surface.partMaxY = config.partMaxY[side];
+        } else {
+            // Gun-on box, widened across the sweeps by half the pitch (sigma for a single sweep)
+            float crossMin = 1e30f, crossMax = -1e30f;
+            for (size_t k = 0; k < sweeps.size(); k++) {
+                crossMin = fminf(crossMin, sweeps[k].cross);
+                crossMax = fmaxf(crossMax, sweeps[k].cross);
+            }
+            float pad = sweeps.size() > 1 ? (crossMax - crossMin) / (sweeps.size() - 1) / 2.0f : sigma;
+            bool padX = !sweeps[0].alongX;
+            surface.partMinX = minX - (padX ? pad : 0.0f);
+            surface.partMaxX = maxX + (padX ? pad : 0.0f);
+            surface.partMinY = minY - (padX ? 0.0f : pad);
+            surface.partMaxY = maxY + (padX ? 0.0f : pad);
+        }
+
+        // Grid covers the part and every sweep's spray footprint
+        float margin = half * cell + cell;
+        float gridMinX = fminf(minX, surface.partMinX) - margin;
+        float gridMaxX = fmaxf(maxX, surface.partMaxX) + margin;
+        float gridMinY = fminf(minY, surface.partMinY) - margin;
+        float gridMaxY = fmaxf(maxY, surface.partMaxY) + margin;
+        surface.cellInches = cell;
+        surface.originX = gridMinX;
+        surface.originY = gridMinY;
+        surface.width = (int)ceilf((gridMaxX - gridMinX) / cell) + 1;
+        surface.height = (int)ceilf((gridMaxY - gridMinY) / cell) + 1;
+        surface.thickness.assign((size_t)surface.width * surface.height, 0.0f);
+
+        double expectedMass = 0.0;
+        for (size_t k = 0; k < sweeps.size(); k++) {
+            expectedMass += depositSweep(surface, sweeps[k], kernel, sigma, config.flowRate, cell);
+        }
+        if (config.coats > 1) {
+            for (size_t c = 0; c < surface.thickness.size(); c++) {
+                surface.thickness[c] *= (float)config.coats;
+            }
+            expectedMass *= config.coats;
+        }
+        computeSurfaceMetrics(surface, expectedMass, config);
+    }
+    return surfaces;
+}
+
+float coverageJobScore(const std::vector<CoverageSurface>& surfaces) {
+    double weighted = 0.0, weight = 0.0;
+    for (size_t s = 0; s < surfaces.size(); s++) {
+        const CoverageSurface& surface = surfaces[s];
+        if (!surface.mainFace) continue;
+        double area = fmax((surface.partMaxX - surface.partMinX) * (surface.partMaxY - surface.partMinY), 1e-3);
+        weighted += area * (surface.uniformityCv
+                            + COVERAGE_SCORE_OVERSPRAY_WEIGHT * surface.oversprayPercent
+                            + COVERAGE_SCORE_THIN_WEIGHT * surface.thinPercent);
+        weight += area;
+    }
+    return weight > 0.0 ? (float)(weighted / weight) : 1e9f;
+}
+
+bool writeCoverageMapCsv(const CoverageSurface& surface, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "y\\x");
+    for (int i = 0; i < surface.width; i++) {
+        fprintf(file, ",%.3f", surface.originX + i * surface.cellInches);
+    }
+    fprintf(file, "\n");
+    // Top row = highest Y, so the file reads like the dashboard preview
+    for (int j = surface.height - 1; j >= 0; j--) {
+        fprintf(file, "%.3f", surface.originY + j * surface.cellInches);
+        const float* row = &surface.thickness[(size_t)j * surface.width];
+        for (int i = 0; i < surface.width; i++) {
+            fprintf(file, ",%.4g", row[i]);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef TOOLS_COVERAGE_H
+#define TOOLS_COVERAGE_H
+
+//* ************************************************************************
+//* ************************* COVERAGE SIMULATOR ***************************
+//* ************************************************************************
+// Host-side spray deposition model. Painted sweeps from the toolpath
+// compiler are rasterized onto a grid per painted surface with a Gaussian
+// spray kernel. Deposit at each point is proportional to dwell time, so the
+// slow ends of a sweep (acceleration ramps) and the 75% first/last sweeps
+// come out thicker, like on the part.
+//
+// A sweep along one axis at a fixed cross position is separable: the
+// along-axis profile (dwell convolved with the kernel) times the cross-axis
+// kernel. Each sweep is therefore one rank-1 update of the grid, with a
+// contiguous inner loop the compiler vectorizes.
+
+#include <vector>
+#include "motors/Toolpath.h"
+
+struct CoverageConfig {
+    float sprayHalfAngleDeg;  // Spray cone half angle
+    float standoffInches;     // Nozzle to surface distance
+    float flowRate;           // Deposit per second of gun-on time (arbitrary units)
+    float cellInches;         // Grid resolution
+    int coats;                // Identical passes; thickness scales, uniformity does not change
+    float thinFraction;       // Part cells below this fraction of the mean count as thin
+    // Part outline per side on the main face, machine XY inches. When not set
+    // the outline is the area the recipe means to paint: the gun-on bounding
+    // box, widened across the sweeps by half the sweep pitch.
+    bool hasPartOutline[TOOLPATH_SIDE_COUNT];
+    float partMinX[TOOLPATH_SIDE_COUNT];
+    float partMaxX[TOOLPATH_SIDE_COUNT];
+    float partMinY[TOOLPATH_SIDE_COUNT];
+    float partMaxY[TOOLPATH_SIDE_COUNT];
+};
+
+// One painted surface: all sweeps of a side at one Z height. The side's
+// painting Z is the main face; other heights (Side 2/4 final X pass) are edges.
+struct CoverageSurface {
+    int side;
+    float zInches;
+    bool mainFace;
+    int sweepCount;
+    float cellInches;
+    float originX, originY;       // Centre of cell (0,0), inches
+    int width, height;            // Cells
+    std::vector<float> thickness; // Row-major, row = Y
+    float partMinX, partMaxX, partMinY, partMaxY;
+
+    // Metrics over cells inside the part outline
+    float meanThickness;
+    float stddevThickness;
+    float uniformityCv;           // stddev / mean (lower is better)
+    float minRatio;               // min / mean
+    float maxRatio;               // max / mean
+    float thinPercent;            // Part cells below thinFraction * mean
+    float oversprayPercent;       // Deposit that lands outside the part outline
+};
+
+void getDefaultCoverageConfig(CoverageConfig& config);
+
+/**
+ * @brief Gaussian sigma (inches) for the configured cone: the cone edge is taken as 2 sigma.
+ */
+float coverageSigmaInches(const CoverageConfig& config);
+
+/**
+ * @brief Rasterizes every PAINT segment and computes per-surface metrics.
+ */
+std::vector<CoverageSurface> simulateCoverage(const ToolpathSegment* segments, int count,
+                                              const ToolpathRecipe& recipe, const CoverageConfig& config);
+
+/**
+ * @brief Single figure of merit for a job: area-weighted CV of the main faces
+ * plus overspray and thin-cell penalties. Lower is better.
+ */
+float coverageJobScore(const std::vector<CoverageSurface>& surfaces);
+
+/**
+ * @brief Writes a surface's thickness map as CSV (first row/column are inch coordinates).
+ */
+bool writeCoverageMapCsv(const CoverageSurface& surface, const char* path);
+
+#endif // TOOLS_COVERAGE_H
@@ -0,0 +1,76 @@
+#ifndef TOOLS_SETTINGS_JSON_H
+#define TOOLS_SETTINGS_JSON_H
+
+//* ************************************************************************
+//* ************************ HOST SETTINGS JSON ****************************
+//* ************************************************************************
+// Minimal reader for the flat settings files the host tools take, keyed by
+// the dashboard SETTING: names ({ "side1StartX": 7.0, ... }). Per side N:
+// sideNStartX, sideNStartY, sideNZHeight, sideNSideZHeight, sideNSweepY,
+// sideNShiftX, sideNPaintingXSpeed, sideNPaintingYSpeed, sideNRotationAngle.
+// Header-only so each tool stays a single g++ command line.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include "motors/Toolpath.h"
+
+inline bool readTextFile(const char* path, std::string& contents) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.append(chunk, n);
+    }
+    fclose(file);
+    return true;
+}
+
+// Finds "key": <number> in a flat JSON object. Good enough for settings files.
+inline bool findJsonNumber(const std::string& json, const std::string& key, double& value) {
+    std::string quoted = "\"" + key + "\"";
+    size_t pos = json.find(quoted);
+    if (pos == std::string::npos) {
+        return false;
+    }
+    pos = json.find(':', pos + quoted.size());
+    if (pos == std::string::npos) {
+        return false;
+    }
+    const char* start = json.c_str() + pos + 1;
+    char* end = nullptr;
+    value = strtod(start, &end);
+    return end != start;
+}
+
+inline void readJsonFloat(const std::string& json, const std::string& key, float& target) {
+    double value;
+    if (findJsonNumber(json, key, value)) target = (float)value;
+}
+
+inline void readJsonLong(const std::string& json, const std::string& key, long& target) {
+    double value;
+    if (findJsonNumber(json, key, value)) target = (long)value;
+}
+
+// Overrides recipe fields present in json; missing keys are left alone
+inline void applyRecipeJson(const std::string& json, ToolpathRecipe& recipe) {
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        ToolpathSideRecipe& side = recipe.sides[i];
+        std::string prefix = "side" + std::to_string(i + 1);
+        readJsonFloat(json, prefix + "StartX", side.startX);
+        readJsonFloat(json, prefix + "StartY", side.startY);
+        readJsonFloat(json, prefix + "ZHeight", side.zHeight);
+        readJsonFloat(json, prefix + "SideZHeight", side.sideZHeight);
+        readJsonFloat(json, prefix + "SweepY", side.sweepY);
+        readJsonFloat(json, prefix + "ShiftX", side.shiftX);
+        readJsonLong(json, prefix + "PaintingXSpeed", side.paintingXSpeed);
+        readJsonLong(json, prefix + "PaintingYSpeed", side.paintingYSpeed);
+        readJsonFloat(json, prefix + "RotationAngle", side.rotationAngle);
+    }
+}
+
+#endif // TOOLS_SETTINGS_JSON_H
@@ -0,0 +1,120 @@
+//* ************************************************************************
+//* ************************* COVERAGE SIMULATOR ***************************
+//* ************************************************************************
+// Rasterizes a recipe's painted sweeps onto each part surface and reports
+// thickness uniformity and overspray (model in tools/common/Coverage.h).
+// Not part of the PlatformIO build. Build from the repository root:
+//
+//   g++ -std=c++17 -O3 -march=native -Iinclude -Itools tools/coverage_sim/coverage_sim.cpp tools/common/Coverage.cpp src/Motors/Toolpath.cpp -o coverage_sim
+//
+// Usage:
+//   coverage_sim [settings.json] [--side 1-4] [--coats N] [--map <prefix>]
+//
+// settings.json takes the recipe keys from tools/common/SettingsJson.h plus:
+//   sprayHalfAngleDeg, standoffInches, flowRate, cellInches, coats,
+//   thinFraction, and a part outline per side N (machine XY, inches):
+//   sideNPartMinX, sideNPartMaxX, sideNPartMinY, sideNPartMaxY.
+// --map writes <prefix>_S<side>_Z<z>.csv thickness maps.
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "motors/Toolpath.h"
+#include "common/Coverage.h"
+#include "common/SettingsJson.h"
+
+static void applyCoverageJson(const std::string& json, CoverageConfig& config) {
+    readJsonFloat(json, "sprayHalfAngleDeg", config.sprayHalfAngleDeg);
+    readJsonFloat(json, "standoffInches", config.standoffInches);
+    readJsonFloat(json, "flowRate", config.flowRate);
+    readJsonFloat(json, "cellInches", config.cellInches);
+    readJsonFloat(json, "thinFraction", config.thinFraction);
+    long coats = config.coats;
+    readJsonLong(json, "coats", coats);
+    config.coats = (int)coats;
+
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        std::string prefix = "side" + std::to_string(i + 1);
+        double value;
+        if (findJsonNumber(json, prefix + "PartMinX", value)) {
+            config.hasPartOutline[i] = true;
+            config.partMinX[i] = (float)value;
+            readJsonFloat(json, prefix + "PartMaxX", config.partMaxX[i]);
+            readJsonFloat(json, prefix + "PartMinY", config.partMinY[i]);
+            readJsonFloat(json, prefix + "PartMaxY", config.partMaxY[i]);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* settingsPath = nullptr;
+    const char* mapPrefix = nullptr;
+    int side = TOOLPATH_ALL_SIDES;
+    int coatsOverride = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--side") == 0 && i + 1 < argc) {
+            side = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--coats") == 0 && i + 1 < argc) {
+            coatsOverride = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+            mapPrefix = argv[++i];
+        } else if (argv[i][0] != '-') {
+            settingsPath = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [settings.json] [--side 1-4] [--coats N] [--map <prefix>]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ToolpathRecipe recipe;
+    CoverageConfig config;
+    getDefaultToolpathRecipe(recipe);
+    getDefaultCoverageConfig(config);
+    if (settingsPath) {
+        std::string json;
+        if (!readTextFile(settingsPath, json)) {
+            fprintf(stderr, "Cannot read %s\n", settingsPath);
+            return 1;
+        }
+        applyRecipeJson(json, recipe);
+        applyCoverageJson(json, config);
+    }
+    if (coatsOverride > 0) {
+        config.coats = coatsOverride;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    static ToolpathSegment segments[TOOLPATH_MAX_SEGMENTS];
+    ToolpathSummary summary;
+    int count = compileToolpath(recipe, side, segments, TOOLPATH_MAX_SEGMENTS, summary);
+    std::vector<CoverageSurface> surfaces = simulateCoverage(segments, count, recipe, config);
+    float score = coverageJobScore(surfaces);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    printf("Spray sigma %.3f in (half angle %.1f deg at %.2f in), cell %.3f in, %d coat(s)\n",
+           coverageSigmaInches(config), config.sprayHalfAngleDeg, config.standoffInches, config.cellInches, config.coats);
+    printf("Side  Z      Face  Sweeps  Part X          Part Y           Mean     CV     Min    Max    Thin%%  Overspray%%\n");
+    for (size_t s = 0; s < surfaces.size(); s++) {
+        const CoverageSurface& surface = surfaces[s];
+        printf("S%d   %5.2f  %-4s  %6d  %6.2f-%-6.2f  %6.2f-%-6.2f  %7.3f  %5.3f  %5.2f  %5.2f  %5.1f  %5.1f\n",
+               surface.side, surface.zInches, surface.mainFace ? "main" : "edge", surface.sweepCount,
+               surface.partMinX, surface.partMaxX, surface.partMinY, surface.partMaxY,
+               surface.meanThickness, surface.uniformityCv, surface.minRatio, surface.maxRatio,
+               surface.thinPercent, surface.oversprayPercent);
+
+        if (mapPrefix) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_S%d_Z%.2f.csv", mapPrefix, surface.side, surface.zInches);
+            if (!writeCoverageMapCsv(surface, path)) {
+                fprintf(stderr, "Cannot write %s\n", path);
+                return 1;
+            }
+        }
+    }
+    printf("Job score %.4f (lower is better), cycle %.1f s, evaluated in %.1f ms\n",
+           score, summary.totalSeconds, elapsedMs);
+    return 0;
+}
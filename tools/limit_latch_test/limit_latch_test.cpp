@@ -0,0 +1,115 @@
+//* ************************************************************************
+//* ************************ LIMIT LATCH TEST (HOST) ***********************
+//* ************************************************************************
+// Exercises the limit fault latch shared by the switch interrupts and
+// serviceLimitSwitches() (include/motors/LimitLatch.h) on a PC. Not part of
+// the PlatformIO build. Build and run from the repository root:
+//
+//   g++ -std=c++17 -O2 -Iinclude tools/limit_latch_test/limit_latch_test.cpp -o limit_latch_test && ./limit_latch_test
+//
+// Exits non-zero if any check fails.
+
+#include <stdio.h>
+#include "motors/LimitLatch.h"
+
+static int g_failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            g_failures++; \
+        } \
+    } while (0)
+
+// One axis moving at a step per tick; the service is polled every
+// pollTicks like the firmware motion loops, and stops the axis when it
+// takes a new fault. Returns the position the axis stopped at.
+struct SimulatedMove {
+    long position;
+    long target;
+    bool running;
+};
+
+static long runMove(LimitLatch& latch, SimulatedMove& move, long switchAt, int pollTicks,
+                    int& faultsHandled) {
+    int tick = 0;
+    while (move.running) {
+        move.position++;
+        if (move.position == switchAt) {
+            limitLatchEdge(latch, LIMIT_FAULT_X, true); // Interrupt fires between steps
+        }
+        if (move.position >= move.target) {
+            move.running = false;
+        }
+        if (++tick % pollTicks == 0 && limitLatchTakeNew(latch) != 0) {
+            move.running = false; // stopAllAxes()
+            faultsHandled++;
+        }
+    }
+    return move.position;
+}
+
+static void testTripMidMove() {
+    LimitLatch latch = { true, 0, 0 };
+    SimulatedMove move = { 0, 10000, true };
+    int faultsHandled = 0;
+    long stoppedAt = runMove(latch, move, 6000, 50, faultsHandled);
+
+    CHECK(latch.faultMask == LIMIT_FAULT_X);
+    CHECK(faultsHandled == 1);
+    CHECK(stoppedAt >= 6000 && stoppedAt < 6000 + 50); // Within one poll of the edge
+    CHECK(limitLatchTakeNew(latch) == 0);               // Reported once, still latched
+    CHECK(latch.faultMask != 0);
+}
+
+static void testIgnoredEdges() {
+    LimitLatch latch = { true, 0, 0 };
+    CHECK(!limitLatchEdge(latch, LIMIT_FAULT_Z, false)); // Bounce on release
+    CHECK(latch.faultMask == 0);
+
+    latch.armed = false; // Homing drives onto the switches on purpose
+    CHECK(!limitLatchEdge(latch, LIMIT_FAULT_Z, true));
+    CHECK(latch.faultMask == 0);
+    CHECK(limitLatchTakeNew(latch) == 0);
+}
+
+static void testLaterFaultsAreNew() {
+    LimitLatch latch = { true, 0, 0 };
+    limitLatchEdge(latch, LIMIT_FAULT_Y_LEFT, true);
+    CHECK(limitLatchTakeNew(latch) == LIMIT_FAULT_Y_LEFT);
+
+    // The other gantry switch, then a task-level rack fault, while already faulted
+    limitLatchEdge(latch, LIMIT_FAULT_Y_RIGHT, true);
+    latch.faultMask |= LIMIT_FAULT_Y_RACKED; // latchLimitFault()
+    CHECK(limitLatchTakeNew(latch) == (LIMIT_FAULT_Y_RIGHT | LIMIT_FAULT_Y_RACKED));
+    CHECK(latch.faultMask == (LIMIT_FAULT_Y_LEFT | LIMIT_FAULT_Y_RIGHT | LIMIT_FAULT_Y_RACKED));
+    CHECK(limitLatchTakeNew(latch) == 0);
+}
+
+static void testClearRearms() {
+    LimitLatch latch = { true, 0, 0 };
+    limitLatchEdge(latch, LIMIT_FAULT_X, true);
+    limitLatchTakeNew(latch);
+    limitLatchClear(latch);
+    CHECK(latch.faultMask == 0);
+    CHECK(limitLatchTakeNew(latch) == 0);
+
+    // The same switch faults again after clearing
+    limitLatchEdge(latch, LIMIT_FAULT_X, true);
+    CHECK(limitLatchTakeNew(latch) == LIMIT_FAULT_X);
+}
+
+int main() {
+    testTripMidMove();
+    testIgnoredEdges();
+    testLaterFaultsAreNew();
+    testClearRearms();
+
+    if (g_failures) {
+        printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    printf("Limit latch: all checks passed\n");
+    return 0;
+}
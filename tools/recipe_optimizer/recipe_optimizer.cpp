@@ -0,0 +1,562 @@
+//* ************************************************************************
+//* *************************** RECIPE OPTIMIZER ***************************
+//* ************************************************************************
+// Searches each side's pattern for the shortest cycle time that still meets
+// a coverage target, using the accel-aware toolpath timing (motors/Toolpath.h)
+// and the spray deposition model (common/Coverage.h). Not part of the
+// PlatformIO build. Build from the repository root:
+//
+//   g++ -std=c++17 -O3 -march=native -pthread -Iinclude -Itools tools/recipe_optimizer/recipe_optimizer.cpp tools/common/Coverage.cpp src/Motors/Toolpath.cpp -o recipe_optimizer
+//
+// Usage:
+//   recipe_optimizer [settings.json] [--side 1-4] [--max-cv C] [--max-thin P]
+//                    [--min-thickness T] [--threads N] [--explore-pattern]
+//                    [--out recipe.json]
+//
+// settings.json takes the same keys as coverage_sim. The part outlines
+// (sideNPartMinX/MaxX/MinY/MaxY) should be given: without them each side
+// keeps the area its current recipe paints.
+//
+// Search per side: sweep pitch, overtravel past the part edge and sweep
+// speed (fastest feasible wins). Start positions and sweep distances follow
+// from the outline, so the pattern stays centred on the part. Sweep count
+// and gun margins are fixed in the Side states; --explore-pattern varies
+// them too, but those results are advisory and are not written to --out.
+//
+// --out writes a {"command":"LOAD_RECIPE",...} message with every side's
+// settings; send it over the dashboard WebSocket to apply and save it.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "motors/Toolpath.h"
+#include "settings/motion.h"
+#include "common/Coverage.h"
+#include "common/SettingsJson.h"
+
+#define OPTIMIZER_SEARCH_CELL_INCHES 0.1f   // Coarse grid while searching; winners are re-checked at the configured cell
+#define OPTIMIZER_SPEED_STEP 0.95f          // Each speed level is 5% slower than the last
+#define OPTIMIZER_COARSE_LEVEL_STRIDE 3     // Levels skipped per step of the first scan
+#define OPTIMIZER_MIN_SPEED_FRACTION 0.05f  // Slowest speed tried, fraction of the axis default
+#define OPTIMIZER_SPEED_QUANTUM 100         // Speeds are rounded to this many steps/sec
+#define OPTIMIZER_PITCH_LEVELS 31           // Pitch from 0.5 to 3.5 sigma
+#define OPTIMIZER_PITCH_MIN_SIGMAS 0.5f
+#define OPTIMIZER_PITCH_MAX_SIGMAS 3.5f
+#define OPTIMIZER_USE_BASELINE -1.0f        // Target not given: no worse than the current recipe
+
+// Any target left at OPTIMIZER_USE_BASELINE takes the side's current value
+struct OptimizerTargets {
+    float maxCv;
+    float maxThinPercent;
+    float minThickness;     // Mean main-face thickness, flowRate units
+};
+
+// One point in the search space for a side
+struct Candidate {
+    float pitch;            // Sweep spacing across the part (inches), unused on Side 1
+    float overtravel;       // Gun-on distance past each part edge (inches)
+    int sweepCount;
+    float gunStartMargin;
+    float gunStopMargin;
+};
+
+struct CandidateResult {
+    bool feasible;
+    float seconds;
+    ToolpathSideRecipe recipe;
+};
+
+struct PartOutline {
+    float minX, maxX, minY, maxY;
+};
+
+//* ************************************************************************
+//* ***************************** EVALUATION *******************************
+//* ************************************************************************
+
+static bool findMainFace(const std::vector<CoverageSurface>& surfaces, int side, CoverageSurface const** face) {
+    for (size_t s = 0; s < surfaces.size(); s++) {
+        if (surfaces[s].side == side && surfaces[s].mainFace) {
+            *face = &surfaces[s];
+            return true;
+        }
+    }
+    return false;
+}
+
+// Compiles and simulates one side; false if it paints nothing on its main face
+static bool evaluateSide(const ToolpathRecipe& recipe, int side, const CoverageConfig& config,
+                         ToolpathSegment* segments, float& seconds, CoverageSurface& face) {
+    ToolpathSummary summary;
+    int count = compileToolpath(recipe, side, segments, TOOLPATH_MAX_SEGMENTS, summary);
+    if (summary.truncated) {
+        return false;
+    }
+    std::vector<CoverageSurface> surfaces = simulateCoverage(segments, count, recipe, config);
+    const CoverageSurface* main = nullptr;
+    if (!findMainFace(surfaces, side, &main)) {
+        return false;
+    }
+    seconds = summary.sideSeconds[side - 1];
+    face = *main;
+    return true;
+}
+
+static bool meetsTargets(const CoverageSurface& face, const OptimizerTargets& targets) {
+    return face.uniformityCv <= targets.maxCv &&
+           face.thinPercent <= targets.maxThinPercent &&
+           face.meanThickness >= targets.minThickness;
+}
+
+// Painted moves must stay inside the travel the recipe already uses or the machine allows
+static bool withinTravel(const ToolpathSegment* segments, int count, const PartOutline& envelope) {
+    for (int i = 0; i < count; i++) {
+        const ToolpathSegment& s = segments[i];
+        float xs[2] = { s.x0 / STEPS_PER_INCH_XYZ, s.x1 / STEPS_PER_INCH_XYZ };
+        float ys[2] = { s.y0 / STEPS_PER_INCH_XYZ, s.y1 / STEPS_PER_INCH_XYZ };
+        for (int k = 0; k < 2; k++) {
+            if (xs[k] < envelope.minX || xs[k] > envelope.maxX || ys[k] < envelope.minY || ys[k] > envelope.maxY) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//* ************************************************************************
+//* ****************************** GEOMETRY ********************************
+//* ************************************************************************
+// Places a candidate's sweeps on the outline. Every gun window covers the
+// part plus the overtravel, and the sweeps are centred across the part.
+
+static void applyCandidateGeometry(ToolpathSideRecipe& recipe, int side, const Candidate& c, const PartOutline& part) {
+    recipe.sweepCount = c.sweepCount;
+    recipe.gunStartMargin = c.gunStartMargin;
+    recipe.gunStopMargin = c.gunStopMargin;
+    float width = part.maxX - part.minX;
+    float height = part.maxY - part.minY;
+    float centreX = (part.minX + part.maxX) / 2.0f;
+    float centreY = (part.minY + part.maxY) / 2.0f;
+    float span = (c.sweepCount - 1) * c.pitch;
+    float margins = c.gunStartMargin + c.gunStopMargin;
+
+    switch (side) {
+        case 1: // One +X sweep along the middle of the face
+            recipe.startX = part.minX - c.overtravel - c.gunStartMargin;
+            recipe.shiftX = width + 2.0f * c.overtravel + margins;
+            recipe.startY = centreY;
+            break;
+        case 2: // -Y sweeps, shifting -X
+        case 4: // -Y sweeps, shifting +X
+            recipe.startY = part.maxY + c.overtravel + c.gunStartMargin;
+            recipe.sweepY = height + 2.0f * c.overtravel + margins;
+            recipe.shiftX = c.pitch;
+            recipe.startX = side == 2 ? centreX + span / 2.0f : centreX - span / 2.0f;
+            break;
+        case 3: // Alternating X sweeps, shifting -Y; ShiftX is the sweep length
+            //? Gun windows of the -X and +X sweeps are offset by the margin
+            //? difference; centring their average keeps both on the part
+            recipe.shiftX = width + 2.0f * c.overtravel + margins;
+            recipe.startX = centreX + recipe.shiftX / 2.0f;
+            recipe.sweepY = c.pitch;
+            recipe.startY = centreY + span / 2.0f;
+            break;
+    }
+}
+
+// The sweep speed field for a side and the axis default that caps it
+static long* sweepSpeedField(ToolpathSideRecipe& recipe, int side, long& maxSpeed) {
+    if (side == 2 || side == 4) {
+        maxSpeed = DEFAULT_Y_SPEED;
+        return &recipe.paintingYSpeed;
+    }
+    maxSpeed = DEFAULT_X_SPEED;
+    return &recipe.paintingXSpeed;
+}
+
+//* ************************************************************************
+//* ******************************* SEARCH *********************************
+//* ************************************************************************
+
+struct SideSearch {
+    int side;
+    ToolpathRecipe baseRecipe;      // Other sides are never compiled, only this one is changed
+    CoverageConfig config;          // Search resolution
+    PartOutline part;
+    PartOutline envelope;
+    OptimizerTargets targets;
+};
+
+// Fastest speed that meets the targets for this geometry. Thickness only
+// grows as the speed drops, but uniformity does not: ramp build-up at the
+// sweep ends can offset the spray falloff there. So scan every few levels
+// from the fastest, then bisect between the first pass and the level above.
+static CandidateResult searchCandidate(const SideSearch& search, const Candidate& candidate,
+                                       ToolpathSegment* segments) {
+    CandidateResult result = CandidateResult();
+    ToolpathRecipe recipe = search.baseRecipe;
+    ToolpathSideRecipe& sideRecipe = recipe.sides[search.side - 1];
+    applyCandidateGeometry(sideRecipe, search.side, candidate, search.part);
+
+    long maxSpeed;
+    long* speed = sweepSpeedField(sideRecipe, search.side, maxSpeed);
+    *speed = maxSpeed;
+    ToolpathSummary summary;
+    int count = compileToolpath(recipe, search.side, segments, TOOLPATH_MAX_SEGMENTS, summary);
+    if (!withinTravel(segments, count, search.envelope)) {
+        return result; // Speed does not change the geometry
+    }
+
+    //! Quantized speed levels, fastest first
+    std::vector<long> levels;
+    for (float level = (float)maxSpeed; level >= maxSpeed * OPTIMIZER_MIN_SPEED_FRACTION; level *= OPTIMIZER_SPEED_STEP) {
+        long quantized = std::max((long)OPTIMIZER_SPEED_QUANTUM,
+                                  lroundf(level / OPTIMIZER_SPEED_QUANTUM) * (long)OPTIMIZER_SPEED_QUANTUM);
+        if (levels.empty() || quantized != levels.back()) {
+            levels.push_back(quantized);
+        }
+    }
+
+    auto evaluateLevel = [&](size_t index, float& seconds, CoverageSurface& face) {
+        *speed = levels[index];
+        return evaluateSide(recipe, search.side, search.config, segments, seconds, face) &&
+               meetsTargets(face, search.targets);
+    };
+
+    float seconds;
+    CoverageSurface face;
+    const size_t stride = OPTIMIZER_COARSE_LEVEL_STRIDE;
+    size_t index = 0;
+    size_t previous = 0;
+    bool found = false;
+    while (index < levels.size()) {
+        if (evaluateLevel(index, seconds, face)) {
+            found = true;
+            break;
+        }
+        previous = index;
+        if (index == 0 && face.meanThickness > 0.0f && face.meanThickness < search.targets.minThickness) {
+            //? Thickness goes as 1/speed: start just above the speed that reaches the target
+            long needed = (long)(levels[0] * face.meanThickness / search.targets.minThickness);
+            while (index + 1 < levels.size() && levels[index + 1] > needed) index++;
+            previous = index;
+        }
+        if (index == levels.size() - 1) break;
+        index = std::min(index + stride, levels.size() - 1);
+    }
+    if (!found) {
+        return result;
+    }
+    float bestSeconds = seconds;
+    size_t lo = previous + 1;
+    size_t hi = index;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (evaluateLevel(mid, seconds, face)) {
+            hi = mid;
+            bestSeconds = seconds;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    *speed = levels[hi];
+    result.feasible = true;
+    result.seconds = bestSeconds;
+    result.recipe = sideRecipe;
+    return result;
+}
+
+static std::vector<Candidate> buildCandidates(int side, float sigma, bool explorePattern) {
+    std::vector<Candidate> candidates;
+    const float overtravels[] = { 0.0f, 0.25f, 0.5f, 1.0f };  // x sigma
+    std::vector<int> sweepCounts;
+    std::vector<std::pair<float, float> > margins;
+    if (explorePattern && side != 1) {
+        for (int n = 3; n <= 8; n++) sweepCounts.push_back(n);
+    } else {
+        ToolpathSideRecipe firmware = ToolpathSideRecipe();
+        applyFirmwarePatternShape(firmware, side);
+        sweepCounts.push_back(firmware.sweepCount);
+    }
+    ToolpathSideRecipe firmware = ToolpathSideRecipe();
+    applyFirmwarePatternShape(firmware, side);
+    margins.push_back(std::make_pair(firmware.gunStartMargin, firmware.gunStopMargin));
+    if (explorePattern) {
+        margins.push_back(std::make_pair(0.25f, 0.25f));
+        margins.push_back(std::make_pair(0.5f, 0.5f));
+    }
+
+    int pitchLevels = side == 1 ? 1 : OPTIMIZER_PITCH_LEVELS;
+    for (size_t n = 0; n < sweepCounts.size(); n++) {
+        for (size_t m = 0; m < margins.size(); m++) {
+            for (int p = 0; p < pitchLevels; p++) {
+                for (float overtravel : overtravels) {
+                    Candidate c;
+                    c.pitch = side == 1 ? 0.0f
+                            : sigma * (OPTIMIZER_PITCH_MIN_SIGMAS
+                                       + (OPTIMIZER_PITCH_MAX_SIGMAS - OPTIMIZER_PITCH_MIN_SIGMAS) * p / (OPTIMIZER_PITCH_LEVELS - 1));
+                    c.overtravel = overtravel * sigma;
+                    c.sweepCount = side == 1 ? 1 : sweepCounts[n];
+                    c.gunStartMargin = margins[m].first;
+                    c.gunStopMargin = margins[m].second;
+                    candidates.push_back(c);
+                }
+            }
+        }
+    }
+    return candidates;
+}
+
+static std::vector<CandidateResult> runSearch(const SideSearch& search, const std::vector<Candidate>& candidates,
+                                              int threadCount) {
+    std::vector<CandidateResult> results(candidates.size());
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        std::vector<ToolpathSegment> segments(TOOLPATH_MAX_SEGMENTS);
+        for (size_t i = next++; i < candidates.size(); i = next++) {
+            results[i] = searchCandidate(search, candidates[i], segments.data());
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back(worker);
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    return results;
+}
+
+//* ************************************************************************
+//* ******************************** OUTPUT ********************************
+//* ************************************************************************
+
+static void printSideRow(const char* label, float seconds, const ToolpathSideRecipe& r, int side,
+                         const CoverageSurface& face) {
+    long speed = (side == 2 || side == 4) ? r.paintingYSpeed : r.paintingXSpeed;
+    printf("  %-9s %6.2f s  start (%6.2f,%6.2f)  sweepY %6.2f  shiftX %6.2f  speed %6ld  sweeps %d  gun %.2f/%.2f"
+           "  CV %.3f  thin %5.1f%%  mean %.4f  overspray %5.1f%%\n",
+           label, seconds, r.startX, r.startY, r.sweepY, r.shiftX, speed, r.sweepCount,
+           r.gunStartMargin, r.gunStopMargin, face.uniformityCv, face.thinPercent, face.meanThickness,
+           face.oversprayPercent);
+}
+
+static bool writeRecipeJson(const char* path, const ToolpathRecipe& recipe) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    fprintf(file, "{\n  \"command\": \"LOAD_RECIPE\"");
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        const ToolpathSideRecipe& s = recipe.sides[i];
+        int n = i + 1;
+        fprintf(file, ",\n  \"side%dStartX\": %.2f, \"side%dStartY\": %.2f", n, s.startX, n, s.startY);
+        fprintf(file, ", \"side%dZHeight\": %.2f, \"side%dSideZHeight\": %.2f", n, s.zHeight, n, s.sideZHeight);
+        fprintf(file, ",\n  \"side%dSweepY\": %.2f, \"side%dShiftX\": %.2f", n, s.sweepY, n, s.shiftX);
+        fprintf(file, ", \"side%dPaintingXSpeed\": %ld, \"side%dPaintingYSpeed\": %ld",
+                n, s.paintingXSpeed, n, s.paintingYSpeed);
+    }
+    fprintf(file, "\n}\n");
+    fclose(file);
+    return true;
+}
+
+static void applyCoverageJson(const std::string& json, CoverageConfig& config) {
+    readJsonFloat(json, "sprayHalfAngleDeg", config.sprayHalfAngleDeg);
+    readJsonFloat(json, "standoffInches", config.standoffInches);
+    readJsonFloat(json, "flowRate", config.flowRate);
+    readJsonFloat(json, "cellInches", config.cellInches);
+    readJsonFloat(json, "thinFraction", config.thinFraction);
+    for (int i = 0; i < TOOLPATH_SIDE_COUNT; i++) {
+        std::string prefix = "side" + std::to_string(i + 1);
+        double value;
+        if (findJsonNumber(json, prefix + "PartMinX", value)) {
+            config.hasPartOutline[i] = true;
+            config.partMinX[i] = (float)value;
+            readJsonFloat(json, prefix + "PartMaxX", config.partMaxX[i]);
+            readJsonFloat(json, prefix + "PartMinY", config.partMinY[i]);
+            readJsonFloat(json, prefix + "PartMaxY", config.partMaxY[i]);
+        }
+    }
+}
+
+static int usage(const char* program) {
+    fprintf(stderr, "Usage: %s [settings.json] [--side 1-4] [--max-cv C] [--max-thin P] [--min-thickness T]\n"
+                    "       [--threads N] [--explore-pattern] [--out recipe.json]\n", program);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    const char* settingsPath = nullptr;
+    const char* outPath = nullptr;
+    int onlySide = TOOLPATH_ALL_SIDES;
+    bool explorePattern = false;
+    int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+    OptimizerTargets targets = { OPTIMIZER_USE_BASELINE, OPTIMIZER_USE_BASELINE, OPTIMIZER_USE_BASELINE };
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--side") == 0 && hasValue) {
+            onlySide = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-cv") == 0 && hasValue) {
+            targets.maxCv = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--max-thin") == 0 && hasValue) {
+            targets.maxThinPercent = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--min-thickness") == 0 && hasValue) {
+            targets.minThickness = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threadCount = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--explore-pattern") == 0) {
+            explorePattern = true;
+        } else if (argv[i][0] != '-') {
+            settingsPath = argv[i];
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (onlySide < TOOLPATH_ALL_SIDES || onlySide > TOOLPATH_SIDE_COUNT) {
+        return usage(argv[0]);
+    }
+
+    ToolpathRecipe recipe;
+    CoverageConfig config;
+    getDefaultToolpathRecipe(recipe);
+    getDefaultCoverageConfig(config);
+    if (settingsPath) {
+        std::string json;
+        if (!readTextFile(settingsPath, json)) {
+            fprintf(stderr, "Cannot read %s\n", settingsPath);
+            return 1;
+        }
+        applyRecipeJson(json, recipe);
+        applyCoverageJson(json, config);
+    }
+    config.coats = 1;
+    const float sigma = coverageSigmaInches(config);
+    auto started = std::chrono::steady_clock::now();
+
+    printf("Spray sigma %.3f in, cell %.3f in (search %.3f in), %d thread(s)%s\n", sigma, config.cellInches,
+           std::max(config.cellInches, OPTIMIZER_SEARCH_CELL_INCHES), threadCount,
+           explorePattern ? ", exploring sweep count and gun margins" : "");
+
+    std::vector<ToolpathSegment> segments(TOOLPATH_MAX_SEGMENTS);
+
+    ToolpathRecipe optimized = recipe;
+    bool loadable = true;
+    float totalBefore = 0.0f, totalAfter = 0.0f;
+    for (int side = 1; side <= TOOLPATH_SIDE_COUNT; side++) {
+        if (onlySide != TOOLPATH_ALL_SIDES && side != onlySide) continue;
+        //! Baseline at full resolution: the outline, and any target not given
+        float baselineSeconds;
+        CoverageSurface baseline;
+        if (!evaluateSide(recipe, side, config, segments.data(), baselineSeconds, baseline)) {
+            printf("Side %d: recipe paints nothing on its main face, skipped\n", side);
+            continue;
+        }
+        OptimizerTargets sideTargets = targets;
+        if (sideTargets.maxCv < 0.0f) sideTargets.maxCv = baseline.uniformityCv;
+        if (sideTargets.maxThinPercent < 0.0f) sideTargets.maxThinPercent = baseline.thinPercent;
+        if (sideTargets.minThickness < 0.0f) sideTargets.minThickness = baseline.meanThickness;
+        printf("Side %d: part X %.2f-%.2f, Y %.2f-%.2f%s\n", side, baseline.partMinX, baseline.partMaxX,
+               baseline.partMinY, baseline.partMaxY,
+               config.hasPartOutline[side - 1] ? "" : " (no outline given, using the area the recipe paints)");
+        printf("  targets: CV <= %.3f, thin <= %.1f%%, mean >= %.4f\n",
+               sideTargets.maxCv, sideTargets.maxThinPercent, sideTargets.minThickness);
+
+        SideSearch search;
+        search.side = side;
+        search.baseRecipe = recipe;
+        search.config = config;
+        search.config.cellInches = std::max(config.cellInches, OPTIMIZER_SEARCH_CELL_INCHES);
+        search.part = { baseline.partMinX, baseline.partMaxX, baseline.partMinY, baseline.partMaxY };
+        search.config.hasPartOutline[side - 1] = true;
+        search.config.partMinX[side - 1] = search.part.minX;
+        search.config.partMaxX[side - 1] = search.part.maxX;
+        search.config.partMinY[side - 1] = search.part.minY;
+        search.config.partMaxY[side - 1] = search.part.maxY;
+        search.targets = sideTargets;
+
+        // Allow the machine envelope, extended to wherever the current recipe already goes
+        ToolpathSummary summary;
+        int count = compileToolpath(recipe, side, segments.data(), TOOLPATH_MAX_SEGMENTS, summary);
+        search.envelope = { 0.0f, X_MAX_TRAVEL_POS_INCH, 0.0f, Y_MAX_TRAVEL_POS_INCH };
+        for (int i = 0; i < count; i++) {
+            search.envelope.minX = std::min(search.envelope.minX, std::min(segments[i].x0, segments[i].x1) / STEPS_PER_INCH_XYZ);
+            search.envelope.minY = std::min(search.envelope.minY, std::min(segments[i].y0, segments[i].y1) / STEPS_PER_INCH_XYZ);
+        }
+
+        std::vector<Candidate> candidates = buildCandidates(side, sigma, explorePattern);
+        std::vector<CandidateResult> results = runSearch(search, candidates, threadCount);
+
+        //! Re-check the fastest results at full resolution until one holds up
+        std::vector<size_t> order;
+        for (size_t i = 0; i < results.size(); i++) {
+            if (results[i].feasible) order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].seconds < results[b].seconds; });
+
+        CoverageConfig verifyConfig = search.config;
+        verifyConfig.cellInches = config.cellInches;
+        //? The current recipe is the incumbent when it meets the targets itself
+        bool baselineFeasible = meetsTargets(baseline, sideTargets);
+        bool found = false;
+        for (size_t k = 0; k < order.size() && !found; k++) {
+            if (baselineFeasible && results[order[k]].seconds >= baselineSeconds) {
+                break;
+            }
+            ToolpathRecipe trial = recipe;
+            trial.sides[side - 1] = results[order[k]].recipe;
+            float seconds;
+            CoverageSurface face;
+            if (evaluateSide(trial, side, verifyConfig, segments.data(), seconds, face) && meetsTargets(face, sideTargets)) {
+                found = true;
+                printSideRow("baseline", baselineSeconds, recipe.sides[side - 1], side, baseline);
+                printSideRow("optimized", seconds, trial.sides[side - 1], side, face);
+                printf("  %zu of %zu geometries feasible\n", order.size(), candidates.size());
+                optimized.sides[side - 1] = trial.sides[side - 1];
+                totalBefore += baselineSeconds;
+                totalAfter += seconds;
+                if (!isFirmwarePatternShape(trial.sides[side - 1], side)) {
+                    loadable = false;
+                }
+            }
+        }
+        if (!found) {
+            totalBefore += baselineSeconds;
+            totalAfter += baselineSeconds;
+        }
+        if (!found && baselineFeasible) {
+            printf("  current recipe is already the fastest that meets the targets (%zu geometries tried)\n",
+                   candidates.size());
+        } else if (!found) {
+            printf("  no recipe meets the targets with this outline (%zu geometries tried), keeping the baseline\n",
+                   candidates.size());
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    printf("Side cycle time: %.1f s -> %.1f s, searched in %.1f s\n", totalBefore, totalAfter, elapsed);
+
+    if (outPath) {
+        if (!loadable) {
+            fprintf(stderr, "Not writing %s: the result changes the sweep count or gun margins, which the firmware "
+                            "does not take as settings\n", outPath);
+            return 1;
+        }
+        if (!writeRecipeJson(outPath, optimized)) {
+            fprintf(stderr, "Cannot write %s\n", outPath);
+            return 1;
+        }
+        printf("Wrote %s (send it to the dashboard WebSocket to load)\n", outPath);
+    }
+    return 0;
+}
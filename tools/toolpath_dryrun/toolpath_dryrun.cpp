@@ -0,0 +1,88 @@
+//* ************************************************************************
+//* ************************ TOOLPATH DRY RUN (HOST) ***********************
+//* ************************************************************************
+// Compiles a painting recipe on a PC with the same code the firmware uses
+// for the dashboard dry run (src/Motors/Toolpath.cpp). Not part of the
+// PlatformIO build. Build from the repository root:
+//
+//   g++ -std=c++17 -O2 -Iinclude -Itools tools/toolpath_dryrun/toolpath_dryrun.cpp src/Motors/Toolpath.cpp -o toolpath_dryrun
+//
+// Usage:
+//   toolpath_dryrun [settings.json] [--side 1-4] [--polyline]
+//
+// settings.json is a flat object using the dashboard SETTING: names (see
+// tools/common/SettingsJson.h). Missing keys keep the painting.h defaults.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "motors/Toolpath.h"
+#include "settings/motion.h"
+#include "common/SettingsJson.h"
+
+int main(int argc, char** argv) {
+    const char* settingsPath = nullptr;
+    int side = TOOLPATH_ALL_SIDES;
+    bool printPolyline = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--side") == 0 && i + 1 < argc) {
+            side = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--polyline") == 0) {
+            printPolyline = true;
+        } else if (argv[i][0] != '-') {
+            settingsPath = argv[i];
+        } else {
+            fprintf(stderr, "Usage: %s [settings.json] [--side 1-4] [--polyline]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (side < TOOLPATH_ALL_SIDES || side > TOOLPATH_SIDE_COUNT) {
+        fprintf(stderr, "Side must be 1-4 (omit for all sides)\n");
+        return 2;
+    }
+
+    ToolpathRecipe recipe;
+    getDefaultToolpathRecipe(recipe);
+    if (settingsPath) {
+        std::string json;
+        if (!readTextFile(settingsPath, json)) {
+            fprintf(stderr, "Cannot read %s\n", settingsPath);
+            return 1;
+        }
+        applyRecipeJson(json, recipe);
+    }
+
+    static ToolpathSegment segments[TOOLPATH_MAX_SEGMENTS];
+    ToolpathSummary summary;
+    int count = compileToolpath(recipe, side, segments, TOOLPATH_MAX_SEGMENTS, summary);
+
+    static const char* const typeNames[] = { "TRAVEL", "PAINT", "ROTATE" };
+    for (int i = 0; i < count; i++) {
+        const ToolpathSegment& s = segments[i];
+        printf("%2d S%d %-6s (%6.2f,%6.2f,%5.2f) -> (%6.2f,%6.2f,%5.2f) %6.2fs", i, s.side, typeNames[s.type],
+               s.x0 / STEPS_PER_INCH_XYZ, s.y0 / STEPS_PER_INCH_XYZ, s.z0 / STEPS_PER_INCH_XYZ,
+               s.x1 / STEPS_PER_INCH_XYZ, s.y1 / STEPS_PER_INCH_XYZ, s.z1 / STEPS_PER_INCH_XYZ, s.seconds);
+        if (s.type == TOOLPATH_PAINT) {
+            printf("  gun %.2f-%.2f in @ %ld Hz", s.gunOnOffset / STEPS_PER_INCH_XYZ,
+                   s.gunOffOffset / STEPS_PER_INCH_XYZ, s.speedHz);
+        } else if (s.type == TOOLPATH_ROTATE) {
+            printf("  %.0f -> %.0f deg", s.angle0, s.angle1);
+        }
+        printf("\n");
+    }
+
+    char buffer[TOOLPATH_POLYLINE_BUFFER_SIZE];
+    formatToolpathSummary(summary, buffer, sizeof(buffer));
+    printf("SUMMARY %s\n", buffer);
+
+    if (printPolyline) {
+        if (formatToolpathPolyline(segments, count, buffer, sizeof(buffer)) < 0) {
+            fprintf(stderr, "Polyline does not fit in %d bytes\n", TOOLPATH_POLYLINE_BUFFER_SIZE);
+            return 1;
+        }
+        printf("TOOLPATH:%s\n", buffer);
+    }
+    return summary.truncated ? 1 : 0;
+}